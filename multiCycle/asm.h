@@ -0,0 +1,37 @@
+#ifndef ASM_H
+#define ASM_H
+
+#include <stddef.h>
+#include "cpu.h"
+
+/**
+ * 어셈블러 (.s / .asm)
+ * 텍스트 프로그램 형식을 그대로 받으면서 레이블, 상수, 데이터 지시어를 추가한 형식
+ *
+ *   loop:  MOV_MR R2, counter     # 레이블, 레지스터 이름(R0~R7), 기호 사용 가능
+ *          ADD_RR 2 1             # 쉼표는 생략 가능, 숫자는 10진/0x16진
+ *          JMP loop
+ *   counter: .byte 0, 1, 2        # 데이터
+ *   R0 5                          # 레지스터 초기값 (기존 형식)
+ *
+ * 지시어: .org addr / .byte v, ... / .zero n / .equ name, value / .entry addr
+ * 값 자리에는 숫자, 기호, 기호+숫자 같은 덧셈/뺄셈 식을 쓸 수 있음
+ * MOV_RF/MOV_FR의 주소 오퍼랜드는 32비트 (4바이트로 출력), 나머지 오퍼랜드는 1바이트
+ * 1패스에서 주소를 정하고 기호를 모은 뒤 2패스에서 값을 계산해 바이트를 씀
+ * 오류는 "파일:줄: error: ..." 형식으로 모두 출력하고, 하나라도 있으면 VM을 바꾸지 않음
+ */
+
+// 니모닉 -> Opcode (길이로 먼저 나눈 뒤 비교, 없으면 INVALID)
+Opcode lookupMnemonic(const char *name, size_t len);
+
+// 확장자가 .s 또는 .asm이면 true
+bool isAssemblySource(const char *filename);
+
+/**
+ * 파일을 어셈블해서 VM의 memory/regs/PC를 채움
+ * verbose가 false면 아무것도 출력하지 않음 (여러 스레드에서 동시에 호출 가능)
+ * lines가 NULL이 아니면 명령어 시작 주소마다 소스 줄 번호 (MEMORY_SIZE개, 0 = 명령어 없음)
+ */
+bool assembleFile(VM *vm, const char *filename, bool verbose, uint32_t *lines);
+
+#endif
@@ -0,0 +1,3 @@
+# 벤치마크 커널: 가장 짧은 루프 (JMP 하나, 디스패치 비용만)
+# HALT 없음, -n 으로 클록 수 제한
+loop:   JMP loop
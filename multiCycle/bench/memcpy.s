@@ -0,0 +1,22 @@
+# 벤치마크 커널: 메모리 복사 (src 8바이트를 dst로, MOV_MR/MOV_RM 한 쌍씩 풀어 씀)
+# HALT 없음, -n 으로 클록 수 제한
+loop:   MOV_MR R0, src
+        MOV_RM dst, R0
+        MOV_MR R1, src+1
+        MOV_RM dst+1, R1
+        MOV_MR R2, src+2
+        MOV_RM dst+2, R2
+        MOV_MR R3, src+3
+        MOV_RM dst+3, R3
+        MOV_MR R4, src+4
+        MOV_RM dst+4, R4
+        MOV_MR R5, src+5
+        MOV_RM dst+5, R5
+        MOV_MR R6, src+6
+        MOV_RM dst+6, R6
+        MOV_MR R7, src+7
+        MOV_RM dst+7, R7
+        JMP loop
+
+src:    .byte 1, 2, 3, 4, 5, 6, 7, 8
+dst:    .zero 8
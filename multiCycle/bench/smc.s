@@ -0,0 +1,14 @@
+# 벤치마크 커널: 자기 수정 코드
+# 루프마다 op(ADD_RR R0, R?)의 소스 레지스터 바이트를 1과 2로 번갈아 덮어씀
+# (pipeline은 이미 fetch한 op에 쓰면 비우고 다시 fetch)
+# HALT 없음, -n 으로 클록 수 제한
+        R1 1
+        R2 2
+        R3 1
+        R6 3
+loop:   MOV_RM op+2, R3
+op:     ADD_RR R0, R1
+        MOV_RR R5, R6      # R3 = 3 - R3
+        SUB_RR R5, R3
+        MOV_RR R3, R5
+        JMP loop
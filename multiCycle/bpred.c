@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <string.h>
+#include "bpred.h"
+
+/**
+ * 분기 예측기
+ * 이 ISA의 분기는 무조건 JMP뿐이라 방향은 항상 taken이지만,
+ * IF 시점에는 PC만 알기 때문에 BTB가 "여기는 JMP이고 대상은 X"를 기억해야 한다.
+ * 방향 예측기(bimodal/gshare/TAGE)는 BTB에 있는 PC를 실제로 taken으로 볼지 결정하고,
+ * 자기 수정 코드로 JMP가 사라지면 not-taken으로 학습한다.
+ */
+
+static const char *const predictorNames[BP_KINDS] = {
+    [BP_NONE] = "none",
+    [BP_STATIC] = "static",
+    [BP_BTB] = "btb",
+    [BP_BIMODAL] = "bimodal",
+    [BP_GSHARE] = "gshare",
+    [BP_TAGE] = "tage",
+};
+
+// TAGE 테이블별 히스토리 길이 (기하급수)
+static const int tageHistoryLength[TAGE_TABLES] = {4, 8, 16};
+
+const char *predictorName(PredictorKind kind)
+{
+    return (kind < BP_KINDS) ? predictorNames[kind] : "?";
+}
+
+bool parsePredictor(const char *name, PredictorKind *out)
+{
+    for (int i = 0; i < BP_KINDS; i++)
+    {
+        if (strcmp(name, predictorNames[i]) == 0)
+        {
+            *out = (PredictorKind)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void initPredictor(BranchPredictor *bp, PredictorKind kind)
+{
+    memset(bp, 0, sizeof(*bp));
+    bp->kind = kind;
+    // 약한 not-taken에서 시작
+    memset(bp->counters, 1, sizeof(bp->counters));
+}
+
+static BtbEntry *btbLookup(const BranchPredictor *bp, uint16_t pc)
+{
+    const BtbEntry *set = bp->btb[pc % BTB_SETS];
+    for (int way = 0; way < BTB_WAYS; way++)
+    {
+        if (set[way].valid && set[way].tag == pc / BTB_SETS)
+        {
+            return (BtbEntry *)&set[way];
+        }
+    }
+    return NULL;
+}
+
+// way를 가장 최근 사용으로
+static void btbTouch(BranchPredictor *bp, uint16_t pc, BtbEntry *hit)
+{
+    BtbEntry *set = bp->btb[pc % BTB_SETS];
+    for (int way = 0; way < BTB_WAYS; way++)
+    {
+        if (set[way].age < hit->age)
+        {
+            set[way].age++;
+        }
+    }
+    hit->age = 0;
+}
+
+static void btbInsert(BranchPredictor *bp, uint16_t pc, uint16_t target)
+{
+    BtbEntry *set = bp->btb[pc % BTB_SETS];
+    BtbEntry *victim = &set[0];
+    for (int way = 0; way < BTB_WAYS; way++)
+    {
+        if (!set[way].valid)
+        {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].age > victim->age)
+        {
+            victim = &set[way];
+        }
+    }
+    victim->valid = true;
+    victim->tag = pc / BTB_SETS;
+    victim->target = target;
+    victim->age = BTB_WAYS; // btbTouch에서 0이 되고 나머지는 하나씩 밀림
+    btbTouch(bp, pc, victim);
+}
+
+// 히스토리 length비트를 8비트로 접음
+static uint8_t foldHistory(uint16_t history, int length)
+{
+    uint16_t h = history & ((1u << length) - 1);
+    uint8_t folded = 0;
+    while (h)
+    {
+        folded ^= (uint8_t)h;
+        h >>= 8;
+    }
+    return folded;
+}
+
+static unsigned tageIndex(uint16_t pc, uint16_t history, int table)
+{
+    return (pc ^ (pc >> 8) ^ foldHistory(history, tageHistoryLength[table])) % TAGE_SIZE;
+}
+
+static uint8_t tageTag(uint16_t pc, uint16_t history, int table)
+{
+    return (uint8_t)((pc * 7) ^ (foldHistory(history, tageHistoryLength[table]) << 1) ^ table);
+}
+
+static unsigned gshareIndex(uint16_t pc, uint16_t history)
+{
+    return (pc ^ (history & ((1u << GSHARE_HIST_BITS) - 1))) % BIMODAL_SIZE;
+}
+
+Prediction predictBranch(const BranchPredictor *bp, uint16_t pc)
+{
+    Prediction pred = {.provider = -1};
+    const BtbEntry *e = btbLookup(bp, pc);
+    if (!e)
+    {
+        return pred;
+    }
+    pred.btbHit = true;
+    pred.target = e->target;
+
+    switch (bp->kind)
+    {
+    case BP_BTB:
+        pred.taken = true;
+        break;
+    case BP_BIMODAL:
+        pred.taken = bp->counters[pc % BIMODAL_SIZE] >= 2;
+        break;
+    case BP_GSHARE:
+        pred.taken = bp->counters[gshareIndex(pc, bp->history)] >= 2;
+        break;
+    case BP_TAGE:
+    {
+        // 가장 긴 히스토리에서 태그가 맞는 테이블이 예측, 그다음 것이 대안
+        bool base = bp->counters[pc % BIMODAL_SIZE] >= 2;
+        pred.taken = pred.altTaken = base;
+        for (int t = 0; t < TAGE_TABLES; t++)
+        {
+            const TageEntry *te = &bp->tage[t][tageIndex(pc, bp->history, t)];
+            if (te->tag == tageTag(pc, bp->history, t))
+            {
+                pred.altTaken = pred.taken;
+                pred.taken = te->ctr >= 4;
+                pred.provider = (int8_t)t;
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return pred;
+}
+
+// 포화 카운터
+static void train(uint8_t *ctr, bool taken, uint8_t max)
+{
+    if (taken && *ctr < max)
+        (*ctr)++;
+    else if (!taken && *ctr > 0)
+        (*ctr)--;
+}
+
+static void updateTage(BranchPredictor *bp, uint16_t pc, bool taken, const Prediction *pred)
+{
+    if (pred->provider < 0)
+    {
+        train(&bp->counters[pc % BIMODAL_SIZE], taken, 3);
+    }
+    else
+    {
+        TageEntry *te = &bp->tage[pred->provider][tageIndex(pc, bp->history, pred->provider)];
+        train(&te->ctr, taken, 7);
+        if (pred->taken != pred->altTaken)
+        {
+            train(&te->useful, pred->taken == taken, 3);
+        }
+    }
+
+    // 틀렸으면 더 긴 히스토리 테이블에 새 항목 할당 (useful이 0인 곳)
+    if (pred->taken != taken)
+    {
+        bool allocated = false;
+        for (int t = pred->provider + 1; t < TAGE_TABLES; t++)
+        {
+            TageEntry *te = &bp->tage[t][tageIndex(pc, bp->history, t)];
+            if (te->useful == 0)
+            {
+                te->tag = tageTag(pc, bp->history, t);
+                te->ctr = taken ? 4 : 3;
+                allocated = true;
+                break;
+            }
+        }
+        if (!allocated)
+        {
+            for (int t = pred->provider + 1; t < TAGE_TABLES; t++)
+            {
+                train(&bp->tage[t][tageIndex(pc, bp->history, t)].useful, false, 3);
+            }
+        }
+    }
+}
+
+void updatePredictor(BranchPredictor *bp, uint16_t pc, bool isBranch, uint16_t target, const Prediction *pred)
+{
+    if (bp->kind < BP_BTB)
+    {
+        return;
+    }
+
+    // BTB: JMP면 대상 기록, JMP가 아닌데 있으면 제거
+    BtbEntry *e = btbLookup(bp, pc);
+    if (isBranch)
+    {
+        if (e)
+        {
+            e->target = target;
+            btbTouch(bp, pc, e);
+        }
+        else
+        {
+            btbInsert(bp, pc, target);
+        }
+    }
+    else if (e)
+    {
+        e->valid = false;
+    }
+
+    // 방향 예측기는 BTB에 있던 PC(IF에서 분기로 본 곳)와 JMP만 학습
+    if (!isBranch && !pred->btbHit)
+    {
+        return;
+    }
+    switch (bp->kind)
+    {
+    case BP_BIMODAL:
+        train(&bp->counters[pc % BIMODAL_SIZE], isBranch, 3);
+        break;
+    case BP_GSHARE:
+        train(&bp->counters[gshareIndex(pc, bp->history)], isBranch, 3);
+        break;
+    case BP_TAGE:
+        updateTage(bp, pc, isBranch, pred);
+        break;
+    default:
+        break;
+    }
+    bp->history = (uint16_t)((bp->history << 1) | isBranch);
+}
+
+void printPredictorStats(PredictorKind kind, const PredictorStats *stats)
+{
+    printf("----- Branch Predictor (%s) -----\n", predictorName(kind));
+    printf("lookups         = %llu (BTB hits %llu)\n", (unsigned long long)stats->lookups,
+           (unsigned long long)stats->btbHits);
+    printf("JMPs            = %llu\n", (unsigned long long)stats->branches);
+    printf("correct         = %llu (%.1f%%)\n", (unsigned long long)stats->correct,
+           stats->branches ? 100.0 * stats->correct / stats->branches : 0.0);
+    printf("BTB misses      = %llu\n", (unsigned long long)stats->btbMisses);
+    printf("direction miss  = %llu\n", (unsigned long long)stats->directionMisses);
+    printf("wrong target    = %llu\n", (unsigned long long)stats->wrongTargets);
+    printf("false hits      = %llu\n", (unsigned long long)stats->falseHits);
+    printf("penalty cycles  = %llu\n", (unsigned long long)stats->penaltyCycles);
+}
@@ -0,0 +1,85 @@
+#ifndef BPRED_H
+#define BPRED_H
+
+#include "cpu.h"
+
+// 분기 예측기 종류 (-b 옵션으로 선택)
+typedef enum {
+    BP_NONE,    // 예측 없음: JMP는 EX에서 처리 (2클록 손해)
+    BP_STATIC,  // ID에서 JMP를 해석해서 바로 대상으로 (1클록 손해)
+    BP_BTB,     // BTB에 있으면 IF에서 대상으로 (맞으면 손해 없음)
+    BP_BIMODAL, // BTB + PC별 2비트 카운터
+    BP_GSHARE,  // BTB + (PC ^ 전역 히스토리) 2비트 카운터
+    BP_TAGE,    // BTB + TAGE-lite (기본 카운터 + 히스토리 길이가 다른 태그 테이블 3개)
+    BP_KINDS
+} PredictorKind;
+
+#define BTB_SETS 16
+#define BTB_WAYS 4
+#define BIMODAL_SIZE 1024
+#define GSHARE_HIST_BITS 10
+#define TAGE_TABLES 3
+#define TAGE_SIZE 256
+
+typedef struct {
+    bool valid;
+    uint16_t tag;
+    uint16_t target;
+    uint8_t age; // 작을수록 최근 사용 (LRU)
+} BtbEntry;
+
+typedef struct {
+    uint8_t tag;
+    uint8_t ctr;    // 0~7, 4 이상이면 taken
+    uint8_t useful; // 0~3
+} TageEntry;
+
+// IF에서의 예측 결과
+typedef struct {
+    bool btbHit;
+    bool taken;
+    uint16_t target;
+    // TAGE 갱신용 (어느 테이블이 예측했는지)
+    int8_t provider; // -1 = 기본 카운터
+    bool altTaken;
+} Prediction;
+
+// 예측 통계
+typedef struct {
+    uint64_t lookups;       // IF에서 조회한 횟수
+    uint64_t btbHits;
+    uint64_t branches;      // ID에서 확인한 JMP 수
+    uint64_t correct;       // 대상까지 맞힌 JMP
+    uint64_t btbMisses;     // BTB에 없던 JMP
+    uint64_t directionMisses; // BTB에는 있었지만 not-taken으로 예측한 JMP
+    uint64_t wrongTargets;  // 대상이 틀린 JMP (자기 수정 코드)
+    uint64_t falseHits;     // JMP가 아닌데 taken으로 예측 (자기 수정 코드, 명령어 중간으로 점프)
+    uint64_t penaltyCycles; // 예측 실패로 버린 클록
+} PredictorStats;
+
+typedef struct {
+    PredictorKind kind;
+    BtbEntry btb[BTB_SETS][BTB_WAYS];
+    uint8_t counters[BIMODAL_SIZE]; // bimodal/gshare/TAGE 기본 예측기 (0~3)
+    uint16_t history;               // 전역 히스토리 (최근 분기 결과, 1 = taken)
+    TageEntry tage[TAGE_TABLES][TAGE_SIZE];
+} BranchPredictor;
+
+// 이름 ("none", "static", "btb", "bimodal", "gshare", "tage")
+const char *predictorName(PredictorKind kind);
+bool parsePredictor(const char *name, PredictorKind *out);
+
+void initPredictor(BranchPredictor *bp, PredictorKind kind);
+
+// IF 단계: pc에서 분기할지, 어디로 갈지 예측 (BP_BTB 이상에서만 의미 있음)
+Prediction predictBranch(const BranchPredictor *bp, uint16_t pc);
+
+/**
+ * ID 단계에서 명령어를 해석한 뒤 호출
+ * isBranch = JMP인지, target = JMP 대상, pred = IF에서 했던 예측
+ */
+void updatePredictor(BranchPredictor *bp, uint16_t pc, bool isBranch, uint16_t target, const Prediction *pred);
+
+void printPredictorStats(PredictorKind kind, const PredictorStats *stats);
+
+#endif
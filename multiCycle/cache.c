@@ -0,0 +1,447 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+
+/**
+ * 캐시 계층 모델
+ * 태그와 상태만 기록하고 실제 데이터는 vm->memory에서 바로 읽고 쓴다.
+ * (그래서 자기 수정 코드가 있어도 I/D 캐시 일관성 문제는 생기지 않고, 클록 수만 달라진다)
+ * 쓰기 버퍼가 있다고 보고 write-through 쓰기와 dirty 라인 내보내기는 기다리지 않음
+ * (다음 단계 캐시의 상태와 통계에는 반영)
+ */
+
+void initMemConfig(MemConfig *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->l1d = (CacheConfig){.size = 64, .ways = 2, .lineSize = 8, .repl = REPL_LRU, .writeBack = true, .hitLatency = 1};
+    cfg->l1i = cfg->l1d;
+    cfg->l2 = (CacheConfig){.size = 256, .ways = 4, .lineSize = 16, .repl = REPL_LRU, .writeBack = true, .hitLatency = 6};
+    cfg->memLatency = 30;
+}
+
+static bool parseNumber(const char *s, uint16_t *out)
+{
+    char *end;
+    unsigned long v = strtoul(s, &end, 0);
+    if (*s == '\0' || *end != '\0' || v > 0xFFFF)
+    {
+        return false;
+    }
+    *out = (uint16_t)v;
+    return true;
+}
+
+static bool parseCacheKey(CacheConfig *c, const char *key, const char *value)
+{
+    if (strcmp(key, "size") == 0)
+        return parseNumber(value, &c->size);
+    if (strcmp(key, "ways") == 0)
+        return parseNumber(value, &c->ways);
+    if (strcmp(key, "line") == 0)
+        return parseNumber(value, &c->lineSize);
+    if (strcmp(key, "lat") == 0)
+        return parseNumber(value, &c->hitLatency);
+    if (strcmp(key, "repl") == 0)
+    {
+        if (strcmp(value, "lru") == 0)
+            c->repl = REPL_LRU;
+        else if (strcmp(value, "plru") == 0)
+            c->repl = REPL_PLRU;
+        else if (strcmp(value, "random") == 0)
+            c->repl = REPL_RANDOM;
+        else
+            return false;
+        return true;
+    }
+    if (strcmp(key, "write") == 0)
+    {
+        if (strcmp(value, "wb") == 0)
+            c->writeBack = true;
+        else if (strcmp(value, "wt") == 0)
+            c->writeBack = false;
+        else
+            return false;
+        return true;
+    }
+    return false;
+}
+
+bool parseCacheOption(MemConfig *cfg, const char *spec)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    char *params = strchr(buf, ':');
+    if (params)
+    {
+        *params++ = '\0';
+    }
+
+    CacheConfig *target = NULL;
+    if (strcmp(buf, "l1") == 0)
+    {
+        cfg->split = false;
+        target = &cfg->l1d;
+    }
+    else if (strcmp(buf, "l1i") == 0)
+    {
+        cfg->split = true;
+        target = &cfg->l1i;
+    }
+    else if (strcmp(buf, "l1d") == 0)
+    {
+        cfg->split = true;
+        target = &cfg->l1d;
+    }
+    else if (strcmp(buf, "l2") == 0)
+    {
+        cfg->hasL2 = true;
+        target = &cfg->l2;
+    }
+    else if (strcmp(buf, "mem") != 0)
+    {
+        printf("Unknown cache level: %s\n", buf);
+        return false;
+    }
+    cfg->enabled = true;
+
+    char *save = NULL;
+    for (char *kv = params ? strtok_r(params, ",", &save) : NULL; kv; kv = strtok_r(NULL, ",", &save))
+    {
+        char *value = strchr(kv, '=');
+        if (!value)
+        {
+            printf("Bad cache parameter: %s\n", kv);
+            return false;
+        }
+        *value++ = '\0';
+
+        bool ok = target ? parseCacheKey(target, kv, value)
+                         : (strcmp(kv, "lat") == 0 && parseNumber(value, &cfg->memLatency));
+        if (!ok)
+        {
+            printf("Bad cache parameter: %s=%s\n", kv, value);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isPowerOfTwo(unsigned v)
+{
+    return v && !(v & (v - 1));
+}
+
+static bool initCache(Cache *c, const char *name, const CacheConfig *cfg)
+{
+    memset(c, 0, sizeof(*c));
+    c->name = name;
+    c->cfg = *cfg;
+
+    if (!isPowerOfTwo(cfg->lineSize) || cfg->lineSize > MEMORY_SIZE)
+    {
+        printf("%s: line size must be a power of two up to %d\n", name, MEMORY_SIZE);
+        return false;
+    }
+    if (cfg->ways == 0 || cfg->size == 0 || cfg->size > MEMORY_SIZE ||
+        cfg->size % (cfg->lineSize * cfg->ways) != 0)
+    {
+        printf("%s: size must be a multiple of line * ways and at most %d bytes\n", name, MEMORY_SIZE);
+        return false;
+    }
+    if (cfg->repl == REPL_PLRU && !isPowerOfTwo(cfg->ways))
+    {
+        printf("%s: PLRU needs a power-of-two number of ways\n", name);
+        return false;
+    }
+    if (cfg->hitLatency == 0)
+    {
+        printf("%s: hit latency must be at least 1\n", name);
+        return false;
+    }
+
+    c->sets = cfg->size / (cfg->lineSize * cfg->ways);
+    c->rng = 2463534242u;
+    return true;
+}
+
+bool initMemSystem(MemSystem *ms, const MemConfig *cfg)
+{
+    memset(ms, 0, sizeof(*ms));
+    ms->cfg = *cfg;
+
+    if (cfg->split)
+    {
+        if (!initCache(&ms->l1i, "L1I", &cfg->l1i) || !initCache(&ms->l1d, "L1D", &cfg->l1d))
+            return false;
+    }
+    else if (!initCache(&ms->l1d, "L1", &cfg->l1d))
+    {
+        return false;
+    }
+    if (cfg->hasL2 && !initCache(&ms->l2, "L2", &cfg->l2))
+    {
+        return false;
+    }
+    return true;
+}
+
+// 3C 분류용 fully associative LRU 캐시, 적중하면 true
+static bool shadowAccess(Cache *c, uint16_t block)
+{
+    uint16_t capacity = c->cfg.size / c->cfg.lineSize;
+    uint16_t pos = 0;
+    while (pos < c->shadowCount && c->shadow[pos] != block)
+    {
+        pos++;
+    }
+    bool hit = pos < c->shadowCount;
+    if (!hit)
+    {
+        if (c->shadowCount < capacity)
+            c->shadowCount++;
+        pos = c->shadowCount - 1;
+    }
+    memmove(&c->shadow[1], &c->shadow[0], pos * sizeof(c->shadow[0]));
+    c->shadow[0] = block;
+    return hit;
+}
+
+// way를 최근 사용으로 표시
+static void touchWay(Cache *c, uint16_t set, uint16_t way)
+{
+    c->lines[set * c->cfg.ways + way].lastUse = ++c->clock;
+
+    // PLRU: 루트부터 way 쪽 반대 방향을 가리키게 함 (0 = 왼쪽이 교체 대상)
+    uint8_t *tree = &c->plru[set * c->cfg.ways];
+    unsigned node = 1, lo = 0, span = c->cfg.ways;
+    while (span > 1)
+    {
+        span /= 2;
+        if (way < lo + span)
+        {
+            tree[node] = 1;
+            node = node * 2;
+        }
+        else
+        {
+            tree[node] = 0;
+            node = node * 2 + 1;
+            lo += span;
+        }
+    }
+}
+
+static uint16_t chooseVictim(Cache *c, uint16_t set)
+{
+    CacheLine *lines = &c->lines[set * c->cfg.ways];
+    for (uint16_t way = 0; way < c->cfg.ways; way++)
+    {
+        if (!lines[way].valid)
+        {
+            return way;
+        }
+    }
+
+    switch (c->cfg.repl)
+    {
+    case REPL_PLRU:
+    {
+        const uint8_t *tree = &c->plru[set * c->cfg.ways];
+        unsigned node = 1, lo = 0, span = c->cfg.ways;
+        while (span > 1)
+        {
+            span /= 2;
+            if (tree[node] == 0)
+            {
+                node = node * 2;
+            }
+            else
+            {
+                node = node * 2 + 1;
+                lo += span;
+            }
+        }
+        return (uint16_t)lo;
+    }
+    case REPL_RANDOM:
+        // xorshift32
+        c->rng ^= c->rng << 13;
+        c->rng ^= c->rng >> 17;
+        c->rng ^= c->rng << 5;
+        return (uint16_t)(c->rng % c->cfg.ways);
+    case REPL_LRU:
+    default:
+    {
+        uint16_t victim = 0;
+        for (uint16_t way = 1; way < c->cfg.ways; way++)
+        {
+            if (lines[way].lastUse < lines[victim].lastUse)
+                victim = way;
+        }
+        return victim;
+    }
+    }
+}
+
+static uint32_t cacheAccess(MemSystem *ms, Cache *c, uint16_t addr, bool isWrite);
+
+// c 다음 단계 (L2 또는 메모리) 접근
+static uint32_t nextLevel(MemSystem *ms, Cache *c, uint16_t addr, bool isWrite)
+{
+    if (c != &ms->l2 && ms->cfg.hasL2)
+    {
+        return cacheAccess(ms, &ms->l2, addr, isWrite);
+    }
+    return ms->cfg.memLatency;
+}
+
+// 라인 하나 접근, 걸린 클록 수 반환
+static uint32_t cacheAccess(MemSystem *ms, Cache *c, uint16_t addr, bool isWrite)
+{
+    CacheStats *st = &c->stats;
+    uint16_t block = addr / c->cfg.lineSize;
+    uint16_t set = block % c->sets;
+    CacheLine *lines = &c->lines[set * c->cfg.ways];
+    uint32_t latency = c->cfg.hitLatency;
+
+    st->accesses++;
+    if (isWrite)
+        st->writes++;
+    else
+        st->reads++;
+
+    for (uint16_t way = 0; way < c->cfg.ways; way++)
+    {
+        if (lines[way].valid && lines[way].block == block)
+        {
+            st->hits++;
+            shadowAccess(c, block);
+            c->seen[block] = true;
+            touchWay(c, set, way);
+            if (isWrite && c->cfg.writeBack)
+            {
+                lines[way].dirty = true;
+            }
+            else if (isWrite)
+            {
+                st->writeThroughs++;
+                nextLevel(ms, c, addr, true);
+            }
+            st->latency += latency;
+            return latency;
+        }
+    }
+
+    st->misses++;
+    if (isWrite && !c->cfg.writeBack)
+    {
+        // no-write-allocate: 쓰기 버퍼로 보내고 끝 (라인을 채우지 않으므로 3C 분류에서 제외)
+        st->writeArounds++;
+        st->writeThroughs++;
+        nextLevel(ms, c, addr, true);
+        st->latency += latency;
+        return latency;
+    }
+
+    bool shadowHit = shadowAccess(c, block);
+    if (!c->seen[block])
+        st->compulsory++;
+    else if (!shadowHit)
+        st->capacity++;
+    else
+        st->conflict++;
+    c->seen[block] = true;
+
+    uint16_t way = chooseVictim(c, set);
+    CacheLine *line = &lines[way];
+    if (line->valid && line->dirty)
+    {
+        st->writebacks++;
+        nextLevel(ms, c, line->block * c->cfg.lineSize, true);
+    }
+    latency += nextLevel(ms, c, addr, false);
+    line->valid = true;
+    line->dirty = isWrite;
+    line->block = block;
+    touchWay(c, set, way);
+
+    st->latency += latency;
+    return latency;
+}
+
+uint32_t memAccess(MemSystem *ms, AccessKind kind, uint16_t addr, uint16_t len)
+{
+    Cache *c = (kind == MEM_IFETCH && ms->cfg.split) ? &ms->l1i : &ms->l1d;
+    uint32_t end = (uint32_t)addr + len;
+    if (end > MEMORY_SIZE)
+    {
+        end = MEMORY_SIZE;
+    }
+
+    uint32_t latency = 0;
+    uint32_t lineSize = c->cfg.lineSize;
+    for (uint32_t a = addr; a < end; a = (a / lineSize + 1) * lineSize)
+    {
+        latency += cacheAccess(ms, c, (uint16_t)a, kind == MEM_WRITE);
+    }
+    return latency;
+}
+
+uint32_t memAccessWide(MemSystem *ms, AccessKind kind, uint32_t addr)
+{
+    if (addr < MEMORY_SIZE)
+    {
+        return memAccess(ms, kind, (uint16_t)addr, 1);
+    }
+    // 캐시는 256바이트 주소만 태그로 가지므로 페이지 메모리는 매번 메모리까지
+    ms->pagedAccesses++;
+    return ms->cfg.memLatency;
+}
+
+static const char *const replNames[] = {"LRU", "PLRU", "random"};
+
+static void printCacheStats(const Cache *c)
+{
+    const CacheConfig *cfg = &c->cfg;
+    const CacheStats *st = &c->stats;
+    double n = st->accesses ? (double)st->accesses : 1.0;
+
+    printf("%-3s %uB %u-way %uB line %s %s, hit %u clk\n", c->name, cfg->size, cfg->ways, cfg->lineSize,
+           replNames[cfg->repl], cfg->writeBack ? "write-back" : "write-through", cfg->hitLatency);
+    printf("    accesses = %llu (reads %llu, writes %llu)\n", (unsigned long long)st->accesses,
+           (unsigned long long)st->reads, (unsigned long long)st->writes);
+    printf("    hits     = %llu (%.1f%%)\n", (unsigned long long)st->hits, 100.0 * st->hits / n);
+    printf("    misses   = %llu (compulsory %llu, capacity %llu, conflict %llu, write-around %llu)\n",
+           (unsigned long long)st->misses, (unsigned long long)st->compulsory, (unsigned long long)st->capacity,
+           (unsigned long long)st->conflict, (unsigned long long)st->writeArounds);
+    printf("    writebacks = %llu, write-throughs = %llu\n", (unsigned long long)st->writebacks,
+           (unsigned long long)st->writeThroughs);
+    printf("    AMAT     = %.2f clk\n", st->latency / n);
+}
+
+void printMemStats(const MemSystem *ms)
+{
+    printf("----- Caches -----\n");
+    if (ms->cfg.split)
+    {
+        printCacheStats(&ms->l1i);
+    }
+    printCacheStats(&ms->l1d);
+    if (ms->cfg.hasL2)
+    {
+        printCacheStats(&ms->l2);
+    }
+    printf("memory latency = %u clk\n", ms->cfg.memLatency);
+
+    // 전체 AMAT: CPU가 본 모든 접근의 평균
+    uint64_t accesses = ms->l1d.stats.accesses + ms->l1i.stats.accesses;
+    uint64_t latency = ms->l1d.stats.latency + ms->l1i.stats.latency;
+    printf("AMAT           = %.2f clk\n", accesses ? (double)latency / accesses : 0.0);
+    printf("stall cycles   = %llu\n", (unsigned long long)ms->stallCycles);
+    if (ms->pagedAccesses)
+    {
+        printf("paged (uncached) = %llu\n", (unsigned long long)ms->pagedAccesses);
+    }
+}
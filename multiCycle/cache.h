@@ -0,0 +1,115 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "cpu.h"
+
+// 한 캐시가 가질 수 있는 최대 라인 수 (메모리가 256바이트라 그보다 큰 캐시는 의미 없음)
+#define CACHE_MAX_LINES MEMORY_SIZE
+
+// 교체 정책
+typedef enum {
+    REPL_LRU,    // 가장 오래 안 쓴 라인
+    REPL_PLRU,   // 트리 pseudo-LRU (way 수가 2의 거듭제곱이어야 함)
+    REPL_RANDOM  // 의사 난수 (실행마다 같은 순서)
+} ReplacementPolicy;
+
+// 접근 종류
+typedef enum {
+    MEM_IFETCH, // 명령어 바이트 (IF/ID)
+    MEM_READ,   // MOV_MR
+    MEM_WRITE   // MOV_RM
+} AccessKind;
+
+// 캐시 하나의 설정
+typedef struct {
+    uint16_t size;      // 전체 크기 (바이트)
+    uint16_t ways;      // 연관도 (1 = direct-mapped, size/line = fully associative)
+    uint16_t lineSize;  // 라인 크기 (바이트, 2의 거듭제곱)
+    ReplacementPolicy repl;
+    bool writeBack;     // true = write-back + write-allocate, false = write-through + no-write-allocate
+    uint16_t hitLatency; // 적중 시 클록 수 (1이면 단계 클록 안에 끝남)
+} CacheConfig;
+
+// 메모리 계층 설정 (-c 옵션)
+typedef struct {
+    bool enabled;       // false = 지연 없는 메모리 (기존 동작)
+    bool split;         // true = L1I/L1D 분리, false = 통합 L1 (l1d 설정 사용)
+    bool hasL2;
+    CacheConfig l1i;
+    CacheConfig l1d;
+    CacheConfig l2;
+    uint16_t memLatency; // 마지막 캐시 미스 시 메모리 접근 클록 수
+} MemConfig;
+
+// 캐시별 통계
+typedef struct {
+    uint64_t accesses;
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t compulsory;  // 처음 참조하는 블록
+    uint64_t capacity;    // 같은 크기의 fully associative LRU 캐시에서도 미스
+    uint64_t conflict;    // fully associative였다면 적중
+    uint64_t writeArounds; // write-through 쓰기 미스 (라인을 채우지 않음, 3C 분류 제외)
+    uint64_t writebacks;  // dirty 라인을 내보낸 횟수
+    uint64_t writeThroughs; // 다음 단계로 바로 보낸 쓰기
+    uint64_t latency;     // 이 캐시에서 시작한 접근들의 클록 합 (AMAT 계산용)
+} CacheStats;
+
+typedef struct {
+    bool valid;
+    bool dirty;
+    uint16_t block;    // addr / lineSize (태그 + 세트 번호)
+    uint64_t lastUse;  // LRU
+} CacheLine;
+
+typedef struct {
+    const char *name;
+    CacheConfig cfg;
+    uint16_t sets;
+    CacheLine lines[CACHE_MAX_LINES];  // [set * ways + way]
+    uint8_t plru[CACHE_MAX_LINES];     // 세트마다 트리 비트 ways-1개 ([set * ways + node], node는 1부터)
+    uint16_t shadow[CACHE_MAX_LINES];  // 3C 분류용 fully associative LRU 캐시 (블록 번호, 최근 것이 앞)
+    uint16_t shadowCount;
+    bool seen[MEMORY_SIZE];            // 한 번이라도 참조한 블록
+    uint64_t clock;
+    uint32_t rng;
+    CacheStats stats;
+} Cache;
+
+// 메모리 계층 (VM이 포인터로 가짐, 캐시는 태그만 모델링하고 데이터는 vm->memory 그대로)
+struct MemSystem {
+    MemConfig cfg;
+    Cache l1i; // split일 때만 사용
+    Cache l1d; // 통합이면 명령어와 데이터 모두
+    Cache l2;
+    uint64_t stallCycles; // 캐시 때문에 엔진이 기다린 클록
+    uint64_t pagedAccesses; // MEMORY_SIZE 이상 주소 (MOV_RF/MOV_FR, 캐시를 거치지 않음)
+};
+typedef struct MemSystem MemSystem;
+
+// 기본값: 캐시 없음 (설정은 64B 2-way 8B 라인 L1, 256B 4-way 16B 라인 L2, 메모리 30클록)
+void initMemConfig(MemConfig *cfg);
+
+/**
+ * -c 옵션 해석: "level[:key=value,...]"
+ * level: l1 (통합), l1i, l1d (분리), l2, mem
+ * key: size, ways, line, repl (lru|plru|random), write (wb|wt), lat
+ * 예) l1d:size=32,ways=1,line=4,repl=lru,write=wt  l2:size=256,lat=8  mem:lat=50
+ */
+bool parseCacheOption(MemConfig *cfg, const char *spec);
+
+// 설정을 검사하고 빈 캐시로 초기화, 잘못된 설정이면 메시지를 출력하고 false
+bool initMemSystem(MemSystem *ms, const MemConfig *cfg);
+
+// [addr, addr + len) 접근, 걸린 클록 수 반환 (라인마다 한 번씩 접근, 메모리 밖 바이트는 무시)
+uint32_t memAccess(MemSystem *ms, AccessKind kind, uint16_t addr, uint16_t len);
+
+// MOV_RF/MOV_FR의 addr 접근: MEMORY_SIZE 미만은 memAccess와 같고, 그 위는 캐시 없이 memLatency
+uint32_t memAccessWide(MemSystem *ms, AccessKind kind, uint32_t addr);
+
+// 캐시별 적중률, 미스 분류, AMAT 출력
+void printMemStats(const MemSystem *ms);
+
+#endif
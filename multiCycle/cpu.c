@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 #include "cpu.h"
+#include "cache.h"
+#include "paged.h"
 
 /**
  * VM 초기화
@@ -43,11 +45,44 @@ uint16_t getInstructionSize(const Instruction *instr)
     case JMP:
         return 2;
 
+    // opcode + addr32 + reg (MOV_RF) / opcode + reg + addr32 (MOV_FR)
+    case MOV_RF:
+    case MOV_FR:
+        return WIDE_INSTR_SIZE;
+
     default:
         return 1; // INVALID 등
     }
 }
 
+// 캐시 접근: 첫 클록은 단계 자체의 클록이고 나머지는 대기 클록으로 남김
+static void chargeMemory(VM *vm, AccessKind kind, uint16_t addr, uint16_t len)
+{
+    if (!vm->mem)
+    {
+        return;
+    }
+    uint32_t latency = memAccess(vm->mem, kind, addr, len);
+    if (latency > 1)
+    {
+        vm->cpu.memStall += latency - 1;
+    }
+}
+
+// MOV_RF/MOV_FR 데이터 접근 (페이지 메모리는 캐시 없이 memLatency)
+static void chargeWide(VM *vm, AccessKind kind, uint32_t addr)
+{
+    if (!vm->mem)
+    {
+        return;
+    }
+    uint32_t latency = memAccessWide(vm->mem, kind, addr);
+    if (latency > 1)
+    {
+        vm->cpu.memStall += latency - 1;
+    }
+}
+
 /*  -------------------------------------
         다중 사이클 단계별 함수
     -------------------------------------
@@ -65,6 +100,8 @@ static void stageFetch(VM *vm)
         return;
     }
 
+    PERF_INC(vm, fetches);
+    chargeMemory(vm, MEM_IFETCH, cpu->PC, 1);
     uint8_t opcodeByte = vm->memory[cpu->PC];
     cpu->currentInstr.opcode = (Opcode)opcodeByte;
 
@@ -99,9 +136,8 @@ static void stageDecode(VM *vm)
     case ADD_RR:
     case SUB_RR:
         instr->opType = OPERAND_REG_REG;
-        instr->regA = vm->memory[cpu->PC + 1]; // 목적지(dst)
-        instr->regB = vm->memory[cpu->PC + 2]; // 소스(src)
-        //printf("PC=%d, regA=%d, regB=%d\n", cpu->PC + 2, instr->regA, instr->regB);
+        instr->regA = vm->memory[cpu->PC + 1] & (NUM_REGS - 1); // 목적지(dst)
+        instr->regB = vm->memory[cpu->PC + 2] & (NUM_REGS - 1); // 소스(src)
         break;
 
     // MOV_RM addr, reg => [addr] <- reg
@@ -109,14 +145,14 @@ static void stageDecode(VM *vm)
     case MOV_RM:
         instr->opType = OPERAND_REG_MEM;
         instr->imm = vm->memory[cpu->PC + 1];  // 목적지(메모리 주소)
-        instr->regB = vm->memory[cpu->PC + 2]; // 소스(레지스터)
+        instr->regB = vm->memory[cpu->PC + 2] & (NUM_REGS - 1); // 소스(레지스터)
         break;
 
     // MOV_MR reg, addr => reg <- [addr]
     // => 첫 번째(regA=reg), 두 번째(imm=addr)
     case MOV_MR:
         instr->opType = OPERAND_MEM_REG;
-        instr->regA = vm->memory[cpu->PC + 1]; // 목적지(레지스터)
+        instr->regA = vm->memory[cpu->PC + 1] & (NUM_REGS - 1); // 목적지(레지스터)
         instr->imm = vm->memory[cpu->PC + 2];  // 소스(메모리 주소)
         break;
 
@@ -125,10 +161,31 @@ static void stageDecode(VM *vm)
         instr->imm = vm->memory[cpu->PC + 1];
         break;
 
+    // MOV_RF addr32, reg => [addr32] <- reg
+    case MOV_RF:
+        instr->opType = OPERAND_REG_MEM;
+        instr->imm = wideOperand(vm, cpu->PC + WIDE_ADDR_OFFSET(MOV_RF));
+        instr->regB = wideRegister(vm, cpu->PC);
+        break;
+
+    // MOV_FR reg, addr32 => reg <- [addr32]
+    case MOV_FR:
+        instr->opType = OPERAND_MEM_REG;
+        instr->regA = wideRegister(vm, cpu->PC);
+        instr->imm = wideOperand(vm, cpu->PC + WIDE_ADDR_OFFSET(MOV_FR));
+        break;
+
     default:
         instr->opcode = INVALID;
         break;
     }
+
+    // 오퍼랜드 바이트 (opcode 바이트는 IF에서 읽음)
+    uint16_t size = getInstructionSize(instr);
+    if (size > 1)
+    {
+        chargeMemory(vm, MEM_IFETCH, cpu->PC + 1, size - 1);
+    }
 }
 
 // STEP3: EXECUTE
@@ -142,6 +199,8 @@ static void stageExecute(VM *vm)
     {
     case HALT:
         vm->running = false;
+        PERF_INC(vm, retired);
+        PERF_INC(vm, opcodes[HALT]);
         break;
 
     case NOP:
@@ -173,6 +232,8 @@ static void stageExecute(VM *vm)
     // 메모리 접근은 MEM 단계에서
     case MOV_RM: // [addr] <- reg
     case MOV_MR: // reg <- [addr]
+    case MOV_RF: // [addr32] <- reg
+    case MOV_FR: // reg <- [addr32]
         break;
 
     case JMP:
@@ -200,7 +261,10 @@ static void stageMemory(VM *vm)
         if (instr->imm < MEMORY_SIZE)
         {
             // imm=addr, regB=소스 레지스터
+            PERF_INC(vm, memWrites);
+            chargeMemory(vm, MEM_WRITE, instr->imm, 1);
             vm->memory[instr->imm] = cpu->regs[instr->regB];
+            MARK_DIRTY(vm, instr->imm);
         }
         else
         {
@@ -214,6 +278,8 @@ static void stageMemory(VM *vm)
         if (instr->imm < MEMORY_SIZE)
         {
             // imm=addr, regA=목적지 레지스터
+            PERF_INC(vm, memReads);
+            chargeMemory(vm, MEM_READ, instr->imm, 1);
             cpu->aluResult = vm->memory[instr->imm];
         }
         else
@@ -223,6 +289,38 @@ static void stageMemory(VM *vm)
         }
         break;
 
+    // MOV_RF addr32, reg => [addr32] <- reg (256 미만은 기존 메모리)
+    case MOV_RF:
+        if (wideStore(vm, instr->imm, cpu->regs[instr->regB]))
+        {
+            PERF_INC(vm, memWrites);
+            chargeWide(vm, MEM_WRITE, instr->imm);
+        }
+        else
+        {
+            wideAccessError(vm, MOV_RF, instr->imm, cpu->PC);
+            vm->running = false;
+        }
+        break;
+
+    // MOV_FR reg, addr32 => reg <- [addr32]
+    case MOV_FR:
+    {
+        uint8_t value;
+        if (wideLoad(vm, instr->imm, &value))
+        {
+            PERF_INC(vm, memReads);
+            chargeWide(vm, MEM_READ, instr->imm);
+            cpu->aluResult = value;
+        }
+        else
+        {
+            wideAccessError(vm, MOV_FR, instr->imm, cpu->PC);
+            vm->running = false;
+        }
+        break;
+    }
+
     // ADD, SUB, MOV_RR, JMP, HALT, NOP 등은 메모리 접근 없음
     default:
         break;
@@ -235,6 +333,9 @@ static void stageWriteback(VM *vm)
     CPUState *cpu = &vm->cpu;
     Instruction *instr = &cpu->currentInstr;
 
+    PERF_INC(vm, retired);
+    PERF_INC(vm, opcodes[instr->opcode]);
+
     switch (instr->opcode)
     {
 
@@ -251,7 +352,9 @@ static void stageWriteback(VM *vm)
         break;
 
     // MOV_MR reg, addr => reg <- aluResult
+    // MOV_FR reg, addr32 => reg <- aluResult
     case MOV_MR:
+    case MOV_FR:
         cpu->regs[instr->regA] = (uint8_t)cpu->aluResult;
         break;
 
@@ -291,6 +394,19 @@ void multiCycleStep(VM *vm)
     if (!vm->running)
         return;
 
+    PERF_INC(vm, cycles);
+
+    // 캐시 미스 대기 중이면 단계를 진행하지 않음
+    if (cpu->memStall > 0)
+    {
+        cpu->memStall--;
+        vm->mem->stallCycles++;
+        PERF_INC(vm, stallCycles);
+        return;
+    }
+
+    PERF_INC(vm, stageBusy[cpu->stage]);
+
     switch (cpu->stage)
     {
     case STAGE_FETCH:
@@ -320,15 +436,37 @@ void multiCycleStep(VM *vm)
     }
 }
 
-// VM 실행 루프
-void runVM(VM *vm)
+// 명령어 하나 (트레이스, 디버거): 단계 루프를 여기 두어 multiCycleStep()이 인라인되게
+uint64_t runInstruction(VM *vm, uint64_t maxCycles)
 {
-    vm->cpu.stage = STAGE_FETCH; // 초기화
+    uint64_t cycles = 0;
+    do
+    {
+        multiCycleStep(vm);
+        cycles++;
+    } while (vm->running && vm->cpu.stage != STAGE_FETCH && (maxCycles == 0 || cycles < maxCycles));
+    return cycles;
+}
+
+// 클록 수 제한이 있는 실행 루프 (0 = 제한 없음), 실행한 클록 수를 반환
+// 제한에 걸리면 stage가 그대로 남아 있으므로 다시 호출하면 이어서 실행
+uint64_t runVMFor(VM *vm, uint64_t maxCycles)
+{
+    uint64_t cycles = 0;
     vm->running = true;
 
-    while (vm->running)
+    while (vm->running && (maxCycles == 0 || cycles < maxCycles))
     {
         multiCycleStep(vm);
+        cycles++;
     }
+    return cycles;
+}
+
+// VM 실행 루프
+void runVM(VM *vm)
+{
+    vm->cpu.stage = STAGE_FETCH; // 초기화
+    runVMFor(vm, 0);
     printf("VM stopped.\n");
 }
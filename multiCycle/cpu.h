@@ -3,12 +3,23 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "perf.h"
 
 //메모리 크기(바이트 단위).
 #define MEMORY_SIZE 256
 // CPU의 범용 레지스터 개수
 #define NUM_REGS 8 
 
+// 체크포인트용 dirty 비트맵: 메모리를 8바이트 라인으로 나눠 라인마다 1비트 (checkpoint.h)
+#define DIRTY_LINE_SHIFT 3
+#define DIRTY_LINE_SIZE (1 << DIRTY_LINE_SHIFT)
+#define DIRTY_LINES (MEMORY_SIZE >> DIRTY_LINE_SHIFT)
+#define DIRTY_ALL ((uint32_t)((1ull << DIRTY_LINES) - 1))
+_Static_assert(DIRTY_LINES <= 32, "dirty bitmap must fit in uint32_t");
+
+// MOV_RM 저장마다 호출 (엔진마다 저장하는 곳에서)
+#define MARK_DIRTY(vm, addr) ((vm)->dirty |= 1u << ((addr) >> DIRTY_LINE_SHIFT))
+
 
 // Opcode(어떤 연산을 수행 할 것인지)를 정의
 typedef enum {
@@ -20,9 +31,17 @@ typedef enum {
     ADD_RR  = 5, // ADD_RR dst, src : dst <- dst + src
     SUB_RR  = 6, // SUB_RR dst, src : dst <- dst - src
     JMP     = 7,
-    INVALID = 8
+    MOV_RF  = 8, // MOV_RF addr32, reg : [addr32] <- reg (넓은 주소, paged.h)
+    MOV_FR  = 9, // MOV_FR reg, addr32 : reg <- [addr32]
+    INVALID = 10
 } Opcode;
 
+// MOV_RF addr32, reg / MOV_FR reg, addr32: 6바이트
+// 32비트 주소(리틀 엔디언)와 레지스터 번호가 있는 바이트 위치
+#define WIDE_INSTR_SIZE 6
+#define WIDE_ADDR_OFFSET(op) ((op) == MOV_RF ? 1 : 2)
+#define WIDE_REG_OFFSET(op) ((op) == MOV_RF ? 5 : 1)
+
 
 // 오퍼랜드(연산을 수행할 대상) 유형을 단순화해 놓은 예시.
 typedef enum {
@@ -40,7 +59,7 @@ typedef struct {
     OperandType opType;
     uint8_t regA;
     uint8_t regB;
-    uint8_t imm;
+    uint32_t imm; // MOV_RF/MOV_FR는 32비트 주소
 } Instruction;
 
 // 파이프라이닝을 위한 단계 저장
@@ -62,14 +81,25 @@ typedef struct {
     PipelineStage stage; // 현재 어떤 사이클인지
     Instruction currentInstr; // 현재 처리 중인 명령어
     uint16_t aluResult; //EX 단계 결과 저장
+    uint32_t memStall; // 캐시 미스로 남은 대기 클록
 } CPUState;
 
 
+struct MemSystem; // cache.h
+struct PagedMemory; // paged.h
+
 // VM 상태
 typedef struct {
     CPUState cpu;
     uint8_t memory[MEMORY_SIZE];
     bool running;
+    uint32_t dirty; // 마지막 체크포인트 이후 MOV_RM이 쓴 라인 (DIRTY_LINE_SIZE 단위)
+    struct PagedMemory *paged; // MEMORY_SIZE 이상 주소 (처음 쓸 때 할당, NULL = 아직 없음)
+    uint8_t addrBits;          // MOV_RF/MOV_FR 주소 폭 (16 또는 32, 0 = WIDE_ADDR_BITS)
+    struct MemSystem *mem; // 캐시 계층 (NULL = 지연 없는 메모리)
+#ifdef PERF_COUNTERS
+    PerfCounters perf; // 성능 카운터 (perf.h)
+#endif
 } VM;
 
 
@@ -84,8 +114,15 @@ uint16_t getInstructionSize(const Instruction *instr);
 // 다중 사이클: 한 클록(=1단계) 처리
 void multiCycleStep(VM *vm);
 
+// 지금 명령어가 끝날 때까지 클록을 돌림 (다음 IF 직전, HALT/오류면 멈춘 곳, 0 = 제한 없음)
+// 실행한 클록 수를 반환
+uint64_t runInstruction(VM *vm, uint64_t maxCycles);
+
 // VM 실행 루프 (다중 사이클)
 void runVM(VM *vm);
 
+// 클록 수 제한이 있는 실행 루프 (0 = 제한 없음), 실행한 클록 수를 반환
+uint64_t runVMFor(VM *vm, uint64_t maxCycles);
+
 #endif
 
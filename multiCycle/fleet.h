@@ -0,0 +1,31 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "cpu.h"
+#include "pipeline.h"
+#include "cache.h"
+#include "ooo.h"
+#include "superscalar.h"
+
+// fleet 모드 설정
+typedef struct {
+    uint64_t maxCycles; // 프로그램당 최대 클록 수 (0 = 제한 없음)
+    bool pipelined;     // 5단 파이프라인으로 실행
+    PipelineConfig pipe;
+    bool outOfOrder;    // 비순차 엔진으로 실행 (-e ooo)
+    OooConfig ooo;
+    bool superscalar;   // 순차 N-wide 엔진으로 실행 (-e superscalar)
+    SuperscalarConfig wide;
+    MemConfig mem;      // 캐시 계층 (프로그램마다 빈 캐시에서 시작)
+    int threads;       // 작업 스레드 수 (0 = 코어 수)
+    uint8_t addrBits;  // MOV_RF/MOV_FR 주소 폭 (-A, 0 = 기본값)
+} FleetOptions;
+
+/**
+ * 매니페스트(한 줄에 프로그램 경로 하나) 또는 디렉터리 안의 프로그램들을
+ * 한 프로세스에서 work-stealing 스레드 풀로 실행하고 프로그램별 요약을 한 줄씩 출력
+ * 목록을 만들 수 없거나 로드에 실패한 프로그램이 있으면 0이 아닌 값을 반환
+ */
+int runFleet(const char *source, const FleetOptions *opts);
+
+#endif
@@ -0,0 +1,435 @@
+#include <stdio.h>
+#include <string.h>
+#include "functional.h"
+#include "paged.h"
+
+#define NO_BLOCK 0xFFFFFFFFu
+#define ACCEL_DIM (NUM_REGS + 1) // 레지스터 + 상수 1
+#define ACCEL_MAX_BACKOFF 128
+
+// 루프 한 바퀴(또는 여러 바퀴)의 효과: 행 = 결과 레지스터, 열 = 시작 때 레지스터 계수 (마지막 열은 상수, 마지막 행은 1)
+typedef uint8_t AffineMap[ACCEL_DIM][ACCEL_DIM];
+
+const uint8_t instrSize[INVALID] = {
+    [HALT] = 1, [NOP] = 1, [MOV_RR] = 3, [MOV_RM] = 3, [MOV_MR] = 3,
+    [ADD_RR] = 3, [SUB_RR] = 3, [JMP] = 2, [MOV_RF] = WIDE_INSTR_SIZE, [MOV_FR] = WIDE_INSTR_SIZE,
+};
+
+// 데이터 접근 warming (통합 L1이면 마지막 fetch 라인이 더 이상 최근 사용이 아닐 수 있음)
+static inline void warmData(const FunctionalHooks *warm, AccessKind kind, uint32_t addr, uint32_t *fetchBlock)
+{
+    memAccessWide(warm->mem, kind, addr);
+    if (warm->unified)
+    {
+        *fetchBlock = NO_BLOCK;
+    }
+}
+
+void initWarming(FunctionalHooks *hooks, MemSystem *mem, BranchPredictor *bp)
+{
+    memset(hooks, 0, sizeof(*hooks));
+    hooks->mem = mem;
+    hooks->bp = bp;
+    if (mem)
+    {
+        hooks->unified = !mem->cfg.split;
+        hooks->fetchLine = hooks->unified ? mem->l1d.cfg.lineSize : mem->l1i.cfg.lineSize;
+    }
+}
+
+void initLoopAccel(LoopAccel *accel)
+{
+    memset(accel, 0, sizeof(*accel));
+}
+
+static void identityMap(AffineMap m)
+{
+    memset(m, 0, sizeof(AffineMap));
+    for (int i = 0; i < ACCEL_DIM; i++)
+    {
+        m[i][i] = 1;
+    }
+}
+
+// out = a x b (b를 먼저 적용), mod 256은 uint8_t로 자름
+static void composeMaps(AffineMap out, const AffineMap a, const AffineMap b)
+{
+    AffineMap t;
+    for (int i = 0; i < ACCEL_DIM; i++)
+    {
+        for (int j = 0; j < ACCEL_DIM; j++)
+        {
+            unsigned sum = 0;
+            for (int k = 0; k < ACCEL_DIM; k++)
+            {
+                sum += (unsigned)a[i][k] * b[k][j];
+            }
+            t[i][j] = (uint8_t)sum;
+        }
+    }
+    memcpy(out, t, sizeof(AffineMap));
+}
+
+/**
+ * target ~ jmp(JMP 포함) 몸체 한 바퀴를 map으로 요약, 명령어 수를 *length에
+ * 몸체가 jmp에서 정확히 끝나지 않거나, 다른 opcode가 있거나,
+ * store가 몸체 코드/읽는 주소에 닿으면 (자기 수정, 반복마다 바뀌는 load) false
+ */
+static bool summarizeLoop(const VM *vm, uint16_t target, uint16_t jmp, AffineMap map, uint32_t *length)
+{
+    bool loaded[MEMORY_SIZE] = {false};
+    bool stored[MEMORY_SIZE] = {false};
+    uint32_t n = 1;
+    identityMap(map);
+
+    for (uint16_t pc = target; pc != jmp; n++)
+    {
+        if (pc > jmp)
+        {
+            return false; // 명령어 경계가 JMP와 맞지 않음
+        }
+        uint8_t op = vm->memory[pc];
+        uint8_t *dst = map[operandByte(vm, pc + 1) & (NUM_REGS - 1)];
+        const uint8_t *src = map[operandByte(vm, pc + 2) & (NUM_REGS - 1)];
+        switch (op)
+        {
+        case NOP:
+            break;
+
+        case MOV_RR:
+            memmove(dst, src, ACCEL_DIM);
+            break;
+
+        case ADD_RR:
+            for (int j = 0; j < ACCEL_DIM; j++)
+            {
+                dst[j] += src[j];
+            }
+            break;
+
+        case SUB_RR:
+            for (int j = 0; j < ACCEL_DIM; j++)
+            {
+                dst[j] -= src[j];
+            }
+            break;
+
+        // MOV_MR reg, addr: 몸체가 addr에 쓰지 않으면 반복마다 같은 상수
+        case MOV_MR:
+        {
+            uint8_t addr = operandByte(vm, pc + 2);
+            memset(dst, 0, ACCEL_DIM);
+            dst[NUM_REGS] = vm->memory[addr];
+            loaded[addr] = true;
+            break;
+        }
+
+        // MOV_RM addr, reg: 레지스터는 그대로
+        case MOV_RM:
+            stored[operandByte(vm, pc + 1)] = true;
+            break;
+
+        default:
+            return false; // HALT, JMP, 넓은 주소, 잘못된 opcode
+        }
+        pc += instrSize[op];
+    }
+
+    for (uint16_t addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        if (stored[addr] && (loaded[addr] || (addr >= target && addr <= jmp + 1)))
+        {
+            return false;
+        }
+    }
+    *length = n;
+    return true;
+}
+
+// target으로 가는 jmp를 막 실행한 상태에서 budget 명령어 안의 반복을 건너뜀, 건너뛴 명령어 수 반환
+static uint64_t accelerateLoop(VM *vm, LoopAccel *accel, uint16_t target, uint16_t jmp, uint64_t budget)
+{
+    // 몸체 명령어는 3바이트 이하이므로 길이 하한으로 먼저 걸러서 짧은 예산마다 분석하지 않음
+    if (budget <= (uint64_t)ACCEL_MIN_ITERATIONS * ((jmp - target) / 3 + 1))
+    {
+        return 0;
+    }
+    if (accel->backoff[jmp])
+    {
+        accel->backoff[jmp]--;
+        return 0;
+    }
+
+    AffineMap step;
+    uint32_t length;
+    accel->analyses++;
+    if (!summarizeLoop(vm, target, jmp, step, &length))
+    {
+        uint8_t p = accel->penalty[jmp];
+        accel->penalty[jmp] = p ? ((p < ACCEL_MAX_BACKOFF) ? p * 2 : p) : 1;
+        accel->backoff[jmp] = accel->penalty[jmp];
+        accel->rejected++;
+        return 0;
+    }
+    accel->penalty[jmp] = 0;
+
+    // 마지막 한 바퀴는 해석 실행해서 store 값을 메모리에 남김
+    uint64_t k = budget / length;
+    if (k <= ACCEL_MIN_ITERATIONS)
+    {
+        return 0;
+    }
+    k--;
+
+    AffineMap total;
+    identityMap(total);
+    for (uint64_t e = k; e; e >>= 1)
+    {
+        if (e & 1)
+        {
+            composeMaps(total, total, step);
+        }
+        composeMaps(step, step, step);
+    }
+
+    uint8_t *regs = vm->cpu.regs;
+    uint8_t next[NUM_REGS];
+    for (int i = 0; i < NUM_REGS; i++)
+    {
+        unsigned sum = total[i][NUM_REGS];
+        for (int j = 0; j < NUM_REGS; j++)
+        {
+            sum += (unsigned)total[i][j] * regs[j];
+        }
+        next[i] = (uint8_t)sum;
+    }
+    memcpy(regs, next, NUM_REGS);
+
+    accel->jumps++;
+    accel->iterations += k;
+    accel->skipped += k * length;
+    return k * length;
+}
+
+void printLoopAccel(const LoopAccel *accel)
+{
+    if (accel->analyses == 0)
+    {
+        printf("Loop acceleration: no backward JMP analyzed\n");
+        return;
+    }
+    printf("Loop acceleration: %llu jumps over %llu iterations (%llu instructions skipped), "
+           "%llu of %llu loop bodies rejected\n",
+           (unsigned long long)accel->jumps, (unsigned long long)accel->iterations,
+           (unsigned long long)accel->skipped, (unsigned long long)accel->rejected,
+           (unsigned long long)accel->analyses);
+}
+
+// 데이터 접근 하나를 warming과 port에 알림 (성공한 접근만)
+static inline void noteData(const FunctionalHooks *warm, const MemoryPort *port, AccessKind kind, uint32_t addr,
+                            uint8_t value, uint32_t *fetchBlock)
+{
+    if (warm->mem)
+    {
+        warmData(warm, kind, addr, fetchBlock);
+    }
+    if (port)
+    {
+        port->access(port->ctx, kind, addr, value);
+    }
+}
+
+/**
+ * pc의 명령어 하나 실행, 실행하려던 opcode 반환 (PC가 메모리 밖이면 INVALID), 다음 PC는 *nextPC
+ * PC는 호출한 쪽이 옮김 (HALT/오류는 vm->running = false이고 PC를 그대로 둠)
+ * runFunctional()의 루프와 stepFunctional()이 같이 씀 (루프 안에 펼쳐지도록 always_inline,
+ * PC를 여기서 쓰면 레지스터/메모리 바이트 쓰기와 alias돼서 루프가 느려짐)
+ */
+static inline __attribute__((always_inline)) uint8_t executeOne(VM *vm, const FunctionalHooks *warm,
+                                                                 const MemoryPort *port, uint32_t *fetchBlock,
+                                                                 uint16_t pc, uint16_t *nextPC)
+{
+    uint8_t *regs = vm->cpu.regs;
+    if (pc >= MEMORY_SIZE)
+    {
+        printf("PC out of memory range!\n");
+        vm->running = false;
+        *nextPC = pc;
+        return INVALID;
+    }
+    uint8_t op = vm->memory[pc];
+    uint8_t b1 = operandByte(vm, pc + 1);
+    uint8_t b2 = operandByte(vm, pc + 2);
+    uint16_t next = pc + instrLength(op);
+
+    if (warm->mem)
+    {
+        uint32_t first = pc / warm->fetchLine;
+        uint32_t last = (next - 1u) / warm->fetchLine;
+        if (first != last || first != *fetchBlock)
+        {
+            memAccess(warm->mem, MEM_IFETCH, pc, next - pc);
+            *fetchBlock = last;
+        }
+    }
+    if (warm->bp)
+    {
+        Prediction pred = predictBranch(warm->bp, pc);
+        updatePredictor(warm->bp, pc, op == JMP, b1, &pred);
+    }
+    if (port)
+    {
+        port->fetch(port->ctx, pc, next);
+    }
+
+    switch (op)
+    {
+    case HALT:
+        vm->running = false;
+        break;
+
+    case NOP:
+        break;
+
+    case MOV_RR:
+        regs[b1 & (NUM_REGS - 1)] = regs[b2 & (NUM_REGS - 1)];
+        break;
+
+    case ADD_RR:
+        regs[b1 & (NUM_REGS - 1)] += regs[b2 & (NUM_REGS - 1)];
+        break;
+
+    case SUB_RR:
+        regs[b1 & (NUM_REGS - 1)] -= regs[b2 & (NUM_REGS - 1)];
+        break;
+
+    // MOV_RM addr, reg
+    case MOV_RM:
+    {
+        uint8_t value = regs[b2 & (NUM_REGS - 1)];
+        noteData(warm, port, MEM_WRITE, b1, value, fetchBlock);
+        vm->memory[b1] = value;
+        MARK_DIRTY(vm, b1);
+        break;
+    }
+
+    // MOV_MR reg, addr
+    case MOV_MR:
+        noteData(warm, port, MEM_READ, b2, 0, fetchBlock);
+        regs[b1 & (NUM_REGS - 1)] = vm->memory[b2];
+        break;
+
+    case JMP:
+        next = b1;
+        break;
+
+    case MOV_RF:
+    {
+        uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF));
+        uint8_t value = regs[wideRegister(vm, pc)];
+        if (!wideStore(vm, addr, value))
+        {
+            wideAccessError(vm, MOV_RF, addr, pc);
+            vm->running = false;
+            break;
+        }
+        noteData(warm, port, MEM_WRITE, addr, value, fetchBlock);
+        break;
+    }
+
+    case MOV_FR:
+    {
+        uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_FR));
+        uint8_t value;
+        if (!wideLoad(vm, addr, &value))
+        {
+            wideAccessError(vm, MOV_FR, addr, pc);
+            vm->running = false;
+            break;
+        }
+        noteData(warm, port, MEM_READ, addr, 0, fetchBlock);
+        regs[wideRegister(vm, pc)] = value;
+        break;
+    }
+
+    default:
+        printf("Invalid opcode\n");
+        vm->running = false;
+        break;
+    }
+
+    *nextPC = next;
+    return op;
+}
+
+bool stepFunctional(VM *vm, const MemoryPort *port)
+{
+    static const FunctionalHooks none = {0};
+    uint32_t fetchBlock = NO_BLOCK;
+    uint16_t next;
+    uint8_t op = executeOne(vm, &none, port, &fetchBlock, vm->cpu.PC, &next);
+    if (vm->running)
+    {
+        vm->cpu.PC = next;
+        return true;
+    }
+    return op == HALT;
+}
+
+uint64_t runFunctional(VM *vm, uint64_t count, FunctionalHooks *hooks)
+{
+    static const FunctionalHooks none = {0};
+    const FunctionalHooks *warm = hooks ? hooks : &none;
+    LoopAccel *accel = (warm->mem || warm->bp) ? NULL : warm->accel;
+    uint64_t done = 0;
+    uint64_t blockBegin = 0; // 지금 블록이 이번 호출에서 시작한 위치 (done 기준)
+    // 마지막으로 fetch한 라인: 그 사이 다른 접근이 없으면 같은 라인을 다시 접근해도 LRU/PLRU 상태가 그대로라 건너뜀
+    uint32_t fetchBlock = NO_BLOCK;
+
+    while (done < count)
+    {
+        uint16_t pc = vm->cpu.PC;
+        uint16_t next;
+        uint8_t op = executeOne(vm, warm, NULL, &fetchBlock, pc, &next);
+
+        // HALT만 실행한 명령어로 셈
+        if (!vm->running)
+        {
+            done += (op == HALT);
+            break;
+        }
+        vm->cpu.PC = next;
+        done++;
+        if (op != JMP)
+        {
+            continue;
+        }
+
+        // 기본 블록은 JMP에서 끝나고 대상에서 시작
+        if (hooks && hooks->bbv)
+        {
+            hooks->bbv[hooks->blockStart] += done - blockBegin;
+            hooks->blockStart = next;
+            blockBegin = done;
+        }
+
+        // 건너뛴 반복은 모두 JMP 대상에서 시작하는 같은 블록
+        if (accel && next <= pc)
+        {
+            uint64_t skipped = accelerateLoop(vm, accel, next, pc, count - done);
+            done += skipped;
+            if (hooks->bbv)
+            {
+                hooks->bbv[next] += skipped;
+                blockBegin += skipped;
+            }
+        }
+    }
+
+    // 끝나지 않은 블록은 다음 호출에서 같은 시작 PC로 이어서 셈
+    if (hooks && hooks->bbv)
+    {
+        hooks->bbv[hooks->blockStart] += done - blockBegin;
+    }
+    return done;
+}
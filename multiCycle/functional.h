@@ -0,0 +1,81 @@
+#ifndef FUNCTIONAL_H
+#define FUNCTIONAL_H
+
+#include "cpu.h"
+#include "cache.h"
+#include "bpred.h"
+
+/**
+ * 기능 실행 코어 (샘플링 -S, SimPoint -B/-Y의 빨리 감기)
+ * 클록 없이 명령어 하나씩 multiCycle과 같은 결과로 실행 (레지스터 번호는 pipeline처럼 마스킹)
+ * 단계 루프가 없어서 multicycle 엔진보다 3~4배 빠름
+ * 훅을 켜면 실행하면서 캐시 태그/분기 예측기를 갱신하거나 (warming) 기본 블록 벡터를 셈
+ *
+ * 루프 가속 (hooks->accel, warming 중에는 안 함)
+ * 뒤로 가는 JMP를 실행한 직후 몸체(JMP 대상 ~ JMP)를 분석해서 한 바퀴의 효과를 mod 256 아핀 변환
+ * r' = A r + c (9x9 행렬, 마지막 열이 상수)로 요약하고, 남은 명령어 예산 안의 반복 k번을 A^k(제곱 반복)로 한 번에 적용
+ * - 몸체는 NOP, MOV_RR, ADD_RR, SUB_RR, MOV_MR(상수), MOV_RM만 (조건 분기가 없으므로 몸체는 일직선)
+ * - MOV_MR은 몸체가 그 주소에 쓰지 않을 때만 상수, store가 몸체 코드나 읽는 주소에 닿으면 요약하지 않음
+ * - store는 주소가 고정이라 메모리에 마지막 바퀴 값만 남으므로 마지막 한 바퀴는 해석 실행
+ * 요약할 수 없는 몸체는 해석 실행으로 그대로 진행하고, 그 JMP는 거절할 때마다 두 배로 늘리는 방문 수만큼 다시 분석하지 않음
+ * 결과(레지스터, 메모리, 명령어 수, 기본 블록 벡터)는 가속하지 않을 때와 같음
+ */
+
+// opcode별 명령어 길이 (getInstructionSize()와 같음, INVALID 이상은 instrLength()로)
+extern const uint8_t instrSize[INVALID];
+
+static inline uint8_t instrLength(uint8_t op)
+{
+    return (op < INVALID) ? instrSize[op] : 1;
+}
+
+#define ACCEL_MIN_ITERATIONS 64 // 이보다 적게 건너뛸 수 있으면 해석 실행 (행렬 제곱이 더 비쌈)
+
+// 루프 가속 상태와 통계 (여러 번의 runFunctional() 호출에 걸쳐 유지)
+typedef struct {
+    uint8_t backoff[MEMORY_SIZE]; // JMP 주소별: 다시 분석하기 전에 건너뛸 방문 수
+    uint8_t penalty[MEMORY_SIZE]; // JMP 주소별: 다음에 거절하면 쓸 backoff
+    uint64_t analyses;   // 몸체를 분석한 수
+    uint64_t rejected;   // 메모리/제어 흐름 때문에 요약하지 못한 몸체
+    uint64_t jumps;      // 반복을 한꺼번에 건너뛴 수
+    uint64_t iterations; // 건너뛴 반복
+    uint64_t skipped;    // 건너뛴 명령어
+} LoopAccel;
+
+// 실행하면서 갱신할 것 (NULL = 안 함)
+typedef struct {
+    MemSystem *mem;       // 캐시 태그 warming
+    BranchPredictor *bp;  // 분기 예측기 warming (btb 이상)
+    uint16_t fetchLine;   // 명령어가 들어가는 L1 라인 크기 (initWarming()이 채움)
+    bool unified;         // 데이터 접근도 같은 L1을 씀
+    uint64_t *bbv;        // 기본 블록 벡터 [MEMORY_SIZE]: 블록 시작 PC별 실행한 명령어 수
+    uint16_t blockStart;  // 지금 블록의 시작 PC (JMP 대상, 처음에는 시작 PC)
+    LoopAccel *accel;     // 루프 가속 (mem, bp가 NULL일 때만)
+} FunctionalHooks;
+
+// stepFunctional()의 메모리 접근을 지켜볼 곳 (multicore의 코어별 캐시)
+typedef struct {
+    void *ctx;
+    // 명령어 바이트 [pc, next) fetch (decode 전, 메모리 밖 바이트 포함)
+    void (*fetch)(void *ctx, uint16_t pc, uint16_t next);
+    // 성공한 데이터 읽기/쓰기 (MEM_READ/MEM_WRITE, 넓은 주소 포함), value는 쓰는 값
+    void (*access)(void *ctx, AccessKind kind, uint32_t addr, uint8_t value);
+} MemoryPort;
+
+// warming 훅 설정 (mem, bp는 NULL 가능, 나머지 필드는 0으로)
+void initWarming(FunctionalHooks *hooks, MemSystem *mem, BranchPredictor *bp);
+
+// count개 명령어 실행 (HALT나 오류에서 멈춤), 실행한 명령어 수 반환 (HALT 포함, 오류 난 명령어 제외)
+// vm->running이 true인 상태에서 호출, hooks는 NULL 가능
+uint64_t runFunctional(VM *vm, uint64_t count, FunctionalHooks *hooks);
+
+// 명령어 하나 실행 (runFunctional()과 같은 의미, 훅 없음), 실행했으면 true (HALT 포함, 오류 난 명령어 제외)
+// port는 NULL 가능
+bool stepFunctional(VM *vm, const MemoryPort *port);
+
+void initLoopAccel(LoopAccel *accel);
+
+// 루프 가속 통계 출력 (분석한 몸체가 없으면 한 줄)
+void printLoopAccel(const LoopAccel *accel);
+
+#endif
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "image.h"
+
+_Static_assert(sizeof(ImageHeader) == 32, "ImageHeader layout");
+_Static_assert(sizeof(ImageDecoded) == 8, "ImageDecoded layout");
+
+static uint32_t checksumMemory(const uint8_t *memory)
+{
+    uint32_t h = 2166136261u;
+    for (int addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        h = (h ^ memory[addr]) * 16777619u;
+    }
+    return h;
+}
+
+// 텍스트 로더와 같은 바이트 배치 기준의 명령어 길이
+static uint8_t encodedLength(uint8_t op)
+{
+    switch (op)
+    {
+    case MOV_RR:
+    case MOV_RM:
+    case MOV_MR:
+    case ADD_RR:
+    case SUB_RR:
+        return 3;
+    case JMP:
+        return 2;
+    case MOV_RF:
+    case MOV_FR:
+        return WIDE_INSTR_SIZE;
+    default:
+        return 1;
+    }
+}
+
+// 미리 디코딩한 목록이 memory와 맞는지 확인
+static bool checkDecoded(const ImageDecoded *d, uint32_t count, const uint8_t *memory)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (d[i].pc >= MEMORY_SIZE || d[i].opcode != memory[d[i].pc] || d[i].len != encodedLength(d[i].opcode) ||
+            d[i].len - 1u > sizeof(d[i].operand) || d[i].pc + d[i].len > MEMORY_SIZE)
+        {
+            return false;
+        }
+        for (int b = 1; b < d[i].len; b++)
+        {
+            if (d[i].operand[b - 1] != memory[d[i].pc + b])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ImageStatus loadProgramImage(VM *vm, const char *filename, bool verbose)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        if (verbose)
+            printf("Failed to open file: %s\n", filename);
+        return IMAGE_BAD;
+    }
+
+    // 이미지는 최대 IMAGE_MAX_SIZE라 read 한 번이면 충분 (텍스트 파일인지도 이걸로 판단)
+    union {
+        ImageHeader h;
+        uint8_t bytes[IMAGE_MAX_SIZE + 1];
+    } buf;
+    ssize_t got = read(fd, buf.bytes, sizeof(buf.bytes));
+    close(fd);
+    if (got < (ssize_t)sizeof(ImageHeader) || memcmp(buf.h.magic, IMAGE_MAGIC, 4) != 0)
+    {
+        return IMAGE_NOT_IMAGE;
+    }
+
+    const ImageHeader *h = &buf.h;
+    const uint8_t *memory = buf.bytes + sizeof(ImageHeader);
+    size_t size = (size_t)got;
+    const char *error = NULL;
+    if (h->version != IMAGE_VERSION)
+        error = "unsupported image version";
+    else if (size > IMAGE_MAX_SIZE)
+        error = "file too large";
+    else if (h->memorySize != MEMORY_SIZE || size < sizeof(ImageHeader) + MEMORY_SIZE)
+        error = "memory size mismatch";
+    else if (checksumMemory(memory) != h->checksum)
+        error = "checksum mismatch";
+    else if ((h->flags & IMAGE_HAS_DECODED) &&
+             (h->decodedOffset < sizeof(ImageHeader) + MEMORY_SIZE || h->decodedOffset % _Alignof(ImageDecoded) ||
+              h->decodedOffset > size || h->decodedCount > (size - h->decodedOffset) / sizeof(ImageDecoded) ||
+              !checkDecoded((const ImageDecoded *)(buf.bytes + h->decodedOffset), h->decodedCount, memory)))
+        error = "bad pre-decoded section";
+    else if (h->entryPC >= MEMORY_SIZE)
+        error = "entry PC out of range";
+
+    if (error)
+    {
+        if (verbose)
+            printf("Bad program image %s: %s\n", filename, error);
+        return IMAGE_BAD;
+    }
+
+    memcpy(vm->memory, memory, MEMORY_SIZE);
+    memcpy(vm->cpu.regs, h->regs, NUM_REGS);
+    vm->cpu.PC = h->entryPC;
+
+    if (verbose)
+    {
+        printf("Program image loaded from %s. PC=%u", filename, h->entryPC);
+        if (h->flags & IMAGE_HAS_DECODED)
+            printf(" (%u pre-decoded instructions)", h->decodedCount);
+        printf("\n");
+    }
+    return IMAGE_OK;
+}
+
+bool writeProgramImage(const VM *vm, const char *filename, bool withDecoded)
+{
+    ImageDecoded decoded[MEMORY_SIZE];
+    uint32_t count = 0;
+
+    if (withDecoded)
+    {
+        // entryPC부터 순서대로 훑기 (HALT나 알 수 없는 opcode에서 멈춤)
+        // 목록의 오퍼랜드는 2바이트라 32비트 주소를 가진 MOV_RF/MOV_FR에서도 멈춤
+        uint16_t pc = vm->cpu.PC;
+        while (pc < MEMORY_SIZE)
+        {
+            uint8_t op = vm->memory[pc];
+            uint8_t len = encodedLength(op);
+            if (op >= INVALID || len - 1u > sizeof(decoded[0].operand) || pc + len > MEMORY_SIZE)
+            {
+                break;
+            }
+            ImageDecoded *d = &decoded[count++];
+            memset(d, 0, sizeof(*d));
+            d->pc = pc;
+            d->opcode = op;
+            d->len = len;
+            for (int b = 1; b < len; b++)
+            {
+                d->operand[b - 1] = vm->memory[pc + b];
+            }
+            if (op == HALT)
+            {
+                break;
+            }
+            pc += len;
+        }
+    }
+
+    ImageHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, IMAGE_MAGIC, 4);
+    h.version = IMAGE_VERSION;
+    h.flags = withDecoded ? IMAGE_HAS_DECODED : 0;
+    h.entryPC = vm->cpu.PC;
+    h.memorySize = MEMORY_SIZE;
+    h.checksum = checksumMemory(vm->memory);
+    h.decodedOffset = withDecoded ? sizeof(ImageHeader) + MEMORY_SIZE : 0;
+    h.decodedCount = count;
+    memcpy(h.regs, vm->cpu.regs, NUM_REGS);
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp)
+    {
+        printf("Failed to create %s\n", filename);
+        return false;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(vm->memory, MEMORY_SIZE, 1, fp) == 1 &&
+              (count == 0 || fwrite(decoded, sizeof(ImageDecoded), count, fp) == count);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok)
+    {
+        printf("Failed to write %s\n", filename);
+    }
+    return ok;
+}
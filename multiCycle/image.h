@@ -0,0 +1,61 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include "cpu.h"
+
+/**
+ * 바이너리 프로그램 이미지 (.vmi)
+ * 텍스트 파싱 없이 read 한 번과 memcpy로 VM을 채우기 위한 형식 (리틀 엔디언)
+ *
+ *   [ImageHeader 32바이트][memory MEMORY_SIZE바이트][ImageDecoded x decodedCount (선택)]
+ *
+ * 바이트 배치는 텍스트 로더와 같으므로 singleCycle과 multiCycle이 같은 이미지를 읽음
+ * (명령어 해석만 시뮬레이터마다 다름)
+ */
+
+#define IMAGE_MAGIC "VMIM"
+#define IMAGE_VERSION 1
+
+// ImageHeader.flags
+#define IMAGE_HAS_DECODED 0x0001 // 미리 디코딩한 명령어 목록이 있음
+
+typedef struct {
+    char magic[4];          // "VMIM"
+    uint16_t version;       // IMAGE_VERSION
+    uint16_t flags;
+    uint16_t entryPC;       // 시작 PC
+    uint16_t memorySize;    // MEMORY_SIZE (다르면 거부)
+    uint32_t checksum;      // memory의 FNV-1a
+    uint32_t decodedOffset; // 파일 처음부터의 위치
+    uint32_t decodedCount;
+    uint8_t regs[NUM_REGS]; // 레지스터 초기값
+} ImageHeader;
+
+// 미리 디코딩한 명령어 하나 (entryPC부터 HALT/알 수 없는 opcode까지 순서대로 훑은 결과)
+typedef struct {
+    uint16_t pc;
+    uint8_t opcode;
+    uint8_t len;        // 명령어 바이트 수
+    uint8_t operand[2]; // 오퍼랜드 바이트 (없으면 0)
+    uint8_t reserved[2];
+} ImageDecoded;
+
+// 이미지 파일의 최대 크기 (미리 디코딩한 명령어는 주소마다 하나를 넘지 않음)
+#define IMAGE_MAX_SIZE (sizeof(ImageHeader) + MEMORY_SIZE + MEMORY_SIZE * sizeof(ImageDecoded))
+
+typedef enum {
+    IMAGE_OK,
+    IMAGE_NOT_IMAGE, // magic이 다름 (텍스트 프로그램)
+    IMAGE_BAD        // 열 수 없거나 버전/크기/체크섬 오류
+} ImageStatus;
+
+/**
+ * 이미지를 읽어서 VM에 로드 (memory, regs, PC)
+ * verbose가 false면 아무것도 출력하지 않음 (여러 스레드에서 동시에 호출 가능)
+ */
+ImageStatus loadProgramImage(VM *vm, const char *filename, bool verbose);
+
+// VM의 현재 memory/regs/PC를 이미지로 저장 (withDecoded면 미리 디코딩한 목록 포함)
+bool writeProgramImage(const VM *vm, const char *filename, bool withDecoded);
+
+#endif
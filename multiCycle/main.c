@@ -1,9 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "cpu.h"
-
-// load.c에 있는 함수 (프로그램 로더)
-void loadProgramFromFile(VM *vm, const char *filename);
+#include "pipeline.h"
+#include "cache.h"
+#include "load.h"
+#include "image.h"
+#include "fleet.h"
+#include "ooo.h"
+#include "superscalar.h"
+#include "checkpoint.h"
+#include "debug.h"
+#include "paged.h"
+#include "profile.h"
+#include "trace.h"
+#include "sample.h"
+#include "simpoint.h"
+#include "multicore.h"
 
 // 디버그용: VM 상태 출력
 static void printVMState(const VM *vm)
@@ -25,25 +39,562 @@ static void printVMState(const VM *vm)
     printf("\n\n");
 }
 
+// 성능 카운터 내보내기 (-p 텍스트, -J JSON 파일, "-" = 표준 출력)
+static int exportPerf(const VM *vm, bool text, const char *jsonPath)
+{
+#ifdef PERF_COUNTERS
+    if (text) {
+        printPerfText(stdout, &vm->perf);
+    }
+    if (jsonPath) {
+        FILE *fp = (strcmp(jsonPath, "-") == 0) ? stdout : fopen(jsonPath, "w");
+        if (!fp) {
+            printf("Failed to open %s\n", jsonPath);
+            return 1;
+        }
+        writePerfJson(fp, &vm->perf);
+        if (fp != stdout) {
+            fclose(fp);
+        }
+    }
+#else
+    (void)vm;
+    if (text || jsonPath) {
+        printf("Performance counters are compiled out (rebuild with make PERF=1)\n");
+    }
+#endif
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [-e engine] [-F forwarding] [-b predictor] [-O ooo] [-w width] [-c cache]... [-n maxCycles] [-A bits] [-p] [-J counters.json] [program.txt|program.s|program.vmi]\n", prog);
+    printf("       %s -o program.vmi [program.txt|program.s]\n", prog);
+    printf("       %s -d [-n maxInstructions] [program]\n", prog);
+    printf("       %s -P exact|every:N|timer:US [-G stacks.folded] [-c cache]... [-n maxCycles] [program]\n", prog);
+    printf("       %s -T trace.bin [-c cache]... [-n maxCycles] [program] | -X trace.bin [-n maxRecords]\n", prog);
+    printf("       %s -S N:M[:W] [-W] [-L] [-e engine] [-b predictor] [-c cache]... [-n maxInstructions] [program]\n", prog);
+    printf("       %s -B simpoints.txt [-I N[:W]] [-K k] [-C checkpoints] [-L] [-n maxInstructions] [program]\n", prog);
+    printf("       %s -Y simpoints.txt [-R checkpoints | -W] [-L] [-e engine] [-b predictor] [-c cache]... [program]\n", prog);
+    printf("       %s [-C checkpoints] [-k interval] [-R checkpoints[@index]] [-c cache]... [-n maxCycles] [program]\n", prog);
+    printf("       %s -M cores[:key=value,...] [-n maxCycles] [program...]\n", prog);
+    printf("       %s -f manifest|dir [-j threads] [-e engine] [-F forwarding] [-b predictor] [-O ooo] [-w width] [-c cache]... [-n maxCycles]\n", prog);
+    printf("  -e  실행 엔진: multicycle (기본, 명령어당 5클록), pipeline (5단 파이프라인), ooo (비순차 실행), superscalar (순차 N-wide)\n");
+    printf("  -F  pipeline 포워딩: full (기본), ex (EX->EX만), mem (MEM->EX만), none\n");
+    printf("  -b  pipeline 분기 예측기: none (기본), static, btb, bimodal, gshare, tage\n");
+    printf("  -O  ooo 설정: key=value,... (width rob rs lsq alus ports alu load, 기본 width=4,rob=64,rs=32,lsq=16,alus=4,ports=2,alu=1,load=2)\n");
+    printf("  -w  superscalar 폭과 설정: N[:key=value,...] (key = fetch ports alu load, 기본 2:fetch=8,ports=1,alu=1,load=2)\n");
+    printf("  -c  캐시 계층 (여러 번 지정): level[:key=value,...]\n");
+    printf("      level = l1 (통합) | l1i | l1d (분리) | l2 | mem, key = size ways line repl(lru|plru|random) write(wb|wt) lat\n");
+    printf("      예) -c l1i:size=32 -c l1d:ways=1,write=wt -c l2:lat=8 -c mem:lat=50\n");
+    printf("  -n  최대 클록 수 (0 = 제한 없음)\n");
+    printf("  -A  MOV_RF/MOV_FR 주소 폭: 16 또는 32 (기본 %d, %d 이상 주소는 4KiB 페이지를 처음 쓸 때 할당, 캐시 없음)\n",
+           WIDE_ADDR_BITS, MEMORY_SIZE);
+    printf("  -p  종료 시 성능 카운터 출력\n");
+    printf("  -J  종료 시 성능 카운터를 JSON으로 저장 (- = 표준 출력)\n");
+    printf("  -o  실행하지 않고 바이너리 이미지로 변환해서 저장 (미리 디코딩한 명령어 목록 포함)\n");
+    printf("  -d  역실행 디버거: 표준 입력으로 step/back/continue/rc/who/goto 명령 (명령어 단위, multicycle 엔진, help로 목록)\n");
+    printf("  -C  실행하면서 증분 체크포인트를 파일에 기록 (시작, -k 클록마다, 끝, multicycle 엔진만)\n");
+    printf("  -k  체크포인트 간격 (클록 수, 0 = 시작과 끝만)\n");
+    printf("  -R  프로그램 대신 체크포인트 파일에서 이어서 실행 (@index로 중간 체크포인트 선택, 기본 마지막)\n");
+    printf("  -P  PC별/단계별 클록 프로파일: exact (클록마다), every:N (평균 N 클록마다 샘플), timer:US (CPU 시간 US마다 샘플)\n");
+    printf("  -G  프로파일을 flamegraph용 collapsed stack으로 저장 (- = 표준 출력, -P 없으면 exact)\n");
+    printf("  -T  명령어마다 PC, opcode, 쓴 레지스터, 메모리 주소/값, 클록 수를 압축 트레이스로 기록 (백그라운드 스레드가 저장)\n");
+    printf("  -X  실행하지 않고 -T로 기록한 트레이스를 텍스트로 출력 (-n = 최대 레코드 수)\n");
+    printf("  -S  샘플링 시뮬레이션: 명령어 N개 빨리 감기(클록 없음), W개 상세 실행, M개 측정을 반복해서 전체 클록 수를 추정\n");
+    printf("  -W  빨리 감는 동안에도 캐시 태그와 분기 예측기를 갱신 (-S와 함께)\n");
+    printf("  -B  기능 실행으로 -I 구간마다 기본 블록 벡터를 모아 k-means로 대표 구간과 가중치를 골라 저장 (-C면 구간마다 체크포인트)\n");
+    printf("  -I  -B 구간 길이와 대표 구간 앞 warm-up (명령어 수, 기본 100000:0)\n");
+    printf("  -K  -B 최대 클러스터 수 (기본 10, 최대 %d)\n", SIMPOINT_MAX_K);
+    printf("  -Y  -B로 고른 대표 구간만 상세 실행해서 전체 클록 수 추정 (-R이면 -B -C 체크포인트에서 복원)\n");
+    printf("  -L  빨리 감기(-S, -B, -Y)에서 ADD/SUB/MOV만 하는 루프를 mod 256 아핀 변환으로 건너뛰지 않음 (기본은 건너뜀)\n");
+    printf("  -M  멀티코어: 코어 K개가 메모리를 공유하고 L1을 MESI로 맞춤, 프로그램 1개(모든 코어) 또는 K개\n");
+    printf("      key = quantum (barrier 사이 클록) threads (호스트 스레드) size ways line hit bus mem\n");
+    printf("      (기본 2:quantum=1000,size=64,ways=2,line=8,hit=1,bus=10,mem=30)\n");
+    printf("  -f  fleet 모드: 매니페스트(한 줄에 경로 하나) 또는 디렉터리의 프로그램을 모두 실행\n");
+    printf("  -j  fleet 작업 스레드 수 (기본 코어 수)\n");
+}
+
+// -F 옵션 해석
+static bool parseForwarding(const char *name, PipelineConfig *cfg)
+{
+    if (strcmp(name, "full") == 0) {
+        cfg->forwardExEx = cfg->forwardMemEx = true;
+    } else if (strcmp(name, "ex") == 0) {
+        cfg->forwardExEx = true;
+        cfg->forwardMemEx = false;
+    } else if (strcmp(name, "mem") == 0) {
+        cfg->forwardExEx = false;
+        cfg->forwardMemEx = true;
+    } else if (strcmp(name, "none") == 0) {
+        cfg->forwardExEx = cfg->forwardMemEx = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 체크포인트를 찍으면서 실행: 시작 상태, every 클록마다, 마지막 상태
+// (파이프라인 엔진은 단계 사이 상태가 VM 밖에 있어서 multicycle만)
+static bool runCheckpointed(VM *vm, uint64_t maxCycles, const char *path, uint64_t every, uint64_t startCycles,
+                            uint64_t *cycles)
+{
+    CheckpointLog log;
+    if (!openCheckpointLog(&log, path) || !saveCheckpoint(&log, vm, startCycles)) {
+        closeCheckpointLog(&log);
+        return false;
+    }
+    bool ok = true;
+    *cycles = 0;
+    do {
+        uint64_t chunk = every;
+        if (maxCycles && (chunk == 0 || maxCycles - *cycles < chunk)) {
+            chunk = maxCycles - *cycles;
+        }
+        *cycles += runVMFor(vm, chunk);
+        ok = saveCheckpoint(&log, vm, startCycles + *cycles);
+    } while (ok && vm->running && (maxCycles == 0 || *cycles < maxCycles));
+
+    printf("%u checkpoints written to %s (%llu lines of %d bytes)\n", log.count, path,
+           (unsigned long long)log.linesWritten, DIRTY_LINE_SIZE);
+    closeCheckpointLog(&log);
+    return ok;
+}
+
+// -B: 대표 구간을 골라 out에 저장 (checkpoints가 있으면 구간마다 체크포인트)
+// -Y: in의 대표 구간만 상세 실행 (checkpoints가 있으면 프로그램 대신 체크포인트에서 복원)
+static int runSimPoints(VM *vm, const char *filename, const char *out, const char *in, const SimPointConfig *spc,
+                        const SampleConfig *cfg, const char *checkpoints, uint64_t maxInstructions)
+{
+    SimPointSet set;
+    if (out) {
+        if (!loadProgramFromFile(vm, filename) || !profileSimPoints(vm, maxInstructions, spc, &set, checkpoints)) {
+            return 1;
+        }
+        printSimPoints(&set);
+        if (spc->accel) {
+            printLoopAccel(spc->accel);
+        }
+        if (!writeSimPoints(out, &set)) {
+            return 1;
+        }
+        printf("SimPoints written to %s\n", out);
+        return 0;
+    }
+
+    SimPointResult res;
+    if (!readSimPoints(in, &set) || (!checkpoints && !loadProgramFromFile(vm, filename)) ||
+        !simulateSimPoints(vm, &set, cfg, checkpoints, &res)) {
+        return 1;
+    }
+    if (cfg->pipelined) {
+        printPipelineStats(&res.pipe);
+    }
+    if (vm->mem) {
+        printMemStats(vm->mem);
+    }
+    printSimPointResult(&set, &res);
+    if (cfg->accel) {
+        printLoopAccel(cfg->accel);
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
+    FleetOptions fleet = {0};
+    const char *fleetSource = NULL;
+    bool perfText = false;
+    const char *perfJson = NULL;
+    const char *imageOut = NULL;
+    const char *checkpointOut = NULL;
+    uint64_t checkpointEvery = 0;
+    const char *resumeFrom = NULL;
+    bool debug = false;
+    Profile profile = {.mode = PROFILE_EXACT};
+    bool profiling = false;
+    const char *stacksOut = NULL;
+    const char *traceOut = NULL;
+    const char *traceIn = NULL;
+    SampleConfig sample = {0};
+    bool sampling = false;
+    SimPointConfig simpoint = {.interval = 100000, .warmup = 0, .maxK = 10};
+    const char *simpointOut = NULL;
+    const char *simpointIn = NULL;
+    static LoopAccel accel;
+    bool accelerate = true;
+    MulticoreConfig multicore;
+    bool multicoreMode = false;
+    initMulticoreConfig(&multicore);
+    initPipelineConfig(&fleet.pipe);
+    initOooConfig(&fleet.ooo);
+    initSuperscalarConfig(&fleet.wide);
+    initMemConfig(&fleet.mem);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "e:F:b:O:w:c:f:j:n:A:pJ:o:C:k:R:P:G:T:X:S:WB:I:K:Y:LM:dh")) != -1) {
+        switch (opt) {
+        case 'e':
+            fleet.pipelined = fleet.outOfOrder = fleet.superscalar = false;
+            if (strcmp(optarg, "pipeline") == 0) {
+                fleet.pipelined = true;
+            } else if (strcmp(optarg, "ooo") == 0) {
+                fleet.outOfOrder = true;
+            } else if (strcmp(optarg, "superscalar") == 0) {
+                fleet.superscalar = true;
+            } else if (strcmp(optarg, "multicycle") != 0) {
+                printf("Unknown engine: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'F':
+            if (!parseForwarding(optarg, &fleet.pipe)) {
+                printf("Unknown forwarding: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'b':
+            if (!parsePredictor(optarg, &fleet.pipe.predictor)) {
+                printf("Unknown predictor: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'O':
+            if (!parseOooOption(&fleet.ooo, optarg)) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'w':
+            if (!parseSuperscalarOption(&fleet.wide, optarg)) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'c':
+            if (!parseCacheOption(&fleet.mem, optarg)) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'f':
+            fleetSource = optarg;
+            break;
+        case 'j':
+            fleet.threads = atoi(optarg);
+            break;
+        case 'n':
+            fleet.maxCycles = strtoull(optarg, NULL, 0);
+            break;
+        case 'A': {
+            int bits = atoi(optarg);
+            if (bits != 16 && bits != 32) {
+                printf("Address width must be 16 or 32: %s\n", optarg);
+                return 1;
+            }
+            fleet.addrBits = (uint8_t)bits;
+            break;
+        }
+        case 'p':
+            perfText = true;
+            break;
+        case 'J':
+            perfJson = optarg;
+            break;
+        case 'o':
+            imageOut = optarg;
+            break;
+        case 'C':
+            checkpointOut = optarg;
+            break;
+        case 'k':
+            checkpointEvery = strtoull(optarg, NULL, 0);
+            break;
+        case 'R':
+            resumeFrom = optarg;
+            break;
+        case 'd':
+            debug = true;
+            break;
+        case 'P':
+            if (!parseProfileSpec(&profile, optarg)) {
+                printf("Unknown profile mode: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            profiling = true;
+            break;
+        case 'G':
+            stacksOut = optarg;
+            profiling = true;
+            break;
+        case 'T':
+            traceOut = optarg;
+            break;
+        case 'X':
+            traceIn = optarg;
+            break;
+        case 'S':
+            if (!parseSampleSpec(&sample, optarg)) {
+                printf("Invalid sample interval: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            sampling = true;
+            break;
+        case 'W':
+            sample.warming = true;
+            break;
+        case 'B':
+            simpointOut = optarg;
+            break;
+        case 'Y':
+            simpointIn = optarg;
+            break;
+        case 'I':
+            if (!parseIntervalSpec(&simpoint, optarg)) {
+                printf("Invalid interval: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'K':
+            simpoint.maxK = atoi(optarg);
+            if (simpoint.maxK < 1 || simpoint.maxK > SIMPOINT_MAX_K) {
+                printf("Cluster count must be 1..%d: %s\n", SIMPOINT_MAX_K, optarg);
+                return 1;
+            }
+            break;
+        case 'L':
+            accelerate = false;
+            break;
+        case 'M':
+            if (!parseMulticoreOption(&multicore, optarg)) {
+                usage(argv[0]);
+                return 1;
+            }
+            multicoreMode = true;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    // 루프 가속은 빨리 감기(-S, -B, -Y)에서만 쓰임
+    initLoopAccel(&accel);
+    if (accelerate) {
+        sample.accel = simpoint.accel = &accel;
+    }
+
+    if (traceIn) {
+        return dumpTrace(traceIn, stdout, fleet.maxCycles) ? 0 : 1;
+    }
+
+    // 캐시 설정 검사 (fleet 모드도 여기서 한 번)
+    static MemSystem mem;
+    if (fleet.mem.enabled && !initMemSystem(&mem, &fleet.mem)) {
+        return 1;
+    }
+
+    if (fleetSource) {
+        return runFleet(fleetSource, &fleet);
+    }
+
+    // 멀티코어는 자기 코어 모델과 L1(MESI)로 실행, 나머지 인자는 모두 프로그램
+    if (multicoreMode) {
+        if (fleet.pipelined || fleet.outOfOrder || fleet.superscalar || fleet.mem.enabled || checkpointOut ||
+            resumeFrom || debug || profiling || traceOut || sampling || simpointOut || simpointIn || imageOut) {
+            printf("Multi-core mode cannot be combined with -e, -c, -C, -R, -d, -P, -T, -S, -B, -Y or -o\n");
+            return 1;
+        }
+        static char *defaultProgram[] = {"program.txt"};
+        if (optind < argc) {
+            return runMulticore(&multicore, argv + optind, argc - optind, fleet.maxCycles);
+        }
+        return runMulticore(&multicore, defaultProgram, 1, fleet.maxCycles);
+    }
+
+    if ((fleet.pipelined || fleet.outOfOrder || fleet.superscalar) && (checkpointOut || resumeFrom) && !simpointIn) {
+        printf("Checkpoints need -e multicycle (pipeline latches are not part of the VM state)\n");
+        return 1;
+    }
+    // 샘플링과 SimPoint의 상세 실행은 multicycle 또는 pipeline
+    if ((fleet.outOfOrder || fleet.superscalar) && (sampling || simpointIn)) {
+        printf("Sampled simulation needs -e multicycle or -e pipeline\n");
+        return 1;
+    }
+    // 캐시 태그는 되돌릴 수 없으므로 디버거는 지연 없는 메모리로만
+    if (debug && (fleet.pipelined || fleet.outOfOrder || fleet.superscalar || fleet.mem.enabled)) {
+        printf("The debugger needs -e multicycle without -c\n");
+        return 1;
+    }
+
+    // 프로파일러는 runVMFor() 위에서 PC와 단계를 셈
+    if (profiling && (fleet.pipelined || fleet.outOfOrder || fleet.superscalar || checkpointOut)) {
+        printf("The profiler needs -e multicycle without -C\n");
+        return 1;
+    }
+    // 트레이스도 runVMFor()와 같은 루프에서 명령어가 끝날 때마다 기록
+    if (traceOut && (fleet.pipelined || fleet.outOfOrder || fleet.superscalar || checkpointOut || profiling)) {
+        printf("The tracer needs -e multicycle without -C or -P\n");
+        return 1;
+    }
+
+    // 샘플링은 명령어 단위로 엔진을 바꿔 가며 실행 (-n은 명령어 수)
+    if (sampling && (checkpointOut || profiling || traceOut || debug)) {
+        printf("Sampled simulation cannot be combined with -C, -P, -T or -d\n");
+        return 1;
+    }
+
+    // SimPoint: -C/-R은 대표 구간 체크포인트 파일
+    bool simpointMode = simpointOut || simpointIn;
+    if (simpointMode && ((simpointOut && simpointIn) || sampling || profiling || traceOut || debug || imageOut ||
+                         (simpointOut && resumeFrom) || (simpointIn && checkpointOut))) {
+        printf("Use -B [-C] or -Y [-R] alone (not with -S, -P, -T, -d or -o)\n");
+        return 1;
+    }
+
     const char *filename = "program.txt";
-    if (argc > 1) {
-        filename = argv[1];
+    if (optind < argc) {
+        filename = argv[optind];
     }
 
     VM vm;
     initVM(&vm);
+    vm.addrBits = fleet.addrBits;
+    if (fleet.mem.enabled) {
+        vm.mem = &mem;
+    }
+
+    if (simpointMode) {
+        sample.pipelined = fleet.pipelined;
+        sample.pipe = fleet.pipe;
+        int status = runSimPoints(&vm, filename, simpointOut, simpointIn, &simpoint, &sample,
+                                  simpointOut ? checkpointOut : resumeFrom, fleet.maxCycles);
+        if (simpointIn && status == 0) {
+            status = exportPerf(&vm, perfText, perfJson);
+        }
+        freePagedMemory(&vm);
+        return status;
+    }
+
+    // 텍스트 파일 → 메모리 로드, -R이면 체크포인트에서 복원 (단계, 현재 명령어, ALU 결과 포함)
+    uint64_t startCycles = 0;
+    if (resumeFrom ? !resumeCheckpointSpec(&vm, resumeFrom, &startCycles) : !loadProgramFromFile(&vm, filename)) {
+        return 1;
+    }
 
-    // 텍스트 파일 → 메모리 로드
-    loadProgramFromFile(&vm, filename);
+    if (imageOut) {
+        if (!writeProgramImage(&vm, imageOut, true)) {
+            return 1;
+        }
+        printf("Program image written to %s\n", imageOut);
+        return 0;
+    }
+
+    // HALT나 오류 뒤에 찍은 체크포인트는 실행하지 않고 마지막 상태만 출력
+    if (resumeFrom && !vm.running) {
+        printf("VM stopped.\n");
+        printVMState(&vm);
+        freePagedMemory(&vm);
+        return 0;
+    }
+
+    if (debug) {
+        return runDebugger(&vm, fleet.maxCycles);
+    }
 
     // 다중 사이클 VM 실행
-    runVM(&vm);
+    uint64_t cycles;
+    bool traceOk = true;
+    PipelineStats stats = {0};
+    OooStats oooStats = {0};
+    SuperscalarStats wideStats = {0};
+    SampleStats sampled;
+    if (sampling) {
+        sample.pipelined = fleet.pipelined;
+        sample.pipe = fleet.pipe;
+        uint64_t executed = runSampled(&vm, fleet.maxCycles, &sample, &sampled);
+        if (vm.running) {
+            printf("VM paused after %llu instructions (instruction limit).\n", (unsigned long long)executed);
+        } else {
+            printf("VM stopped.\n");
+        }
+        printVMState(&vm);
+        if (fleet.pipelined) {
+            printPipelineStats(&sampled.pipe);
+        }
+        if (vm.mem) {
+            printMemStats(vm.mem);
+        }
+        printPagedStats(&vm);
+        printSampleReport(&sample, &sampled);
+        if (sample.accel) {
+            printLoopAccel(sample.accel);
+        }
+        int status = exportPerf(&vm, perfText, perfJson);
+        freePagedMemory(&vm);
+        return status;
+    } else if (fleet.pipelined) {
+        cycles = runPipeline(&vm, fleet.maxCycles, &fleet.pipe, &stats);
+    } else if (fleet.outOfOrder) {
+        cycles = runOutOfOrder(&vm, fleet.maxCycles, &fleet.ooo, &oooStats);
+    } else if (fleet.superscalar) {
+        cycles = runSuperscalar(&vm, fleet.maxCycles, &fleet.wide, &wideStats);
+    } else if (checkpointOut) {
+        if (!runCheckpointed(&vm, fleet.maxCycles, checkpointOut, checkpointEvery, startCycles, &cycles)) {
+            return 1;
+        }
+    } else if (profiling) {
+        cycles = runProfiled(&vm, fleet.maxCycles, &profile);
+    } else if (traceOut) {
+        TraceWriter *trace = openTrace(traceOut, startCycles);
+        if (!trace) {
+            return 1;
+        }
+        cycles = runTraced(&vm, fleet.maxCycles, trace);
+        traceOk = closeTrace(trace);
+    } else {
+        cycles = runVMFor(&vm, fleet.maxCycles);
+    }
+    if (vm.running) {
+        printf("VM paused after %llu cycles (cycle limit).\n", (unsigned long long)(startCycles + cycles));
+    } else {
+        printf("VM stopped.\n");
+    }
 
     // 실행 종료 후 전체 상태 출력
     printVMState(&vm);
 
-    return 0;
+    if (fleet.pipelined) {
+        printPipelineStats(&stats);
+    }
+    if (fleet.outOfOrder) {
+        printOooStats(&fleet.ooo, &oooStats);
+    }
+    if (fleet.superscalar) {
+        printSuperscalarStats(&fleet.wide, &wideStats);
+    }
+    if (vm.mem) {
+        printMemStats(vm.mem);
+    }
+    printPagedStats(&vm);
+
+    int status = traceOk ? 0 : 1;
+    if (profiling) {
+        // -R이면 소스 파일이 없으므로 PC별 목록만
+        const char *source = resumeFrom ? NULL : filename;
+        printProfileReport(&profile, &vm, source);
+        if (stacksOut && !writeCollapsedStacks(&profile, &vm, source, stacksOut)) {
+            status = 1;
+        }
+    }
+
+    status |= exportPerf(&vm, perfText, perfJson);
+    freePagedMemory(&vm);
+    return status;
 }
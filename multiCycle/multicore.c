@@ -0,0 +1,798 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "multicore.h"
+#include "functional.h"
+#include "cache.h"
+#include "load.h"
+#include "paged.h"
+
+/**
+ * 멀티코어 + MESI (multicore.h)
+ * 코어는 quantum 동안 자기 로그에 store와 버스 요청을 (시작 클록, 종류, 블록/주소) 순서로 남기고
+ * barrier 뒤 스레드 0이 모든 로그를 (클록, 코어 번호) 순서로 합쳐서 적용한다.
+ * 로그를 적용하는 순서가 스레드 배치와 상관없으므로 스레드 수를 바꿔도 결과가 같다.
+ */
+
+typedef enum {
+    MESI_I,
+    MESI_S,
+    MESI_E,
+    MESI_M
+} MesiState;
+
+// 로그 항목 종류
+typedef enum {
+    LOG_BUS_RD,   // 읽기 미스: 다른 코어의 M/E는 S로
+    LOG_BUS_RDX,  // 쓰기 미스: 다른 코어는 I로
+    LOG_BUS_UPGR, // S에 쓰기: 다른 코어는 I로
+    LOG_SILENT,   // E에 쓰기 (버스 없이 M), 같은 quantum에 다른 코어가 가져갔으면 upgrade로 바꿈
+    LOG_STORE     // 공유 메모리 값
+} LogKind;
+
+typedef struct {
+    uint64_t cycle;
+    uint16_t index; // 버스 요청은 블록 번호, store는 주소
+    uint8_t kind;
+    uint8_t value;
+} LogEntry;
+
+typedef struct {
+    uint8_t state;
+    uint16_t block;
+    uint64_t lastUse;
+    uint64_t since; // 마지막으로 라인을 받거나 M이 된 클록 (barrier에서 그 뒤 요청만 이 라인에 영향)
+} MesiLine;
+
+typedef struct {
+    uint64_t accesses;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t busRd;
+    uint64_t busRdX;
+    uint64_t busUpgr;     // S -> M (E -> M이었는데 barrier에서 다른 코어가 가진 것을 알게 된 것 포함)
+    uint64_t fromCache;   // 미스를 다른 L1에서 받음
+    uint64_t fromMemory;
+    uint64_t invalidated; // 다른 코어 요청으로 I가 된 라인
+    uint64_t downgraded;  // 다른 코어의 읽기로 M/E -> S
+    uint64_t writebacks;  // M 라인을 메모리에 씀 (교체, 다른 코어의 읽기)
+    uint64_t stallCycles; // 1클록 초과분
+} CoreStats;
+
+// 코어 하나 (스레드마다 다른 코어를 만지므로 false sharing을 막기 위해 캐시 라인 정렬)
+typedef struct {
+    VM vm; // regs/PC/running, memory는 quantum 동안의 자기 view (공유 메모리 + 자기 store)
+    uint8_t id;
+    uint64_t cycle;   // 다음 명령어를 시작할 클록
+    uint64_t retired; // HALT 포함
+    MesiLine lines[CACHE_MAX_LINES]; // [set * ways + way]
+    uint64_t useClock;
+    LogEntry *log;
+    size_t logCount;
+    size_t logCap;
+    bool logFailed;
+    CoreStats stats;
+} __attribute__((aligned(64))) Core;
+
+typedef struct {
+    const MulticoreConfig *cfg;
+    Core *cores;
+    int count;
+    int threads;
+    uint16_t sets;
+    uint8_t memory[MEMORY_SIZE];   // barrier에서 맞춘 공유 메모리
+    uint16_t owners[MEMORY_SIZE];  // quantum 시작 때 블록별로 라인을 가진 코어 (비트)
+    uint64_t limit;                // 최대 클록 (0 = 없음)
+    uint64_t quantumEnd;
+    uint64_t quanta;
+    bool done;
+    bool failed;
+    pthread_barrier_t barrier;
+} Multicore;
+
+typedef struct {
+    Multicore *mc;
+    int id;
+} HostThread;
+
+void initMulticoreConfig(MulticoreConfig *cfg)
+{
+    cfg->cores = 2;
+    cfg->threads = 0;
+    cfg->quantum = 1000;
+    cfg->size = 64;
+    cfg->ways = 2;
+    cfg->lineSize = 8;
+    cfg->hitLatency = 1;
+    cfg->busLatency = 10;
+    cfg->memLatency = 30;
+}
+
+static bool parseValue(const char *s, uint16_t *out)
+{
+    char *end;
+    unsigned long v = strtoul(s, &end, 0);
+    if (*s == '\0' || *end != '\0' || v == 0 || v > 0xFFFF)
+    {
+        return false;
+    }
+    *out = (uint16_t)v;
+    return true;
+}
+
+static bool parseMulticoreKey(MulticoreConfig *cfg, const char *key, const char *value)
+{
+    if (strcmp(key, "quantum") == 0)
+    {
+        char *end;
+        unsigned long v = strtoul(value, &end, 0);
+        cfg->quantum = (uint32_t)v;
+        return *value != '\0' && *end == '\0' && v > 0 && v <= 0xFFFFFFFFul;
+    }
+    if (strcmp(key, "threads") == 0)
+        return parseValue(value, &cfg->threads);
+    if (strcmp(key, "size") == 0)
+        return parseValue(value, &cfg->size);
+    if (strcmp(key, "ways") == 0)
+        return parseValue(value, &cfg->ways);
+    if (strcmp(key, "line") == 0)
+        return parseValue(value, &cfg->lineSize);
+    if (strcmp(key, "hit") == 0)
+        return parseValue(value, &cfg->hitLatency);
+    if (strcmp(key, "bus") == 0)
+        return parseValue(value, &cfg->busLatency);
+    if (strcmp(key, "mem") == 0)
+        return parseValue(value, &cfg->memLatency);
+    return false;
+}
+
+bool parseMulticoreOption(MulticoreConfig *cfg, const char *spec)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    char *params = strchr(buf, ':');
+    if (params)
+    {
+        *params++ = '\0';
+    }
+    if (!parseValue(buf, &cfg->cores) || cfg->cores > MULTICORE_MAX_CORES)
+    {
+        printf("Core count must be 1..%d: %s\n", MULTICORE_MAX_CORES, buf);
+        return false;
+    }
+
+    char *save = NULL;
+    for (char *kv = params ? strtok_r(params, ",", &save) : NULL; kv; kv = strtok_r(NULL, ",", &save))
+    {
+        char *value = strchr(kv, '=');
+        if (!value)
+        {
+            printf("Bad multi-core parameter: %s\n", kv);
+            return false;
+        }
+        *value++ = '\0';
+        if (!parseMulticoreKey(cfg, kv, value))
+        {
+            printf("Bad multi-core parameter: %s=%s\n", kv, value);
+            return false;
+        }
+    }
+
+    uint16_t line = cfg->lineSize;
+    if ((line & (line - 1)) != 0 || cfg->size > MEMORY_SIZE || cfg->size % (line * cfg->ways) != 0)
+    {
+        printf("L1 needs a power-of-two line and size (<= %d) that is a multiple of line x ways\n", MEMORY_SIZE);
+        return false;
+    }
+    return true;
+}
+
+/*  -------------------------------------
+        L1 (MESI)
+    -------------------------------------
+*/
+
+static MesiLine *findLine(const Multicore *mc, Core *c, uint16_t block)
+{
+    uint16_t ways = mc->cfg->ways;
+    MesiLine *set = &c->lines[(block % mc->sets) * ways];
+    for (uint16_t w = 0; w < ways; w++)
+    {
+        if (set[w].state != MESI_I && set[w].block == block)
+        {
+            return &set[w];
+        }
+    }
+    return NULL;
+}
+
+// 빈 라인, 없으면 LRU 라인을 내보냄 (M이면 writeback, 쓰기 버퍼가 있다고 보고 기다리지 않음)
+static MesiLine *replaceLine(const Multicore *mc, Core *c, uint16_t block)
+{
+    uint16_t ways = mc->cfg->ways;
+    MesiLine *set = &c->lines[(block % mc->sets) * ways];
+    MesiLine *victim = &set[0];
+    for (uint16_t w = 0; w < ways; w++)
+    {
+        if (set[w].state == MESI_I)
+        {
+            victim = &set[w];
+            break;
+        }
+        if (set[w].lastUse < victim->lastUse)
+        {
+            victim = &set[w];
+        }
+    }
+    if (victim->state == MESI_M)
+    {
+        c->stats.writebacks++;
+    }
+    victim->block = block;
+    return victim;
+}
+
+static void appendLog(Core *c, LogKind kind, uint16_t index, uint8_t value)
+{
+    if (c->logCount == c->logCap)
+    {
+        size_t cap = c->logCap ? c->logCap * 2 : 1024;
+        LogEntry *grown = realloc(c->log, cap * sizeof(LogEntry));
+        if (!grown)
+        {
+            c->logFailed = true;
+            c->vm.running = false;
+            return;
+        }
+        c->log = grown;
+        c->logCap = cap;
+    }
+    c->log[c->logCount++] = (LogEntry){.cycle = c->cycle, .index = index, .kind = kind, .value = value};
+}
+
+// addr 접근 하나, 걸린 클록 수 반환
+static uint32_t accessLine(const Multicore *mc, Core *c, bool write, uint16_t addr)
+{
+    const MulticoreConfig *cfg = mc->cfg;
+    uint16_t block = addr / cfg->lineSize;
+    c->stats.accesses++;
+
+    MesiLine *line = findLine(mc, c, block);
+    if (line)
+    {
+        c->stats.hits++;
+        line->lastUse = ++c->useClock;
+        if (!write || line->state == MESI_M)
+        {
+            return cfg->hitLatency;
+        }
+        line->since = c->cycle;
+        if (line->state == MESI_E)
+        {
+            line->state = MESI_M;
+            appendLog(c, LOG_SILENT, block, 0);
+            return cfg->hitLatency;
+        }
+        // S -> M: 다른 코어의 복사본을 무효화할 때까지
+        line->state = MESI_M;
+        c->stats.busUpgr++;
+        appendLog(c, LOG_BUS_UPGR, block, 0);
+        return cfg->hitLatency + cfg->busLatency;
+    }
+
+    c->stats.misses++;
+    bool shared = (mc->owners[block] & ~(1u << c->id)) != 0;
+    line = replaceLine(mc, c, block);
+    line->lastUse = ++c->useClock;
+    line->since = c->cycle;
+    if (write)
+    {
+        line->state = MESI_M;
+        c->stats.busRdX++;
+        appendLog(c, LOG_BUS_RDX, block, 0);
+    }
+    else
+    {
+        line->state = shared ? MESI_S : MESI_E;
+        c->stats.busRd++;
+        appendLog(c, LOG_BUS_RD, block, 0);
+    }
+    if (shared)
+    {
+        c->stats.fromCache++;
+        return cfg->hitLatency + cfg->busLatency;
+    }
+    c->stats.fromMemory++;
+    return cfg->hitLatency + cfg->memLatency;
+}
+
+/*  -------------------------------------
+        코어 실행
+    -------------------------------------
+*/
+
+// stepFunctional()에 넘기는 코어의 메모리 port
+typedef struct {
+    const Multicore *mc;
+    Core *core;
+    uint32_t cycles; // 1 + 캐시 접근마다 1클록 초과분
+} CorePort;
+
+// 명령어 바이트가 걸친 라인마다 (메모리 밖 바이트는 제외)
+static void fetchCore(void *ctx, uint16_t pc, uint16_t next)
+{
+    CorePort *p = ctx;
+    uint16_t lineSize = p->mc->cfg->lineSize;
+    uint16_t last = (next <= MEMORY_SIZE ? next : MEMORY_SIZE) - 1;
+    for (uint16_t block = pc / lineSize; block <= last / lineSize; block++)
+    {
+        p->cycles += accessLine(p->mc, p->core, false, block * lineSize) - 1;
+    }
+}
+
+// 넓은 주소: MEMORY_SIZE 미만은 공유 메모리, 그 위는 코어마다 따로 (캐시 없이 메모리 지연)
+// 공유 메모리 쓰기는 자기 view에 바로 쓰이고, barrier에서 합칠 수 있게 로그에 남김
+static void accessCore(void *ctx, AccessKind kind, uint32_t addr, uint8_t value)
+{
+    CorePort *p = ctx;
+    if (addr >= MEMORY_SIZE)
+    {
+        p->cycles += p->mc->cfg->memLatency - 1;
+        return;
+    }
+    p->cycles += accessLine(p->mc, p->core, kind == MEM_WRITE, (uint16_t)addr) - 1;
+    if (kind == MEM_WRITE)
+    {
+        appendLog(p->core, LOG_STORE, (uint16_t)addr, value);
+    }
+}
+
+// 명령어 하나 실행 (기능 실행 코어), 걸린 클록 수 반환
+static uint32_t stepCore(const Multicore *mc, Core *c)
+{
+    CorePort port = {.mc = mc, .core = c, .cycles = 1};
+    const MemoryPort mp = {.ctx = &port, .fetch = fetchCore, .access = accessCore};
+    c->retired += stepFunctional(&c->vm, &mp);
+    c->stats.stallCycles += port.cycles - 1;
+    return port.cycles;
+}
+
+// quantum 하나: 다음 명령어 시작 클록이 end 전이면 계속 (긴 명령어는 end를 넘어서 끝날 수 있음)
+static void runQuantum(const Multicore *mc, Core *c, uint64_t end)
+{
+    while (c->vm.running && c->cycle < end)
+    {
+        uint32_t cycles = stepCore(mc, c);
+        c->cycle += cycles;
+    }
+}
+
+/*  -------------------------------------
+        barrier: 로그 합치기
+    -------------------------------------
+*/
+
+// 버스 요청 하나를 다른 코어의 L1에 적용
+// 읽기는 M/E를 S로 (M은 writeback), 쓰기는 I로, E에 조용히 쓴 것은 그 사이 다른 코어가 가져갔으면 upgrade로 셈
+static void applyBus(Multicore *mc, int from, const LogEntry *e)
+{
+    Core *requester = &mc->cores[from];
+    bool shared = false;
+    for (int i = 0; i < mc->count; i++)
+    {
+        Core *c = &mc->cores[i];
+        MesiLine *line = (i == from) ? NULL : findLine(mc, c, e->index);
+        // 이 요청보다 뒤에 (같은 클록이면 뒤 번호 코어가) 다시 받은 라인은 그대로 (그쪽 요청이 나중에 적용됨)
+        if (!line || line->since > e->cycle || (line->since == e->cycle && i > from))
+        {
+            continue;
+        }
+        shared = true;
+        if (e->kind != LOG_BUS_RD)
+        {
+            line->state = MESI_I;
+            c->stats.invalidated++;
+        }
+        else if (line->state != MESI_S)
+        {
+            c->stats.writebacks += (line->state == MESI_M);
+            c->stats.downgraded++;
+            line->state = MESI_S;
+        }
+    }
+    if (!shared)
+    {
+        return;
+    }
+
+    MesiLine *own = findLine(mc, requester, e->index);
+    if (e->kind == LOG_BUS_RD && own && own->state == MESI_E)
+    {
+        own->state = MESI_S;
+    }
+    if (e->kind == LOG_SILENT)
+    {
+        requester->stats.busUpgr++;
+    }
+}
+
+// 모든 코어의 로그를 (클록, 코어 번호) 순서로 적용하고 다음 quantum을 준비 (스레드 0만)
+static void endQuantum(Multicore *mc)
+{
+    size_t pos[MULTICORE_MAX_CORES] = {0};
+    for (;;)
+    {
+        int pick = -1;
+        for (int i = 0; i < mc->count; i++)
+        {
+            const Core *c = &mc->cores[i];
+            if (pos[i] < c->logCount &&
+                (pick < 0 || c->log[pos[i]].cycle < mc->cores[pick].log[pos[pick]].cycle))
+            {
+                pick = i;
+            }
+        }
+        if (pick < 0)
+        {
+            break;
+        }
+        const LogEntry *e = &mc->cores[pick].log[pos[pick]++];
+        if (e->kind == LOG_STORE)
+        {
+            mc->memory[e->index] = e->value;
+        }
+        else
+        {
+            applyBus(mc, pick, e);
+        }
+    }
+
+    // 다음 quantum의 view와 라인 소유 스냅샷
+    bool running = false;
+    memset(mc->owners, 0, sizeof(mc->owners));
+    for (int i = 0; i < mc->count; i++)
+    {
+        Core *c = &mc->cores[i];
+        mc->failed |= c->logFailed;
+        running |= c->vm.running;
+        c->logCount = 0;
+        memcpy(c->vm.memory, mc->memory, MEMORY_SIZE);
+        for (uint16_t l = 0; l < mc->sets * mc->cfg->ways; l++)
+        {
+            if (c->lines[l].state != MESI_I)
+            {
+                mc->owners[c->lines[l].block] |= 1u << i;
+            }
+        }
+    }
+
+    mc->quanta++;
+    mc->done = !running || mc->failed || (mc->limit && mc->quantumEnd >= mc->limit);
+    mc->quantumEnd += mc->cfg->quantum;
+    if (mc->limit && mc->quantumEnd > mc->limit)
+    {
+        mc->quantumEnd = mc->limit;
+    }
+}
+
+// 호스트 스레드: 코어 id, id + threads, ...를 맡아 quantum마다 barrier 두 번 (실행 끝, 합치기 끝)
+static void *hostMain(void *arg)
+{
+    HostThread *t = arg;
+    Multicore *mc = t->mc;
+    do
+    {
+        for (int i = t->id; i < mc->count; i += mc->threads)
+        {
+            runQuantum(mc, &mc->cores[i], mc->quantumEnd);
+        }
+        if (mc->threads > 1)
+        {
+            pthread_barrier_wait(&mc->barrier);
+        }
+        if (t->id == 0)
+        {
+            endQuantum(mc);
+        }
+        if (mc->threads > 1)
+        {
+            pthread_barrier_wait(&mc->barrier);
+        }
+    } while (!mc->done);
+    return NULL;
+}
+
+/*  -------------------------------------
+        실행과 출력
+    -------------------------------------
+*/
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// images[i]는 코어 i의 레지스터/PC, memory는 합친 공유 메모리
+static bool initMulticore(Multicore *mc, const MulticoreConfig *cfg, const VM *images, const uint8_t *memory,
+                          int threads, uint64_t maxCycles)
+{
+    memset(mc, 0, sizeof(*mc));
+    mc->cfg = cfg;
+    mc->count = cfg->cores;
+    mc->threads = threads;
+    mc->sets = cfg->size / (cfg->lineSize * cfg->ways);
+    mc->limit = maxCycles;
+    mc->quantumEnd = (maxCycles && maxCycles < cfg->quantum) ? maxCycles : cfg->quantum;
+    memcpy(mc->memory, memory, MEMORY_SIZE);
+
+    mc->cores = aligned_alloc(_Alignof(Core), mc->count * sizeof(Core));
+    if (!mc->cores)
+    {
+        printf("Failed to allocate cores\n");
+        return false;
+    }
+    memset(mc->cores, 0, mc->count * sizeof(Core));
+    for (int i = 0; i < mc->count; i++)
+    {
+        Core *c = &mc->cores[i];
+        c->vm = images[i];
+        c->vm.paged = NULL;
+        c->vm.mem = NULL;
+        c->vm.running = true;
+        c->id = (uint8_t)i;
+        memcpy(c->vm.memory, memory, MEMORY_SIZE);
+    }
+    return true;
+}
+
+static void freeMulticore(Multicore *mc)
+{
+    for (int i = 0; i < mc->count; i++)
+    {
+        free(mc->cores[i].log);
+        freePagedMemory(&mc->cores[i].vm);
+    }
+    free(mc->cores);
+}
+
+// 끝까지 실행, 걸린 시간(초) 반환
+static double simulate(Multicore *mc)
+{
+    HostThread hosts[MULTICORE_MAX_CORES];
+    pthread_t tids[MULTICORE_MAX_CORES];
+    double t0 = nowSeconds();
+
+    if (mc->threads > 1 && pthread_barrier_init(&mc->barrier, NULL, mc->threads) != 0)
+    {
+        mc->threads = 1;
+    }
+    int started = 1;
+    for (int t = 0; t < mc->threads; t++)
+    {
+        hosts[t] = (HostThread){.mc = mc, .id = t};
+    }
+    for (int t = 1; t < mc->threads; t++)
+    {
+        if (pthread_create(&tids[t], NULL, hostMain, &hosts[t]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started < mc->threads)
+    {
+        // barrier 인원이 맞지 않으므로 만든 스레드가 없을 때만 스레드 하나로 계속
+        if (started == 1)
+        {
+            pthread_barrier_destroy(&mc->barrier);
+            mc->threads = 1;
+        }
+        else
+        {
+            printf("Failed to start host threads\n");
+            exit(1);
+        }
+    }
+    hostMain(&hosts[0]);
+    for (int t = 1; t < started; t++)
+    {
+        pthread_join(tids[t], NULL);
+    }
+    if (mc->threads > 1)
+    {
+        pthread_barrier_destroy(&mc->barrier);
+    }
+    return nowSeconds() - t0;
+}
+
+// 두 실행의 결과가 같은지 (스레드 수와 상관없이 같아야 함)
+static bool sameResult(const Multicore *a, const Multicore *b)
+{
+    if (memcmp(a->memory, b->memory, MEMORY_SIZE) != 0 || a->failed != b->failed)
+    {
+        return false;
+    }
+    for (int i = 0; i < a->count; i++)
+    {
+        const Core *x = &a->cores[i];
+        const Core *y = &b->cores[i];
+        if (memcmp(x->vm.cpu.regs, y->vm.cpu.regs, NUM_REGS) != 0 || x->vm.cpu.PC != y->vm.cpu.PC ||
+            x->vm.running != y->vm.running || x->cycle != y->cycle || x->retired != y->retired ||
+            memcmp(&x->stats, &y->stats, sizeof(CoreStats)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void printResult(const Multicore *mc, char *const programs[], int count)
+{
+    for (int i = 0; i < mc->count; i++)
+    {
+        const Core *c = &mc->cores[i];
+        const uint8_t *r = c->vm.cpu.regs;
+        printf("core %d (%s): %s cycles=%llu retired=%llu IPC=%.2f PC=%u regs=%u,%u,%u,%u,%u,%u,%u,%u\n", i,
+               programs[count == 1 ? 0 : i], c->vm.running ? "paused" : "stopped", (unsigned long long)c->cycle,
+               (unsigned long long)c->retired, c->cycle ? (double)c->retired / c->cycle : 0.0, c->vm.cpu.PC, r[0],
+               r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+    }
+
+    printf("\n----- Shared Memory Dump (256 bytes, Decimal) -----\n");
+    for (int addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        if (addr % 16 == 0)
+        {
+            printf("\n%3d: ", addr);
+        }
+        printf("%3u ", mc->memory[addr]);
+    }
+    printf("\n\n");
+
+    const MulticoreConfig *cfg = mc->cfg;
+    printf("----- Coherence (MESI) -----\n");
+    printf("config          = %u cores, L1 %uB %u-way %uB line, hit %u clk, bus %u clk, memory %u clk, quantum %u\n",
+           cfg->cores, cfg->size, cfg->ways, cfg->lineSize, cfg->hitLatency, cfg->busLatency, cfg->memLatency,
+           cfg->quantum);
+    printf("core  accesses  hit%%    BusRd   BusRdX  BusUpgr  from L1   from mem  invalidated  downgraded  writebacks\n");
+    CoreStats total = {0};
+    for (int i = 0; i < mc->count; i++)
+    {
+        const CoreStats *s = &mc->cores[i].stats;
+        printf("%4d %9llu %6.2f %8llu %8llu %8llu %9llu %9llu %12llu %11llu %11llu\n", i,
+               (unsigned long long)s->accesses, s->accesses ? 100.0 * s->hits / s->accesses : 0.0,
+               (unsigned long long)s->busRd, (unsigned long long)s->busRdX, (unsigned long long)s->busUpgr,
+               (unsigned long long)s->fromCache, (unsigned long long)s->fromMemory,
+               (unsigned long long)s->invalidated, (unsigned long long)s->downgraded,
+               (unsigned long long)s->writebacks);
+        total.accesses += s->accesses;
+        total.busRd += s->busRd;
+        total.busRdX += s->busRdX;
+        total.busUpgr += s->busUpgr;
+        total.fromCache += s->fromCache;
+        total.fromMemory += s->fromMemory;
+        total.invalidated += s->invalidated;
+        total.writebacks += s->writebacks;
+        total.stallCycles += s->stallCycles;
+    }
+    uint64_t transfers = total.fromCache + total.fromMemory + total.writebacks;
+    printf("bus requests    = %llu (BusRd %llu, BusRdX %llu, BusUpgr %llu)\n",
+           (unsigned long long)(total.busRd + total.busRdX + total.busUpgr), (unsigned long long)total.busRd,
+           (unsigned long long)total.busRdX, (unsigned long long)total.busUpgr);
+    printf("data transfers  = %llu lines, %llu bytes (L1->L1 %llu, memory->L1 %llu, writebacks %llu)\n",
+           (unsigned long long)transfers, (unsigned long long)transfers * cfg->lineSize,
+           (unsigned long long)total.fromCache, (unsigned long long)total.fromMemory,
+           (unsigned long long)total.writebacks);
+    printf("invalidations   = %llu\n", (unsigned long long)total.invalidated);
+    printf("stall cycles    = %llu\n", (unsigned long long)total.stallCycles);
+}
+
+// 프로그램을 각자 로드해서 공유 메모리로 합침 (0이 아닌 바이트끼리 다르면 오류)
+static bool loadPrograms(const MulticoreConfig *cfg, char *const programs[], int count, VM *images,
+                         uint8_t *memory)
+{
+    memset(memory, 0, MEMORY_SIZE);
+    for (int i = 0; i < count; i++)
+    {
+        initVM(&images[i]);
+        if (!loadProgramFromFile(&images[i], programs[i]))
+        {
+            return false;
+        }
+        for (int addr = 0; addr < MEMORY_SIZE; addr++)
+        {
+            uint8_t byte = images[i].memory[addr];
+            if (byte && memory[addr] && memory[addr] != byte)
+            {
+                printf("Programs overlap at address %d (%s)\n", addr, programs[i]);
+                return false;
+            }
+            if (byte)
+            {
+                memory[addr] = byte;
+            }
+        }
+    }
+    for (int i = count; i < cfg->cores; i++)
+    {
+        images[i] = images[0];
+    }
+    return true;
+}
+
+int runMulticore(const MulticoreConfig *cfg, char *const programs[], int count, uint64_t maxCycles)
+{
+    if (count != 1 && count != cfg->cores)
+    {
+        printf("Multi-core mode needs one program or %u programs (got %d)\n", cfg->cores, count);
+        return 1;
+    }
+
+    VM images[MULTICORE_MAX_CORES];
+    uint8_t memory[MEMORY_SIZE];
+    if (!loadPrograms(cfg, programs, count, images, memory))
+    {
+        return 1;
+    }
+
+    long threads = cfg->threads ? cfg->threads : sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1)
+        threads = 1;
+    if (threads > cfg->cores)
+        threads = cfg->cores;
+
+    Multicore parallel, sequential;
+    if (!initMulticore(&parallel, cfg, images, memory, (int)threads, maxCycles))
+    {
+        return 1;
+    }
+    double elapsed = simulate(&parallel);
+    if (parallel.failed)
+    {
+        printf("Failed to allocate the bus log\n");
+        freeMulticore(&parallel);
+        return 1;
+    }
+    printResult(&parallel, programs, count);
+
+    uint64_t cycles = 0, retired = 0;
+    for (int i = 0; i < parallel.count; i++)
+    {
+        cycles += parallel.cores[i].cycle;
+        retired += parallel.cores[i].retired;
+    }
+    printf("----- Host -----\n");
+    printf("quanta          = %llu\n", (unsigned long long)parallel.quanta);
+    printf("parallel        = %.4f s with %d threads (%.1f M simulated cycles/s, %llu instructions)\n", elapsed,
+           parallel.threads, elapsed > 0 ? cycles / elapsed / 1e6 : 0.0, (unsigned long long)retired);
+
+    // 같은 실행을 스레드 하나로 다시 (결과가 같아야 함)
+    int status = 0;
+    if (parallel.threads > 1)
+    {
+        if (!initMulticore(&sequential, cfg, images, memory, 1, maxCycles))
+        {
+            freeMulticore(&parallel);
+            return 1;
+        }
+        double baseline = simulate(&sequential);
+        bool same = sameResult(&parallel, &sequential);
+        printf("sequential      = %.4f s with 1 thread\n", baseline);
+        printf("speedup         = %.2fx (%s)\n", elapsed > 0 ? baseline / elapsed : 0.0,
+               same ? "same result" : "RESULT DIFFERS");
+        status = same ? 0 : 1;
+        freeMulticore(&sequential);
+    }
+    else
+    {
+        printf("sequential      = (1 host thread, use -M K:threads=N for a speedup comparison)\n");
+    }
+    freeMulticore(&parallel);
+    return status;
+}
@@ -0,0 +1,54 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include "cpu.h"
+
+/**
+ * 멀티코어 모드 (-M): K개 코어가 각자 프로그램을 실행하면서 256바이트 메모리 하나를 공유
+ * 코어마다 통합 L1(명령어 + 데이터)이 있고 MESI 프로토콜로 일관성을 유지한다.
+ *
+ * - 코어: 명령어 하나에 1클록 + 캐시 접근마다 1클록 초과분 (기능 실행 코어와 같은 결과, 레지스터 번호 마스킹)
+ * - 프로그램은 모두 같은 메모리에 로드 (.org로 코드/데이터 위치를 나눔, 0이 아닌 바이트가 서로 다르면 오류)
+ *   레지스터 초기값과 시작 PC는 코어마다 자기 프로그램에서, 넓은 주소(MEMORY_SIZE 이상)는 코어마다 따로
+ * - 호스트 스레드 여러 개가 코어를 나눠서 quantum 클록씩 실행하고 barrier에서 맞춤
+ *   quantum 동안 코어는 quantum 시작 때의 공유 메모리 + 자기 store만 보고,
+ *   barrier에서 모든 코어의 store와 버스 요청을 (클록, 코어 번호) 순서로 합쳐서
+ *   공유 메모리를 갱신하고 다른 코어의 L1에 무효화/강등을 적용한다.
+ *   그래서 결과는 스레드 수와 상관없이 같고 quantum이 짧을수록 실제 순서에 가까움 (1이면 클록 단위)
+ * - 미스가 다른 L1에서 받을지 메모리에서 받을지, 읽기 미스를 E로 받을지 S로 받을지는
+ *   quantum 시작 때의 라인 소유 스냅샷으로 정함
+ * 실행 후 코어별 상태/IPC, 버스 요청과 무효화 수, 같은 실행을 스레드 하나로 다시 돌린 시간과 비교한 속도 향상 출력
+ */
+
+#define MULTICORE_MAX_CORES 16
+
+typedef struct {
+    uint16_t cores;      // 코어 수 (1~16)
+    uint16_t threads;    // 호스트 스레드 수 (0 = 코어 수와 호스트 코어 수 중 작은 값)
+    uint32_t quantum;    // barrier 사이 클록 수
+    uint16_t size;       // L1 크기 (바이트)
+    uint16_t ways;
+    uint16_t lineSize;
+    uint16_t hitLatency; // L1 적중 클록
+    uint16_t busLatency; // 다른 L1에서 라인을 받거나 S -> M upgrade (다른 코어 무효화) 클록
+    uint16_t memLatency; // 메모리에서 라인을 받는 클록
+} MulticoreConfig;
+
+// 기본값: 2코어, quantum 1000, L1 64B 2-way 8B 라인, 적중 1클록, 버스 10클록, 메모리 30클록
+void initMulticoreConfig(MulticoreConfig *cfg);
+
+/**
+ * -M 옵션 해석: "K" 또는 "K:key=value,..."
+ * key: quantum, threads, size, ways, line, hit, bus, mem
+ * 예) 4:quantum=100,threads=4,size=32,line=4
+ */
+bool parseMulticoreOption(MulticoreConfig *cfg, const char *spec);
+
+/**
+ * 프로그램 count개(1개면 모든 코어가 같은 프로그램, 아니면 코어 수만큼)를 공유 메모리에 로드해서 실행
+ * maxCycles = 0 이면 모든 코어가 멈출 때까지, 결과와 일관성/호스트 통계를 출력
+ * 로드나 메모리 할당에 실패하면 0이 아닌 값을 반환
+ */
+int runMulticore(const MulticoreConfig *cfg, char *const programs[], int count, uint64_t maxCycles);
+
+#endif
@@ -0,0 +1,775 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ooo.h"
+#include "cache.h"
+#include "paged.h"
+
+#define NO_ARCH 0xFF   // 레지스터 필드가 비어 있음
+#define NO_PHYS 0xFFFF // 물리 레지스터 없음
+
+// ROB 항목 상태
+typedef enum {
+    ROB_WAITING,   // 예약 스테이션에서 피연산자를 기다림
+    ROB_EXECUTING, // 실행 유닛에 있음 (doneAt 클록에 결과)
+    ROB_DONE       // commit 가능
+} RobState;
+
+// fetch 큐 항목 (디코드까지 끝난 명령어)
+typedef struct {
+    bool fault;      // 메모리 밖 PC에서 fetch (commit에서 오류로 처리)
+    uint16_t pc;
+    uint16_t nextPC; // 순차 실행 시 다음 PC (JMP 대상은 instr.imm)
+    Instruction instr;
+    uint8_t srcA;    // 읽는 레지스터 (NO_ARCH = 없음)
+    uint8_t srcB;
+    uint8_t dst;     // 쓰는 레지스터 (NO_ARCH = 없음)
+} FetchSlot;
+
+typedef struct {
+    FetchSlot f;
+    uint8_t state;    // RobState
+    bool memFault;    // MOV_FR 주소가 주소 공간 밖 (commit에서 오류로 처리)
+    uint16_t physA;   // 소스 물리 레지스터 (NO_PHYS = 없음)
+    uint16_t physB;
+    uint16_t phys;    // dst의 새 물리 레지스터
+    uint16_t oldPhys; // dst의 이전 매핑 (commit에서 해제)
+    uint16_t lsqPos;  // load/store 큐 위치 (메모리 명령어만)
+    uint8_t value;    // 결과 또는 store 값
+    uint64_t doneAt;
+} RobEntry;
+
+typedef struct {
+    OooConfig cfg;
+    OooStats stats;
+
+    FetchSlot fetchQ[OOO_FETCH_QUEUE];
+    uint16_t fqHead, fqCount, fqSize;
+    uint16_t fetchPC;
+    bool fetchStopped; // HALT/INVALID/PC 오류를 fetch한 뒤 방향이 바뀔 때까지 fetch 중단
+    uint32_t fetchStall; // 명령어 캐시 미스로 남은 fetch 대기 클록
+
+    RobEntry rob[OOO_MAX_ROB]; // 원형 버퍼 (robSize개까지만 씀)
+    uint16_t robHead, robCount;
+    uint16_t lsq[OOO_MAX_ROB]; // 메모리 명령어의 ROB 번호 (프로그램 순서)
+    uint16_t lsqHead, lsqCount;
+    uint16_t rsCount;          // 예약 스테이션에 있는 항목 (= ROB_WAITING 수)
+
+    uint16_t rat[NUM_REGS];       // rename 표: 아키텍처 레지스터 -> 최신 물리 레지스터
+    uint16_t committed[NUM_REGS]; // commit된 매핑 (vm->cpu.regs와 같은 값)
+    uint8_t prf[OOO_PHYS_REGS];
+    bool ready[OOO_PHYS_REGS];
+    uint16_t freeList[OOO_PHYS_REGS];
+    uint16_t freeCount;
+} Ooo;
+
+void initOooConfig(OooConfig *cfg)
+{
+    cfg->width = 4;
+    cfg->robSize = 64;
+    cfg->rsSize = 32;
+    cfg->lsqSize = 16;
+    cfg->alus = 4;
+    cfg->memPorts = 2;
+    cfg->aluLatency = 1;
+    cfg->loadLatency = 2;
+}
+
+static bool parseValue(const char *s, uint16_t *out)
+{
+    char *end;
+    unsigned long v = strtoul(s, &end, 0);
+    if (*s == '\0' || *end != '\0' || v == 0 || v > 0xFFFF)
+    {
+        return false;
+    }
+    *out = (uint16_t)v;
+    return true;
+}
+
+static bool parseOooKey(OooConfig *cfg, const char *key, const char *value)
+{
+    if (strcmp(key, "width") == 0)
+        return parseValue(value, &cfg->width);
+    if (strcmp(key, "rob") == 0)
+        return parseValue(value, &cfg->robSize);
+    if (strcmp(key, "rs") == 0)
+        return parseValue(value, &cfg->rsSize);
+    if (strcmp(key, "lsq") == 0)
+        return parseValue(value, &cfg->lsqSize);
+    if (strcmp(key, "alus") == 0)
+        return parseValue(value, &cfg->alus);
+    if (strcmp(key, "ports") == 0)
+        return parseValue(value, &cfg->memPorts);
+    if (strcmp(key, "alu") == 0)
+        return parseValue(value, &cfg->aluLatency);
+    if (strcmp(key, "load") == 0)
+        return parseValue(value, &cfg->loadLatency);
+    return false;
+}
+
+bool parseOooOption(OooConfig *cfg, const char *spec)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    char *save = NULL;
+    for (char *kv = strtok_r(buf, ",", &save); kv; kv = strtok_r(NULL, ",", &save))
+    {
+        char *value = strchr(kv, '=');
+        if (!value)
+        {
+            printf("Bad out-of-order parameter: %s\n", kv);
+            return false;
+        }
+        *value++ = '\0';
+        if (!parseOooKey(cfg, kv, value))
+        {
+            printf("Bad out-of-order parameter: %s=%s\n", kv, value);
+            return false;
+        }
+    }
+
+    if (cfg->width > OOO_MAX_WIDTH || cfg->robSize > OOO_MAX_ROB)
+    {
+        printf("width must be 1..%d and rob 1..%d\n", OOO_MAX_WIDTH, OOO_MAX_ROB);
+        return false;
+    }
+    if (cfg->rsSize > cfg->robSize || cfg->lsqSize > cfg->robSize)
+    {
+        printf("rs and lsq cannot be larger than rob (%u)\n", cfg->robSize);
+        return false;
+    }
+    return true;
+}
+
+/*  -------------------------------------
+        fetch
+    -------------------------------------
+*/
+
+// pc의 명령어 해석 (pipeline의 IF와 같은 오퍼랜드 배치, 레지스터 번호는 마스킹)
+static void decodeAt(const VM *vm, uint16_t pc, FetchSlot *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->pc = pc;
+    s->srcA = s->srcB = s->dst = NO_ARCH;
+    if (pc >= MEMORY_SIZE)
+    {
+        s->fault = true;
+        return;
+    }
+
+    Instruction *instr = &s->instr;
+    uint8_t op = vm->memory[pc];
+    uint8_t b1 = operandByte(vm, pc + 1);
+    uint8_t b2 = operandByte(vm, pc + 2);
+    instr->opcode = (op < INVALID) ? (Opcode)op : INVALID;
+
+    switch (instr->opcode)
+    {
+    case MOV_RR: // dst <- src
+        instr->opType = OPERAND_REG_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->dst = instr->regA;
+        s->srcB = instr->regB;
+        break;
+
+    case ADD_RR: // dst <- dst (+/-) src
+    case SUB_RR:
+        instr->opType = OPERAND_REG_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->dst = instr->regA;
+        s->srcA = instr->regA;
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_RM: // [addr] <- reg
+        instr->opType = OPERAND_REG_MEM;
+        instr->imm = b1;
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_MR: // reg <- [addr]
+        instr->opType = OPERAND_MEM_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->imm = b2;
+        s->dst = instr->regA;
+        break;
+
+    case JMP:
+        instr->opType = OPERAND_IMM;
+        instr->imm = b1;
+        break;
+
+    case MOV_RF: // [addr32] <- reg
+        instr->opType = OPERAND_REG_MEM;
+        instr->imm = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF));
+        instr->regB = wideRegister(vm, pc) & (NUM_REGS - 1);
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_FR: // reg <- [addr32]
+        instr->opType = OPERAND_MEM_REG;
+        instr->regA = wideRegister(vm, pc) & (NUM_REGS - 1);
+        instr->imm = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_FR));
+        s->dst = instr->regA;
+        break;
+
+    default:
+        break;
+    }
+    s->nextPC = pc + getInstructionSize(instr);
+}
+
+// 클록마다 width개까지, JMP나 캐시 미스에서 묶음을 끊음
+static void oooFetch(VM *vm, Ooo *o)
+{
+    if (o->fetchStall > 0)
+    {
+        o->fetchStall--;
+        o->stats.fetchStalls++;
+        vm->mem->stallCycles++;
+        PERF_INC(vm, stallCycles);
+        return;
+    }
+
+    for (int n = 0; n < o->cfg.width && !o->fetchStopped && o->fqCount < o->fqSize; n++)
+    {
+        FetchSlot *s = &o->fetchQ[(o->fqHead + o->fqCount++) % OOO_FETCH_QUEUE];
+        decodeAt(vm, o->fetchPC, s);
+        o->stats.fetched++;
+        PERF_INC(vm, fetches);
+
+        // 뒤쪽은 실행될 일이 없으므로 fetch 중단
+        if (s->fault || s->instr.opcode == HALT || s->instr.opcode == INVALID)
+        {
+            o->fetchStopped = true;
+            break;
+        }
+
+        bool jump = s->instr.opcode == JMP;
+        o->fetchPC = jump ? (uint16_t)s->instr.imm : s->nextPC;
+        if (vm->mem)
+        {
+            uint32_t latency = memAccess(vm->mem, MEM_IFETCH, s->pc, s->nextPC - s->pc);
+            if (latency > 1)
+            {
+                o->fetchStall = latency - 1;
+                break;
+            }
+        }
+        if (jump)
+        {
+            o->stats.jmpRedirects++;
+            break;
+        }
+    }
+}
+
+/*  -------------------------------------
+        dispatch (rename)
+    -------------------------------------
+*/
+
+static bool isLoad(Opcode op)
+{
+    return op == MOV_MR || op == MOV_FR;
+}
+
+static bool isStore(Opcode op)
+{
+    return op == MOV_RM || op == MOV_RF;
+}
+
+// 실행 유닛이 필요한 명령어 (나머지는 dispatch하자마자 commit 가능)
+static bool needsExecution(const FetchSlot *f)
+{
+    if (f->fault)
+    {
+        return false;
+    }
+    switch (f->instr.opcode)
+    {
+    case MOV_RR:
+    case ADD_RR:
+    case SUB_RR:
+    case MOV_RM:
+    case MOV_MR:
+    case MOV_RF:
+    case MOV_FR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static uint16_t renameSource(const Ooo *o, uint8_t reg)
+{
+    return (reg == NO_ARCH) ? NO_PHYS : o->rat[reg];
+}
+
+// fetch 큐 앞에서부터 width개까지 ROB로, 자리가 없으면 그 원인을 세고 멈춤
+static void oooDispatch(Ooo *o)
+{
+    for (int n = 0; n < o->cfg.width && o->fqCount > 0; n++)
+    {
+        const FetchSlot *f = &o->fetchQ[o->fqHead];
+        bool execute = needsExecution(f);
+        bool memory = execute && (isLoad(f->instr.opcode) || isStore(f->instr.opcode));
+        if (o->robCount == o->cfg.robSize)
+        {
+            o->stats.robFull++;
+            break;
+        }
+        if (execute && o->rsCount == o->cfg.rsSize)
+        {
+            o->stats.rsFull++;
+            break;
+        }
+        if (memory && o->lsqCount == o->cfg.lsqSize)
+        {
+            o->stats.lsqFull++;
+            break;
+        }
+
+        uint16_t index = (o->robHead + o->robCount++) % OOO_MAX_ROB;
+        RobEntry *e = &o->rob[index];
+        e->f = *f;
+        e->memFault = false;
+        e->physA = renameSource(o, f->srcA);
+        e->physB = renameSource(o, f->srcB);
+        e->phys = e->oldPhys = NO_PHYS;
+        if (execute && f->dst != NO_ARCH)
+        {
+            e->phys = o->freeList[--o->freeCount];
+            e->oldPhys = o->rat[f->dst];
+            o->rat[f->dst] = e->phys;
+            o->ready[e->phys] = false;
+        }
+        if (memory)
+        {
+            e->lsqPos = (o->lsqHead + o->lsqCount++) % OOO_MAX_ROB;
+            o->lsq[e->lsqPos] = index;
+        }
+        if (execute)
+        {
+            e->state = ROB_WAITING;
+            o->rsCount++;
+        }
+        else
+        {
+            e->state = ROB_DONE;
+        }
+
+        o->fqHead = (o->fqHead + 1) % OOO_FETCH_QUEUE;
+        o->fqCount--;
+    }
+}
+
+/*  -------------------------------------
+        issue / writeback
+    -------------------------------------
+*/
+
+static bool operandReady(const Ooo *o, uint16_t phys)
+{
+    return phys == NO_PHYS || o->ready[phys];
+}
+
+// load e보다 앞선 store 중 같은 주소인 가장 가까운 것 (없으면 NULL)
+static const RobEntry *olderStore(const Ooo *o, const RobEntry *e)
+{
+    for (uint16_t pos = e->lsqPos; pos != o->lsqHead;)
+    {
+        pos = (pos + OOO_MAX_ROB - 1) % OOO_MAX_ROB;
+        const RobEntry *s = &o->rob[o->lsq[pos]];
+        if (isStore(s->f.instr.opcode) && s->f.instr.imm == e->f.instr.imm)
+        {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+// load 실행: 앞선 store 값이나 메모리 값, 지연 클록 반환 (0 = 아직 issue할 수 없음)
+static uint32_t executeLoad(VM *vm, Ooo *o, RobEntry *e)
+{
+    const RobEntry *store = olderStore(o, e);
+    if (store)
+    {
+        if (store->state != ROB_DONE)
+        {
+            o->stats.loadWaits++;
+            return 0;
+        }
+        e->value = store->value;
+        o->stats.forwarded++;
+        return 1;
+    }
+
+    uint32_t addr = e->f.instr.imm;
+    if (!wideLoad(vm, addr, &e->value))
+    {
+        e->memFault = true;
+        return 1;
+    }
+    if (!vm->mem)
+    {
+        return o->cfg.loadLatency;
+    }
+    return (e->f.instr.opcode == MOV_MR) ? memAccess(vm->mem, MEM_READ, addr, 1)
+                                         : memAccessWide(vm->mem, MEM_READ, addr);
+}
+
+// 피연산자가 준비된 항목을 오래된 것부터 실행 유닛으로
+static void oooIssue(VM *vm, Ooo *o)
+{
+    uint16_t alus = 0, ports = 0, issued = 0;
+    for (uint16_t i = 0; i < o->robCount && issued < o->cfg.width; i++)
+    {
+        RobEntry *e = &o->rob[(o->robHead + i) % OOO_MAX_ROB];
+        if (e->state != ROB_WAITING || !operandReady(o, e->physA) || !operandReady(o, e->physB))
+        {
+            continue;
+        }
+
+        uint8_t a = (e->physA != NO_PHYS) ? o->prf[e->physA] : 0;
+        uint8_t b = (e->physB != NO_PHYS) ? o->prf[e->physB] : 0;
+        Opcode op = e->f.instr.opcode;
+        uint32_t latency;
+        if (isLoad(op) || isStore(op))
+        {
+            if (ports == o->cfg.memPorts)
+            {
+                continue;
+            }
+            if (isStore(op))
+            {
+                e->value = b; // store 값 (메모리에는 commit에서 씀)
+                latency = 1;
+            }
+            else if ((latency = executeLoad(vm, o, e)) == 0)
+            {
+                continue;
+            }
+            ports++;
+        }
+        else
+        {
+            if (alus == o->cfg.alus)
+            {
+                continue;
+            }
+            e->value = (op == ADD_RR) ? (uint8_t)(a + b) : (op == SUB_RR) ? (uint8_t)(a - b) : b;
+            latency = o->cfg.aluLatency;
+            alus++;
+        }
+
+        e->state = ROB_EXECUTING;
+        e->doneAt = o->stats.cycles + latency;
+        o->rsCount--;
+        issued++;
+    }
+    o->stats.issued += issued;
+    o->stats.issueHist[issued]++;
+}
+
+// 이번 클록에 끝난 결과를 물리 레지스터에 쓰고 기다리던 항목을 깨움
+static void oooWriteback(Ooo *o)
+{
+    for (uint16_t i = 0; i < o->robCount; i++)
+    {
+        RobEntry *e = &o->rob[(o->robHead + i) % OOO_MAX_ROB];
+        if (e->state != ROB_EXECUTING || e->doneAt > o->stats.cycles)
+        {
+            continue;
+        }
+        e->state = ROB_DONE;
+        if (e->phys != NO_PHYS)
+        {
+            o->prf[e->phys] = e->value;
+            o->ready[e->phys] = true;
+        }
+    }
+}
+
+/*  -------------------------------------
+        commit
+    -------------------------------------
+*/
+
+// commit 안 된 명령어와 fetch 큐를 모두 버리고 rename 표를 commit 상태로 되돌림
+static void flushYounger(Ooo *o, uint16_t nextPC)
+{
+    o->robCount = 0;
+    o->lsqCount = 0;
+    o->rsCount = 0;
+    o->fqCount = 0;
+    o->fetchPC = nextPC;
+    o->fetchStopped = false;
+    o->fetchStall = 0;
+
+    bool used[OOO_PHYS_REGS] = {false};
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        o->rat[r] = o->committed[r];
+        used[o->committed[r]] = true;
+    }
+    o->freeCount = 0;
+    for (uint16_t p = 0; p < NUM_REGS + o->cfg.robSize; p++)
+    {
+        if (!used[p])
+        {
+            o->freeList[o->freeCount++] = p;
+        }
+    }
+}
+
+// addr를 명령어 바이트로 가진 fetch 이후 명령어가 있는지 (ROB 남은 것, fetch 큐)
+static bool fetchedCovers(const Ooo *o, uint32_t addr)
+{
+    for (uint16_t i = 0; i < o->robCount; i++)
+    {
+        const FetchSlot *f = &o->rob[(o->robHead + i) % OOO_MAX_ROB].f;
+        if (!f->fault && addr >= f->pc && addr < f->nextPC)
+        {
+            return true;
+        }
+    }
+    for (uint16_t i = 0; i < o->fqCount; i++)
+    {
+        const FetchSlot *f = &o->fetchQ[(o->fqHead + i) % OOO_FETCH_QUEUE];
+        if (!f->fault && addr >= f->pc && addr < f->nextPC)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ROB 맨 앞 명령어 하나를 VM에 반영, 멈춰야 하면 false
+static bool commitHead(VM *vm, Ooo *o, const RobEntry *e)
+{
+    const Instruction *instr = &e->f.instr;
+
+    // 오류/HALT는 PC를 그 명령어 위치에 두고 멈춤 (runVM()과 같음)
+    if (e->f.fault)
+    {
+        printf("PC out of memory range!\n");
+        vm->cpu.PC = e->f.pc;
+        vm->running = false;
+        return false;
+    }
+    if (instr->opcode == INVALID)
+    {
+        printf("Invalid opcode\n");
+        vm->cpu.PC = e->f.pc;
+        vm->running = false;
+        return false;
+    }
+    if (e->memFault || (instr->opcode == MOV_RF && !wideStore(vm, instr->imm, e->value)))
+    {
+        wideAccessError(vm, instr->opcode, instr->imm, e->f.pc);
+        vm->cpu.PC = e->f.pc;
+        vm->running = false;
+        return false;
+    }
+    PERF_INC(vm, retired);
+    PERF_INC(vm, opcodes[instr->opcode]);
+    o->stats.retired++;
+    if (instr->opcode == HALT)
+    {
+        vm->cpu.PC = e->f.pc;
+        vm->running = false;
+        return false;
+    }
+
+    // 쓰기 버퍼가 있다고 보고 store의 캐시 지연은 기다리지 않음 (캐시 상태와 통계에만 반영)
+    switch (instr->opcode)
+    {
+    case MOV_RM:
+        vm->memory[instr->imm] = e->value;
+        MARK_DIRTY(vm, instr->imm);
+        if (vm->mem)
+            memAccess(vm->mem, MEM_WRITE, instr->imm, 1);
+        PERF_INC(vm, memWrites);
+        break;
+    case MOV_RF:
+        if (vm->mem)
+            memAccessWide(vm->mem, MEM_WRITE, instr->imm);
+        PERF_INC(vm, memWrites);
+        break;
+    case MOV_MR:
+    case MOV_FR:
+        PERF_INC(vm, memReads);
+        break;
+    default:
+        break;
+    }
+
+    if (e->f.dst != NO_ARCH && e->phys != NO_PHYS)
+    {
+        vm->cpu.regs[e->f.dst] = o->prf[e->phys];
+        o->committed[e->f.dst] = e->phys;
+        o->freeList[o->freeCount++] = e->oldPhys;
+    }
+    vm->cpu.PC = (instr->opcode == JMP) ? (uint16_t)instr->imm : e->f.nextPC;
+    return true;
+}
+
+// ROB 앞에서부터 끝난 명령어를 width개까지, 멈춰야 하면 false
+static bool oooCommit(VM *vm, Ooo *o)
+{
+    uint64_t before = o->stats.retired;
+    bool running = true;
+    for (uint16_t n = 0; n < o->cfg.width && o->robCount > 0; n++)
+    {
+        const RobEntry *e = &o->rob[o->robHead];
+        if (e->state != ROB_DONE || !(running = commitHead(vm, o, e)))
+        {
+            break;
+        }
+        o->robHead = (o->robHead + 1) % OOO_MAX_ROB;
+        o->robCount--;
+
+        Opcode op = e->f.instr.opcode;
+        if (isLoad(op) || isStore(op))
+        {
+            o->lsqHead = (o->lsqHead + 1) % OOO_MAX_ROB;
+            o->lsqCount--;
+        }
+        // 자기 수정 코드: 바뀐 바이트를 이미 fetch했으면 store 다음 명령어부터 다시 fetch
+        if (isStore(op) && e->f.instr.imm < MEMORY_SIZE && fetchedCovers(o, e->f.instr.imm))
+        {
+            o->stats.smcFlushes++;
+            flushYounger(o, e->f.nextPC);
+            break;
+        }
+    }
+    o->stats.commitHist[o->stats.retired - before]++;
+    return running;
+}
+
+// 한 클록
+static void oooClock(VM *vm, Ooo *o)
+{
+    o->stats.cycles++;
+    PERF_INC(vm, cycles);
+
+    if (!oooCommit(vm, o))
+    {
+        return;
+    }
+    oooWriteback(o);
+    oooIssue(vm, o);
+    oooDispatch(o);
+    oooFetch(vm, o);
+    o->stats.robOccupancy += o->robCount;
+}
+
+static void addStats(OooStats *dst, const OooStats *src)
+{
+    dst->cycles += src->cycles;
+    dst->retired += src->retired;
+    dst->fetched += src->fetched;
+    dst->issued += src->issued;
+    dst->robFull += src->robFull;
+    dst->rsFull += src->rsFull;
+    dst->lsqFull += src->lsqFull;
+    dst->fetchStalls += src->fetchStalls;
+    dst->jmpRedirects += src->jmpRedirects;
+    dst->forwarded += src->forwarded;
+    dst->loadWaits += src->loadWaits;
+    dst->smcFlushes += src->smcFlushes;
+    dst->robOccupancy += src->robOccupancy;
+    for (int i = 0; i <= OOO_MAX_WIDTH; i++)
+    {
+        dst->commitHist[i] += src->commitHist[i];
+        dst->issueHist[i] += src->issueHist[i];
+    }
+    dst->width = src->width;
+}
+
+uint64_t runOutOfOrder(VM *vm, uint64_t maxCycles, const OooConfig *cfg, OooStats *stats)
+{
+    Ooo *o = calloc(1, sizeof(Ooo));
+    if (!o)
+    {
+        printf("Out of memory for the out-of-order engine\n");
+        vm->running = false;
+        return 0;
+    }
+    if (cfg)
+        o->cfg = *cfg;
+    else
+        initOooConfig(&o->cfg);
+    o->stats.width = o->cfg.width;
+    o->fqSize = 2 * o->cfg.width;
+    o->fetchPC = vm->cpu.PC;
+
+    // 처음 매핑은 물리 레지스터 0~7 = VM 레지스터
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        o->committed[r] = (uint16_t)r;
+        o->prf[r] = vm->cpu.regs[r];
+        o->ready[r] = true;
+    }
+    flushYounger(o, vm->cpu.PC);
+
+    vm->running = true;
+    while (vm->running && (maxCycles == 0 || o->stats.cycles < maxCycles))
+    {
+        oooClock(vm, o);
+    }
+    // 제한에 걸려 멈추면 commit한 것까지만 VM에 있고 vm->cpu.PC는 다음 명령어
+
+    uint64_t cycles = o->stats.cycles;
+    if (stats)
+    {
+        addStats(stats, &o->stats);
+    }
+    free(o);
+    return cycles;
+}
+
+// 클록당 개수 분포 (비율)
+static void printHistogram(const char *label, const uint64_t *hist, uint16_t width, uint64_t cycles)
+{
+    printf("%-15s =", label);
+    for (int i = 0; i <= width; i++)
+    {
+        printf(" %d:%.1f%%", i, cycles ? 100.0 * hist[i] / cycles : 0.0);
+    }
+    printf("\n");
+}
+
+void printOooStats(const OooConfig *cfg, const OooStats *stats)
+{
+    printf("----- Out-of-order -----\n");
+    printf("config          = width %u, ROB %u, RS %u, LSQ %u, %u ALU x %u clk, %u mem ports, load %u clk\n",
+           cfg->width, cfg->robSize, cfg->rsSize, cfg->lsqSize, cfg->alus, cfg->aluLatency, cfg->memPorts,
+           cfg->loadLatency);
+    printf("cycles          = %llu\n", (unsigned long long)stats->cycles);
+    printf("retired         = %llu\n", (unsigned long long)stats->retired);
+    printf("IPC             = %.3f (CPI %.3f)\n", stats->cycles ? (double)stats->retired / stats->cycles : 0.0,
+           stats->retired ? (double)stats->cycles / stats->retired : 0.0);
+    printf("fetched         = %llu (issued %llu)\n", (unsigned long long)stats->fetched,
+           (unsigned long long)stats->issued);
+    printf("ROB occupancy   = %.1f avg\n", stats->cycles ? (double)stats->robOccupancy / stats->cycles : 0.0);
+    printf("dispatch stalls = ROB full %llu, RS full %llu, LSQ full %llu\n", (unsigned long long)stats->robFull,
+           (unsigned long long)stats->rsFull, (unsigned long long)stats->lsqFull);
+    printf("JMP redirects   = %llu\n", (unsigned long long)stats->jmpRedirects);
+    printf("loads forwarded = %llu (waited for store %llu)\n", (unsigned long long)stats->forwarded,
+           (unsigned long long)stats->loadWaits);
+    printf("SMC flushes     = %llu\n", (unsigned long long)stats->smcFlushes);
+    if (stats->fetchStalls)
+    {
+        printf("fetch stalls    = %llu\n", (unsigned long long)stats->fetchStalls);
+    }
+    printHistogram("issue/cycle", stats->issueHist, stats->width, stats->cycles);
+    printHistogram("commit/cycle", stats->commitHist, stats->width, stats->cycles);
+}
@@ -0,0 +1,77 @@
+#ifndef OOO_H
+#define OOO_H
+
+#include "cpu.h"
+
+/**
+ * 비순차 실행 엔진 (-e ooo, Tomasulo 방식 + 재정렬 버퍼)
+ * 매 클록 commit -> writeback -> issue -> dispatch(rename) -> fetch 순서
+ *
+ * - fetch: 클록마다 명령어 width개까지 fetch 큐로 (JMP는 디코드에서 대상을 알므로 그 뒤는 다음 클록에 대상에서)
+ * - dispatch: 8개 레지스터를 물리 레지스터(NUM_REGS + ROB 크기)로 rename하고 ROB에 넣음
+ *   실행할 명령어는 예약 스테이션, MOV_MR/MOV_RM/MOV_FR/MOV_RF는 load/store 큐에도 자리가 있어야 함
+ * - issue: 피연산자가 준비된 예약 스테이션 항목을 오래된 것부터 (ALU, 메모리 포트 수와 width 안에서)
+ * - load: 주소가 명령어에 있으므로 load/store 큐에서 앞선 같은 주소 store를 정확히 찾음
+ *   있으면 그 값을 받고 (값이 아직 없으면 기다림), 없으면 메모리(캐시)에서 읽음
+ * - commit: ROB 앞에서부터 width개까지 순서대로 VM 레지스터, 메모리, PC를 바꿈 (store는 여기서 씀)
+ *   HALT/INVALID/PC 오류는 commit에서 멈춤, store가 이미 fetch한 뒤쪽 명령어 바이트를 바꾸면 뒤쪽을 모두 버림
+ * 결과(레지스터, 메모리, 최종 PC)는 runVM()과 같고 클록 수만 다르다.
+ */
+
+#define OOO_MAX_WIDTH 8
+#define OOO_MAX_ROB 256
+#define OOO_PHYS_REGS (NUM_REGS + OOO_MAX_ROB) // commit 전 명령어마다 하나면 부족할 일이 없음
+#define OOO_FETCH_QUEUE (2 * OOO_MAX_WIDTH)
+
+// 엔진 설정 (-O key=value,...)
+typedef struct {
+    uint16_t width;       // fetch/dispatch/issue/commit 폭
+    uint16_t robSize;     // 재정렬 버퍼 항목 수
+    uint16_t rsSize;      // 예약 스테이션 항목 수 (통합)
+    uint16_t lsqSize;     // load/store 큐 항목 수
+    uint16_t alus;        // ALU 수 (MOV_RR, ADD_RR, SUB_RR)
+    uint16_t memPorts;    // 메모리 포트 수 (load, store 값)
+    uint16_t aluLatency;  // ALU 지연 클록
+    uint16_t loadLatency; // 캐시가 없을 때 load 지연 (캐시가 있으면 캐시 지연)
+} OooConfig;
+
+typedef struct {
+    uint64_t cycles;
+    uint64_t retired;       // commit한 명령어 (HALT 포함)
+    uint64_t fetched;       // fetch 큐에 넣은 명령어 (버린 것 포함)
+    uint64_t issued;        // 실행 유닛에 보낸 명령어
+    uint64_t robFull;       // ROB가 차서 dispatch가 멈춘 클록
+    uint64_t rsFull;        // 예약 스테이션이 차서 멈춘 클록
+    uint64_t lsqFull;       // load/store 큐가 차서 멈춘 클록
+    uint64_t fetchStalls;   // 명령어 캐시 미스로 fetch가 기다린 클록
+    uint64_t jmpRedirects;  // JMP로 fetch 묶음을 끊은 횟수
+    uint64_t forwarded;     // store 값을 바로 받은 load
+    uint64_t loadWaits;     // 앞선 store 값이 없어서 load가 issue를 미룬 횟수
+    uint64_t smcFlushes;    // store가 fetch한 명령어를 바꿔서 비운 횟수
+    uint64_t robOccupancy;  // 클록마다 ROB 항목 수 합 (평균용)
+    uint64_t commitHist[OOO_MAX_WIDTH + 1]; // 클록당 commit 수 분포
+    uint64_t issueHist[OOO_MAX_WIDTH + 1];  // 클록당 issue 수 분포
+    uint16_t width;         // 분포를 낸 폭
+} OooStats;
+
+// 기본값: 4-wide, ROB 64, 예약 스테이션 32, load/store 큐 16, ALU 4, 메모리 포트 2, ALU 1클록, load 2클록
+void initOooConfig(OooConfig *cfg);
+
+/**
+ * -O 옵션 해석: "key=value,..."
+ * key: width (1~8), rob (1~256), rs, lsq (1~rob), alus, ports (1~width), alu, load (지연 1 이상)
+ * 예) width=2,rob=32,rs=16,lsq=8,alus=2,ports=1,alu=1,load=3
+ */
+bool parseOooOption(OooConfig *cfg, const char *spec);
+
+/**
+ * 비순차 엔진으로 실행 (maxCycles = 0 이면 제한 없음)
+ * 제한에 걸리면 commit 안 된 명령어를 버리고 다음 명령어 PC에서 멈춤 (VM에는 commit한 것만 있음)
+ * stats가 NULL이 아니면 통계를 더함, 실행한 클록 수를 반환
+ */
+uint64_t runOutOfOrder(VM *vm, uint64_t maxCycles, const OooConfig *cfg, OooStats *stats);
+
+// 통계 출력 (IPC, dispatch 멈춤 원인, 클록당 issue/commit 분포)
+void printOooStats(const OooConfig *cfg, const OooStats *stats);
+
+#endif
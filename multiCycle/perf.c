@@ -0,0 +1,60 @@
+#include "perf.h"
+
+static const char *const opcodeNames[PERF_OPCODES] = {
+    "HALT", "NOP", "MOV_RR", "MOV_RM", "MOV_MR", "ADD_RR", "SUB_RR", "JMP", "MOV_RF", "MOV_FR", "INVALID",
+};
+
+static const char *const stageNames[PERF_STAGES] = {"IF", "ID", "EX", "MEM", "WB"};
+
+void printPerfText(FILE *fp, const PerfCounters *pc)
+{
+    double cycles = pc->cycles ? (double)pc->cycles : 1.0;
+
+    fprintf(fp, "----- Performance Counters -----\n");
+    fprintf(fp, "cycles          = %llu\n", (unsigned long long)pc->cycles);
+    fprintf(fp, "retired         = %llu\n", (unsigned long long)pc->retired);
+    fprintf(fp, "CPI             = %.3f\n", pc->retired ? (double)pc->cycles / pc->retired : 0.0);
+    fprintf(fp, "fetches         = %llu\n", (unsigned long long)pc->fetches);
+    fprintf(fp, "memory reads    = %llu\n", (unsigned long long)pc->memReads);
+    fprintf(fp, "memory writes   = %llu\n", (unsigned long long)pc->memWrites);
+    fprintf(fp, "stall cycles    = %llu\n", (unsigned long long)pc->stallCycles);
+    for (int s = 0; s < PERF_STAGES; s++)
+    {
+        fprintf(fp, "  %-3s busy      = %llu (%.1f%%)\n", stageNames[s], (unsigned long long)pc->stageBusy[s],
+                100.0 * pc->stageBusy[s] / cycles);
+    }
+    for (int op = 0; op < PERF_OPCODES; op++)
+    {
+        fprintf(fp, "  %-13s = %llu\n", opcodeNames[op], (unsigned long long)pc->opcodes[op]);
+    }
+}
+
+void writePerfJson(FILE *fp, const PerfCounters *pc)
+{
+    fprintf(fp, "{\"cycles\": %llu, \"retired\": %llu, \"cpi\": %.6f, \"fetches\": %llu, "
+                "\"memReads\": %llu, \"memWrites\": %llu, \"stallCycles\": %llu, \"stageBusy\": {",
+            (unsigned long long)pc->cycles, (unsigned long long)pc->retired,
+            pc->retired ? (double)pc->cycles / pc->retired : 0.0, (unsigned long long)pc->fetches,
+            (unsigned long long)pc->memReads, (unsigned long long)pc->memWrites,
+            (unsigned long long)pc->stallCycles);
+    for (int s = 0; s < PERF_STAGES; s++)
+    {
+        fprintf(fp, "%s\"%s\": %llu", s ? ", " : "", stageNames[s], (unsigned long long)pc->stageBusy[s]);
+    }
+    fprintf(fp, "}, \"opcodes\": {");
+    for (int op = 0; op < PERF_OPCODES; op++)
+    {
+        fprintf(fp, "%s\"%s\": %llu", op ? ", " : "", opcodeNames[op], (unsigned long long)pc->opcodes[op]);
+    }
+    fprintf(fp, "}}\n");
+}
+
+const char *opcodeName(int op)
+{
+    return (op >= 0 && op < PERF_OPCODES) ? opcodeNames[op] : opcodeNames[PERF_OPCODES - 1];
+}
+
+const char *stageName(int stage)
+{
+    return (stage >= 0 && stage < PERF_STAGES) ? stageNames[stage] : "?";
+}
@@ -0,0 +1,46 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * 성능 카운터
+ * VM마다 하나씩 (VM 구조체 끝, 캐시 라인 정렬이라 다른 VM이나 VM의 다른 상태와 라인을 같이 쓰지 않음)
+ * make PERF=0 으로 빌드하면 PERF_COUNTERS가 정의되지 않아 카운터 필드와 갱신 코드가 모두 빠짐
+ */
+
+#define PERF_OPCODES 11 // HALT ~ INVALID
+#define PERF_STAGES 5  // IF ID EX MEM WB
+
+typedef struct {
+    uint64_t cycles;
+    uint64_t retired;     // 끝까지 실행된 명령어 (HALT 포함)
+    uint64_t fetches;     // IF 횟수 (pipeline은 버려진 fetch 포함)
+    uint64_t memReads;    // MOV_MR, MOV_FR
+    uint64_t memWrites;   // MOV_RM, MOV_RF
+    uint64_t stallCycles; // 캐시 미스로 기다린 클록
+    uint64_t opcodes[PERF_OPCODES]; // 완료된 명령어의 opcode별 횟수
+    uint64_t stageBusy[PERF_STAGES]; // 단계별로 명령어가 들어 있던 클록 수
+} __attribute__((aligned(64))) PerfCounters;
+
+#ifdef PERF_COUNTERS
+#define PERF_ADD(vm, field, n) ((vm)->perf.field += (n))
+#else
+#define PERF_ADD(vm, field, n) ((void)(vm)) // vm만 쓰는 함수가 PERF=0에서 경고 나지 않게
+#endif
+#define PERF_INC(vm, field) PERF_ADD(vm, field, 1)
+
+// 사람이 읽는 형식
+void printPerfText(FILE *fp, const PerfCounters *pc);
+
+// JSON 한 개체
+void writePerfJson(FILE *fp, const PerfCounters *pc);
+
+// opcode 이름 (범위 밖이면 "INVALID")
+const char *opcodeName(int op);
+
+// 단계 이름 ("IF", "ID", "EX", "MEM", "WB")
+const char *stageName(int stage);
+
+#endif
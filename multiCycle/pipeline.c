@@ -0,0 +1,618 @@
+#include <stdio.h>
+#include <string.h>
+#include "pipeline.h"
+#include "cache.h"
+#include "paged.h"
+
+/**
+ * 5단 파이프라인
+ * 매 클록 WB -> MEM -> EX -> ID -> IF 순서로 처리하고, 각 단계는 클록 시작 시점의
+ * 래치(old)를 읽어 다음 래치를 만든다. WB가 먼저 레지스터에 쓰므로 같은 클록의 ID는 새 값을 읽음.
+ *
+ * - RAW 해저드: ID에서 앞선 명령어(EX, MEM 단계)가 쓸 레지스터를 읽으려 하면
+ *   포워딩으로 받을 수 없을 때 ID를 멈추고 EX로 버블을 보냄
+ * - JMP: EX에서 대상이 정해지면 뒤에 fetch한 명령어를 버림 (2 클록 손해)
+ *   분기 예측기를 쓰면 IF에서 예측한 다음 PC를 ID에서 확인하고, 틀렸으면 그 클록의 fetch를
+ *   건너뛰고 맞는 PC로 바꿈 (1 클록 손해, 틀린 경로의 명령어는 파이프라인에 들어오지 않음)
+ * - HALT/INVALID/PC 오류: WB에 도달했을 때 멈춤 (그 뒤 명령어는 아무것도 바꾸지 않음)
+ * - MOV_RM이 이미 fetch한 뒤쪽 명령어의 바이트를 바꾸면 뒤쪽을 모두 버리고 다시 fetch
+ *   (256 미만 주소에 쓰는 MOV_RF도 같음)
+ * - 캐시 계층이 있으면 IF/MEM의 미스 지연만큼 파이프라인 전체를 멈춤
+ */
+
+static const PipeSlot bubble = {.valid = false};
+
+void initPipelineConfig(PipelineConfig *cfg)
+{
+    cfg->forwardExEx = true;
+    cfg->forwardMemEx = true;
+    cfg->predictor = BP_NONE;
+}
+
+// 캐시 접근: 첫 클록은 단계 자체의 클록이고 나머지는 파이프라인 전체 대기
+static void chargeMemory(VM *vm, Pipeline *p, AccessKind kind, uint16_t addr, uint16_t len)
+{
+    if (!vm->mem)
+    {
+        return;
+    }
+    uint32_t latency = memAccess(vm->mem, kind, addr, len);
+    if (latency > 1)
+    {
+        p->memStall += latency - 1;
+    }
+}
+
+// IF: fetchPC의 명령어 바이트를 읽고 바로 해석 (stageDecode()와 같은 오퍼랜드 배치)
+static void pipeFetch(VM *vm, Pipeline *p)
+{
+    PipeSlot *s = &p->ifId;
+    uint16_t pc = p->fetchPC;
+
+    *s = bubble;
+    s->valid = true;
+    s->pc = pc;
+    s->srcA = s->srcB = s->dst = NO_REG;
+
+    PERF_INC(vm, fetches);
+    PERF_INC(vm, stageBusy[STAGE_FETCH]);
+
+    if (pc >= MEMORY_SIZE)
+    {
+        s->fault = true;
+        p->fetchStopped = true;
+        return;
+    }
+
+    Instruction *instr = &s->instr;
+    uint8_t op = vm->memory[pc];
+    uint8_t b1 = operandByte(vm, pc + 1);
+    uint8_t b2 = operandByte(vm, pc + 2);
+    instr->opcode = (op < INVALID) ? (Opcode)op : INVALID;
+
+    // 레지스터 번호는 regs 배열 밖을 쓰지 않도록 마스킹
+    switch (instr->opcode)
+    {
+    case MOV_RR: // dst <- src
+        instr->opType = OPERAND_REG_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->dst = instr->regA;
+        s->srcB = instr->regB;
+        break;
+
+    case ADD_RR: // dst <- dst (+/-) src
+    case SUB_RR:
+        instr->opType = OPERAND_REG_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->dst = instr->regA;
+        s->srcA = instr->regA;
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_RM: // [addr] <- reg
+        instr->opType = OPERAND_REG_MEM;
+        instr->imm = b1;
+        instr->regB = b2 & (NUM_REGS - 1);
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_MR: // reg <- [addr]
+        instr->opType = OPERAND_MEM_REG;
+        instr->regA = b1 & (NUM_REGS - 1);
+        instr->imm = b2;
+        s->dst = instr->regA;
+        break;
+
+    case JMP:
+        instr->opType = OPERAND_IMM;
+        instr->imm = b1;
+        break;
+
+    case MOV_RF: // [addr32] <- reg
+        instr->opType = OPERAND_REG_MEM;
+        instr->imm = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF));
+        instr->regB = wideRegister(vm, pc) & (NUM_REGS - 1);
+        s->srcB = instr->regB;
+        break;
+
+    case MOV_FR: // reg <- [addr32]
+        instr->opType = OPERAND_MEM_REG;
+        instr->regA = wideRegister(vm, pc) & (NUM_REGS - 1);
+        instr->imm = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_FR));
+        s->dst = instr->regA;
+        break;
+
+    case NOP:
+        break;
+
+    case HALT:
+    case INVALID:
+    default:
+        // 뒤쪽은 실행될 일이 없으므로 fetch 중단
+        p->fetchStopped = true;
+        break;
+    }
+
+    s->nextPC = pc + getInstructionSize(instr);
+    p->fetchPC = s->nextPC;
+    chargeMemory(vm, p, MEM_IFETCH, pc, s->nextPC - pc);
+
+    // BTB에 있고 taken으로 예측하면 다음 클록은 대상에서 fetch
+    if (p->cfg.predictor >= BP_BTB)
+    {
+        s->pred = predictBranch(&p->bp, pc);
+        p->stats.bp.lookups++;
+        p->stats.bp.btbHits += s->pred.btbHit;
+        if (s->pred.btbHit && s->pred.taken)
+        {
+            p->fetchPC = s->pred.target;
+        }
+    }
+}
+
+// 예측했던 다음 PC
+static uint16_t predictedNext(const PipeSlot *s)
+{
+    return (s->pred.btbHit && s->pred.taken) ? s->pred.target : s->nextPC;
+}
+
+// ID: 예측 확인 및 예측기 갱신, 틀렸으면 fetchPC를 바로잡고 true
+static bool verifyPrediction(Pipeline *p, const PipeSlot *s)
+{
+    if (s->fault)
+    {
+        return false;
+    }
+    bool isBranch = s->instr.opcode == JMP;
+    uint16_t actual = isBranch ? s->instr.imm : s->nextPC;
+    uint16_t predicted = predictedNext(s);
+    PredictorStats *st = &p->stats.bp;
+
+    updatePredictor(&p->bp, s->pc, isBranch, s->instr.imm, &s->pred);
+
+    if (isBranch)
+    {
+        st->branches++;
+        if (predicted == actual)
+            st->correct++;
+        else if (!s->pred.btbHit)
+            st->btbMisses++;
+        else if (!s->pred.taken)
+            st->directionMisses++;
+        else
+            st->wrongTargets++;
+    }
+    else if (predicted != actual)
+    {
+        st->falseHits++;
+    }
+
+    if (predicted == actual)
+    {
+        return false;
+    }
+    st->penaltyCycles++;
+    p->fetchPC = actual;
+    p->fetchStopped = (s->instr.opcode == HALT || s->instr.opcode == INVALID);
+    return true;
+}
+
+// WB: 명령어 완료, 멈춰야 하면 false
+static bool pipeWriteback(VM *vm, Pipeline *p, const PipeSlot *s)
+{
+    if (!s->valid)
+    {
+        return true;
+    }
+
+    // 오류/HALT는 PC를 그 명령어 위치에 두고 멈춤 (runVM()과 같음)
+    if (s->fault)
+    {
+        printf("PC out of memory range!\n");
+        vm->cpu.PC = s->pc;
+        vm->running = false;
+        return false;
+    }
+    if (s->memFault)
+    {
+        wideAccessError(vm, s->instr.opcode, s->instr.imm, s->pc);
+        vm->cpu.PC = s->pc;
+        vm->running = false;
+        return false;
+    }
+    if (s->instr.opcode == INVALID)
+    {
+        printf("Invalid opcode\n");
+        vm->cpu.PC = s->pc;
+        vm->running = false;
+        return false;
+    }
+    PERF_INC(vm, retired);
+    PERF_INC(vm, opcodes[s->instr.opcode]);
+    if (s->instr.opcode == HALT)
+    {
+        vm->cpu.PC = s->pc;
+        vm->running = false;
+        p->stats.retired++;
+        return false;
+    }
+
+    if (s->dst != NO_REG)
+    {
+        vm->cpu.regs[s->dst] = s->result;
+    }
+    vm->cpu.PC = s->nextPC;
+    p->stats.retired++;
+    return true;
+}
+
+// s가 [addr]를 명령어 바이트로 가지고 있는지
+static bool coversByte(const PipeSlot *s, uint8_t addr)
+{
+    return s->valid && !s->fault && addr >= s->pc && addr < s->nextPC;
+}
+
+// MOV_RF/MOV_FR 데이터 접근 (페이지 메모리는 캐시 없이 memLatency)
+static void chargeWide(VM *vm, Pipeline *p, AccessKind kind, uint32_t addr)
+{
+    if (!vm->mem)
+    {
+        return;
+    }
+    uint32_t latency = memAccessWide(vm->mem, kind, addr);
+    if (latency > 1)
+    {
+        p->memStall += latency - 1;
+    }
+}
+
+// MEM: load/store, 뒤쪽 명령어를 버려야 하면 true
+static bool pipeMemory(VM *vm, Pipeline *p, const PipeSlot *s, const PipeSlot *oldIdEx, const PipeSlot *oldIfId)
+{
+    p->memWb = *s;
+    if (!s->valid)
+    {
+        return false;
+    }
+
+    uint32_t addr = s->instr.imm;
+    switch (s->instr.opcode)
+    {
+    case MOV_RM:
+        PERF_INC(vm, memWrites);
+        chargeMemory(vm, p, MEM_WRITE, s->instr.imm, 1);
+        vm->memory[s->instr.imm] = s->result;
+        MARK_DIRTY(vm, s->instr.imm);
+        // 이미 fetch한 뒤쪽 명령어의 바이트를 바꿨으면 다시 fetch
+        if (coversByte(oldIdEx, s->instr.imm) || coversByte(oldIfId, s->instr.imm))
+        {
+            p->stats.smcFlushes++;
+            return true;
+        }
+        break;
+
+    case MOV_MR:
+        PERF_INC(vm, memReads);
+        chargeMemory(vm, p, MEM_READ, s->instr.imm, 1);
+        p->memWb.result = vm->memory[s->instr.imm];
+        break;
+
+    case MOV_RF:
+        if (!wideStore(vm, addr, s->result))
+        {
+            p->memWb.memFault = true;
+            break;
+        }
+        PERF_INC(vm, memWrites);
+        chargeWide(vm, p, MEM_WRITE, addr);
+        if (addr < MEMORY_SIZE && (coversByte(oldIdEx, (uint8_t)addr) || coversByte(oldIfId, (uint8_t)addr)))
+        {
+            p->stats.smcFlushes++;
+            return true;
+        }
+        break;
+
+    case MOV_FR:
+        if (!wideLoad(vm, addr, &p->memWb.result))
+        {
+            p->memWb.memFault = true;
+            break;
+        }
+        PERF_INC(vm, memReads);
+        chargeWide(vm, p, MEM_READ, addr);
+        break;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+// 포워딩 경로에서 값 선택
+static uint8_t operand(uint8_t path, uint8_t regValue, const PipeSlot *oldExMem, const PipeSlot *oldMemWb)
+{
+    switch (path)
+    {
+    case FWD_EXMEM:
+        return oldExMem->result;
+    case FWD_MEMWB:
+        return oldMemWb->result;
+    default:
+        return regValue;
+    }
+}
+
+// EX: ALU, JMP면 true (뒤쪽을 버리고 대상에서 fetch)
+static bool pipeExecute(Pipeline *p, const PipeSlot *s, const PipeSlot *oldExMem, const PipeSlot *oldMemWb)
+{
+    p->exMem = *s;
+    if (!s->valid)
+    {
+        return false;
+    }
+
+    PipeSlot *out = &p->exMem;
+    uint8_t a = operand(s->fwdA, s->valA, oldExMem, oldMemWb);
+    uint8_t b = operand(s->fwdB, s->valB, oldExMem, oldMemWb);
+
+    switch (s->instr.opcode)
+    {
+    case MOV_RR:
+    case MOV_RM: // 저장할 값
+    case MOV_RF:
+        out->result = b;
+        break;
+    case ADD_RR:
+        out->result = (uint8_t)(a + b);
+        break;
+    case SUB_RR:
+        out->result = (uint8_t)(a - b);
+        break;
+    case JMP:
+        out->nextPC = s->instr.imm;
+        // 분기 예측기가 있으면 이미 ID에서 대상으로 바꿨음
+        if (p->cfg.predictor != BP_NONE)
+        {
+            break;
+        }
+        p->fetchPC = s->instr.imm;
+        p->fetchStopped = false;
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+// src를 EX에서 쓸 수 있는지 확인하고 포워딩 경로를 정함, 멈춰야 하면 false
+// producer1 = 지금 EX에 있는 명령어 (다음 클록에 EX/MEM 래치), producer2 = 지금 MEM (다음 클록에 MEM/WB)
+static bool resolveSource(Pipeline *p, uint8_t src, const PipeSlot *producer1, const PipeSlot *producer2,
+                          uint8_t *path, bool *loadUse)
+{
+    *path = FWD_NONE;
+    if (src == NO_REG)
+    {
+        return true;
+    }
+    if (producer1->valid && producer1->dst == src)
+    {
+        // load 값은 MEM이 끝나야 나오므로 한 클록은 반드시 기다림
+        if (producer1->instr.opcode == MOV_MR || producer1->instr.opcode == MOV_FR)
+        {
+            *loadUse = true;
+            return false;
+        }
+        if (!p->cfg.forwardExEx)
+        {
+            return false;
+        }
+        *path = FWD_EXMEM;
+        return true;
+    }
+    if (producer2->valid && producer2->dst == src)
+    {
+        if (!p->cfg.forwardMemEx)
+        {
+            return false;
+        }
+        *path = FWD_MEMWB;
+        return true;
+    }
+    // 더 앞선 명령어는 이번 클록 WB에서 이미 레지스터에 씀
+    return true;
+}
+
+// ID: 해저드 검사 후 레지스터 읽기, 멈추거나 예측이 틀려 이번 클록 fetch를 건너뛰면 false
+static bool pipeDecode(VM *vm, Pipeline *p, const PipeSlot *s, const PipeSlot *oldIdEx, const PipeSlot *oldExMem)
+{
+    p->idEx = bubble;
+    if (!s->valid)
+    {
+        return true;
+    }
+
+    uint8_t fwdA, fwdB;
+    bool loadUse = false;
+    if (!resolveSource(p, s->srcA, oldIdEx, oldExMem, &fwdA, &loadUse) ||
+        !resolveSource(p, s->srcB, oldIdEx, oldExMem, &fwdB, &loadUse))
+    {
+        if (loadUse)
+            p->stats.loadUseStalls++;
+        else
+            p->stats.rawStalls++;
+        return false;
+    }
+
+    p->idEx = *s;
+    p->idEx.fwdA = fwdA;
+    p->idEx.fwdB = fwdB;
+    p->idEx.valA = (s->srcA != NO_REG) ? vm->cpu.regs[s->srcA] : 0;
+    p->idEx.valB = (s->srcB != NO_REG) ? vm->cpu.regs[s->srcB] : 0;
+    p->ifId = bubble;
+
+    if (p->cfg.predictor != BP_NONE && verifyPrediction(p, s))
+    {
+        return false;
+    }
+    return true;
+}
+
+// 한 클록
+static void pipelineClock(VM *vm, Pipeline *p)
+{
+    const PipeSlot oldIfId = p->ifId;
+    const PipeSlot oldIdEx = p->idEx;
+    const PipeSlot oldExMem = p->exMem;
+    const PipeSlot oldMemWb = p->memWb;
+
+    p->stats.cycles++;
+    PERF_INC(vm, cycles);
+
+    if (p->memStall > 0)
+    {
+        p->memStall--;
+        p->stats.memStalls++;
+        vm->mem->stallCycles++;
+        PERF_INC(vm, stallCycles);
+        return;
+    }
+
+    // 단계 점유 (IF는 pipeFetch에서)
+    PERF_ADD(vm, stageBusy[STAGE_DECODE], oldIfId.valid);
+    PERF_ADD(vm, stageBusy[STAGE_EXECUTE], oldIdEx.valid);
+    PERF_ADD(vm, stageBusy[STAGE_MEMORY], oldExMem.valid);
+    PERF_ADD(vm, stageBusy[STAGE_WRITEBACK], oldMemWb.valid);
+
+    if (!pipeWriteback(vm, p, &oldMemWb))
+    {
+        return;
+    }
+
+    if (pipeMemory(vm, p, &oldExMem, &oldIdEx, &oldIfId))
+    {
+        // 자기 수정 코드: store 다음 명령어부터 바뀐 메모리로 다시 fetch
+        p->exMem = bubble;
+        p->idEx = bubble;
+        p->fetchPC = oldExMem.nextPC;
+        p->fetchStopped = false;
+        pipeFetch(vm, p);
+        return;
+    }
+
+    if (pipeExecute(p, &oldIdEx, &oldExMem, &oldMemWb))
+    {
+        // JMP: ID에 있던 명령어와 이번 클록에 fetch할 슬롯을 버림
+        p->stats.jmpFlushes++;
+        p->stats.flushBubbles += 2;
+        p->idEx = bubble;
+        p->ifId = bubble;
+        return;
+    }
+
+    if (pipeDecode(vm, p, &oldIfId, &oldIdEx, &oldExMem) && !p->fetchStopped)
+    {
+        pipeFetch(vm, p);
+    }
+}
+
+// 제한에 걸려 멈출 때: MEM까지 끝난 명령어는 완료하고 나머지는 버림
+static void pipelinePause(VM *vm, Pipeline *p)
+{
+    if (!pipeWriteback(vm, p, &p->memWb))
+    {
+        return;
+    }
+    const PipeSlot *inFlight[] = {&p->exMem, &p->idEx, &p->ifId};
+    vm->cpu.PC = p->fetchPC;
+    for (int i = 0; i < 3; i++)
+    {
+        if (inFlight[i]->valid)
+        {
+            vm->cpu.PC = inFlight[i]->pc;
+            break;
+        }
+    }
+}
+
+uint64_t runPipeline(VM *vm, uint64_t maxCycles, const PipelineConfig *cfg, PipelineStats *stats)
+{
+    return runPipelineWith(vm, maxCycles, 0, cfg, NULL, stats);
+}
+
+uint64_t runPipelineWith(VM *vm, uint64_t maxCycles, uint64_t maxRetired, const PipelineConfig *cfg,
+                         BranchPredictor *bp, PipelineStats *stats)
+{
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.ifId = p.idEx = p.exMem = p.memWb = bubble;
+    p.fetchPC = vm->cpu.PC;
+    if (cfg)
+        p.cfg = *cfg;
+    else
+        initPipelineConfig(&p.cfg);
+    if (bp)
+        p.bp = *bp;
+    else
+        initPredictor(&p.bp, p.cfg.predictor);
+
+    vm->running = true;
+    while (vm->running && (maxCycles == 0 || p.stats.cycles < maxCycles) &&
+           (maxRetired == 0 || p.stats.retired < maxRetired))
+    {
+        pipelineClock(vm, &p);
+    }
+    if (vm->running)
+    {
+        pipelinePause(vm, &p);
+    }
+    if (bp)
+    {
+        *bp = p.bp;
+    }
+
+    if (stats)
+    {
+        stats->cycles += p.stats.cycles;
+        stats->retired += p.stats.retired;
+        stats->rawStalls += p.stats.rawStalls;
+        stats->loadUseStalls += p.stats.loadUseStalls;
+        stats->jmpFlushes += p.stats.jmpFlushes;
+        stats->flushBubbles += p.stats.flushBubbles;
+        stats->smcFlushes += p.stats.smcFlushes;
+        stats->memStalls += p.stats.memStalls;
+        stats->predictor = p.cfg.predictor;
+        stats->bp.lookups += p.stats.bp.lookups;
+        stats->bp.btbHits += p.stats.bp.btbHits;
+        stats->bp.branches += p.stats.bp.branches;
+        stats->bp.correct += p.stats.bp.correct;
+        stats->bp.btbMisses += p.stats.bp.btbMisses;
+        stats->bp.directionMisses += p.stats.bp.directionMisses;
+        stats->bp.wrongTargets += p.stats.bp.wrongTargets;
+        stats->bp.falseHits += p.stats.bp.falseHits;
+        stats->bp.penaltyCycles += p.stats.bp.penaltyCycles;
+    }
+    return p.stats.cycles;
+}
+
+void printPipelineStats(const PipelineStats *stats)
+{
+    printf("----- Pipeline -----\n");
+    printf("cycles          = %llu\n", (unsigned long long)stats->cycles);
+    printf("retired         = %llu\n", (unsigned long long)stats->retired);
+    printf("CPI             = %.3f\n", stats->retired ? (double)stats->cycles / stats->retired : 0.0);
+    printf("RAW stalls      = %llu\n", (unsigned long long)stats->rawStalls);
+    printf("load-use stalls = %llu\n", (unsigned long long)stats->loadUseStalls);
+    printf("JMP flushes     = %llu (%llu bubbles)\n", (unsigned long long)stats->jmpFlushes,
+           (unsigned long long)stats->flushBubbles);
+    printf("SMC flushes     = %llu\n", (unsigned long long)stats->smcFlushes);
+    if (stats->memStalls)
+    {
+        printf("cache stalls    = %llu\n", (unsigned long long)stats->memStalls);
+    }
+    if (stats->predictor != BP_NONE)
+    {
+        printPredictorStats(stats->predictor, &stats->bp);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "cpu.h"
+#include "bpred.h"
+
+// 래치의 레지스터 필드가 비어 있음
+#define NO_REG 0xFF
+
+// EX 단계 피연산자를 어디서 가져오는지
+typedef enum {
+    FWD_NONE,  // ID에서 읽은 레지스터 파일 값
+    FWD_EXMEM, // EX->EX: 바로 앞 명령어의 ALU 결과 (EX/MEM 래치)
+    FWD_MEMWB  // MEM->EX: 두 개 앞 명령어의 결과 (MEM/WB 래치, load 값 포함)
+} ForwardPath;
+
+// 단계 사이 래치에 들어 있는 명령어 하나
+typedef struct {
+    bool valid;        // false = 버블
+    bool fault;        // 메모리 밖 PC에서 fetch (WB에서 오류로 처리)
+    bool memFault;     // MOV_RF/MOV_FR 주소가 주소 공간 밖 (MEM에서 표시, WB에서 오류로 처리)
+    uint16_t pc;
+    uint16_t nextPC;   // 순차 실행 시 다음 PC (JMP는 EX에서 대상으로 바뀜)
+    Instruction instr;
+    uint8_t srcA;      // 읽는 레지스터 (NO_REG = 없음)
+    uint8_t srcB;
+    uint8_t dst;       // 쓰는 레지스터 (NO_REG = 없음)
+    uint8_t valA;      // ID에서 읽은 값
+    uint8_t valB;
+    uint8_t fwdA;      // ForwardPath
+    uint8_t fwdB;
+    uint8_t result;    // EX 결과 (ALU 값, 저장할 값) 또는 MEM에서 읽은 값
+    Prediction pred;   // IF에서 한 분기 예측 (ID에서 확인)
+} PipeSlot;
+
+// 포워딩 설정
+typedef struct {
+    bool forwardExEx;  // EX->EX 경로
+    bool forwardMemEx; // MEM->EX 경로
+    PredictorKind predictor; // 분기 예측기 (BP_NONE = JMP는 EX에서 처리)
+} PipelineConfig;
+
+// 실행 통계
+typedef struct {
+    uint64_t cycles;
+    uint64_t retired;       // WB까지 간 명령어 수
+    uint64_t rawStalls;     // RAW 해저드로 ID에서 멈춘 클록 (load-use 제외)
+    uint64_t loadUseStalls; // MOV_MR/MOV_FR 결과를 바로 쓰려다 멈춘 클록
+    uint64_t jmpFlushes;    // EX에서 JMP로 비운 횟수
+    uint64_t flushBubbles;  // JMP로 버린 fetch 슬롯 수 (버블 클록)
+    uint64_t smcFlushes;    // 이미 fetch한 명령어에 MOV_RM이 써서 비운 횟수
+    uint64_t memStalls;     // 캐시 미스로 파이프라인 전체가 멈춘 클록
+    PredictorKind predictor; // 통계를 낸 예측기
+    PredictorStats bp;
+} PipelineStats;
+
+// IF/ID/EX/MEM/WB 5단 파이프라인
+typedef struct {
+    PipeSlot ifId;
+    PipeSlot idEx;
+    PipeSlot exMem;
+    PipeSlot memWb;
+    uint16_t fetchPC;
+    bool fetchStopped; // HALT/INVALID/PC 오류를 fetch한 뒤 방향이 바뀔 때까지 fetch 중단
+    uint32_t memStall; // 캐시 미스로 남은 대기 클록 (그동안 모든 단계 정지)
+    PipelineConfig cfg;
+    PipelineStats stats;
+    BranchPredictor bp; // runPipeline() 호출마다 새로 학습 (runPipelineWith()는 호출한 쪽 것을 이어 씀)
+} Pipeline;
+
+// 파이프라인 설정 기본값 (포워딩 모두 사용, 분기 예측 없음)
+void initPipelineConfig(PipelineConfig *cfg);
+
+/**
+ * 5단 파이프라인으로 실행 (명령어가 최대 5개까지 겹쳐서 진행)
+ * 결과(레지스터, 메모리, 최종 PC)는 runVM()과 같고 클록 수만 다르다.
+ * maxCycles = 0 이면 제한 없음. 제한에 걸리면 MEM까지 끝난 명령어만 완료하고
+ * 나머지는 버린 뒤 다음 명령어 PC에서 멈춤 (다시 호출하면 이어서 실행)
+ * stats가 NULL이 아니면 통계를 더함, 실행한 클록 수를 반환
+ */
+uint64_t runPipeline(VM *vm, uint64_t maxCycles, const PipelineConfig *cfg, PipelineStats *stats);
+
+/**
+ * runPipeline()에 명령어 수 제한과 예측기 상태를 더한 것 (샘플링 시뮬레이션, sample.h)
+ * maxRetired개가 WB를 지나면 같은 방식으로 멈춤 (0 = 제한 없음, 멈출 때 하나 더 끝날 수 있음)
+ * bp가 NULL이 아니면 그 예측기로 시작하고 끝난 뒤 학습 상태를 돌려줌 (cfg->predictor로 초기화해 둘 것)
+ */
+uint64_t runPipelineWith(VM *vm, uint64_t maxCycles, uint64_t maxRetired, const PipelineConfig *cfg,
+                         BranchPredictor *bp, PipelineStats *stats);
+
+// 통계 출력 (CPI, 스톨/플러시 내역, 분기 예측기)
+void printPipelineStats(const PipelineStats *stats);
+
+#endif
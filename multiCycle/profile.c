@@ -0,0 +1,558 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include "profile.h"
+#include "load.h"
+#include "paged.h"
+
+bool parseProfileSpec(Profile *prof, const char *spec)
+{
+    memset(prof, 0, sizeof(*prof));
+    if (strcmp(spec, "exact") == 0)
+    {
+        prof->mode = PROFILE_EXACT;
+        return true;
+    }
+
+    const char *colon = strchr(spec, ':');
+    if (!colon)
+    {
+        return false;
+    }
+    size_t len = (size_t)(colon - spec);
+    if (len == 5 && memcmp(spec, "every", 5) == 0)
+    {
+        prof->mode = PROFILE_SAMPLED;
+    }
+    else if (len == 5 && memcmp(spec, "timer", 5) == 0)
+    {
+        prof->mode = PROFILE_TIMER;
+    }
+    else
+    {
+        return false;
+    }
+    char *end;
+    unsigned long period = strtoul(colon + 1, &end, 0);
+    if (*end != '\0' || period == 0 || period > 0x7FFFFFFFul)
+    {
+        return false;
+    }
+    prof->period = (uint32_t)period;
+    return true;
+}
+
+/*  -------------------------------------
+        실행
+    -------------------------------------
+*/
+
+// 다음 클록을 쓸 칸 (캐시 대기 중이면 stall)
+static inline int currentSlot(const VM *vm)
+{
+    return vm->cpu.memStall ? PROFILE_STALL : (int)vm->cpu.stage;
+}
+
+// exact: runVMFor()와 같은 루프, 클록마다 PC와 단계 카운터 하나
+static uint64_t runExact(VM *vm, uint64_t maxCycles, Profile *prof)
+{
+    uint64_t cycles = 0;
+    vm->running = true;
+    while (vm->running && (maxCycles == 0 || cycles < maxCycles))
+    {
+        uint16_t pc = vm->cpu.PC;
+        if (pc < MEMORY_SIZE)
+        {
+            int slot = currentSlot(vm);
+            prof->cycles[pc][slot]++;
+            prof->hits[pc] += (slot == STAGE_FETCH);
+        }
+        multiCycleStep(vm);
+        cycles++;
+    }
+    return cycles;
+}
+
+// every:N: runVMFor()를 조각으로 나눠 부르고 조각 사이에서 다음 클록의 PC와 단계를 기록
+static uint64_t runSampled(VM *vm, uint64_t maxCycles, Profile *prof)
+{
+    uint64_t cycles = 0;
+    uint32_t rng = 0x9E3779B9u; // xorshift (실행마다 같은 조각 길이)
+    for (;;)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        uint64_t chunk = prof->period / 2 + rng % prof->period + 1;
+        if (maxCycles && maxCycles - cycles < chunk)
+        {
+            chunk = maxCycles - cycles;
+        }
+        cycles += runVMFor(vm, chunk);
+        if (!vm->running || (maxCycles && cycles >= maxCycles))
+        {
+            break;
+        }
+        if (vm->cpu.PC < MEMORY_SIZE)
+        {
+            prof->cycles[vm->cpu.PC][currentSlot(vm)]++;
+        }
+    }
+    return cycles;
+}
+
+// timer:US: SIGPROF 핸들러가 그 순간 VM에 있는 PC와 단계를 기록 (한 번에 VM 하나만)
+static Profile *volatile timerProfile;
+static const VM *volatile timerVM;
+
+static void onProfileTimer(int sig)
+{
+    (void)sig;
+    uint16_t pc = timerVM->cpu.PC;
+    if (pc < MEMORY_SIZE)
+    {
+        timerProfile->cycles[pc][currentSlot(timerVM)]++;
+    }
+}
+
+static uint64_t runTimer(VM *vm, uint64_t maxCycles, Profile *prof)
+{
+    struct sigaction sa, old;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onProfileTimer;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+
+    timerProfile = prof;
+    timerVM = vm;
+    sigaction(SIGPROF, &sa, &old);
+
+    struct itimerval it;
+    it.it_interval.tv_sec = prof->period / 1000000;
+    it.it_interval.tv_usec = prof->period % 1000000;
+    it.it_value = it.it_interval;
+    setitimer(ITIMER_PROF, &it, NULL);
+
+    uint64_t cycles = runVMFor(vm, maxCycles);
+
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_PROF, &it, NULL);
+    sigaction(SIGPROF, &old, NULL);
+    timerProfile = NULL;
+    timerVM = NULL;
+    return cycles;
+}
+
+uint64_t runProfiled(VM *vm, uint64_t maxCycles, Profile *prof)
+{
+    uint64_t cycles;
+    switch (prof->mode)
+    {
+    case PROFILE_SAMPLED:
+        cycles = runSampled(vm, maxCycles, prof);
+        break;
+    case PROFILE_TIMER:
+        cycles = runTimer(vm, maxCycles, prof);
+        break;
+    case PROFILE_EXACT:
+    default:
+        cycles = runExact(vm, maxCycles, prof);
+        break;
+    }
+
+    prof->steps += cycles;
+    prof->total = 0;
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+        {
+            prof->total += prof->cycles[pc][slot];
+        }
+    }
+    return cycles;
+}
+
+// PC 하나의 클록 수 (샘플 모드면 샘플 수)
+static uint64_t pcCycles(const Profile *prof, int pc)
+{
+    uint64_t sum = 0;
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+    {
+        sum += prof->cycles[pc][slot];
+    }
+    return sum;
+}
+
+// 단계 칸 이름
+static const char *slotName(int slot)
+{
+    return (slot == PROFILE_STALL) ? "stall" : stageName(slot);
+}
+
+/*  -------------------------------------
+        소스 줄, 명령어 표시
+    -------------------------------------
+*/
+
+typedef struct {
+    char *text;                   // 파일 전체 (줄마다 '\0')
+    char **lines;                 // lines[i] = i+1번째 줄
+    uint32_t count;               // 줄 수 (0 = 소스 없음)
+    uint32_t pcLine[MEMORY_SIZE]; // 명령어 시작 주소별 줄 번호 (0 = 없음)
+} SourceListing;
+
+// 소스를 읽고 주소별 줄 번호를 채움, 없거나 이미지면 count = 0
+static void openSource(SourceListing *src, const char *path)
+{
+    memset(src, 0, sizeof(*src));
+    if (!path || !loadSourceLines(path, src->pcLine))
+    {
+        return;
+    }
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        return;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    src->text = (size >= 0) ? malloc((size_t)size + 1) : NULL;
+    if (!src->text || fread(src->text, 1, (size_t)size, fp) != (size_t)size)
+    {
+        fclose(fp);
+        free(src->text);
+        src->text = NULL;
+        return;
+    }
+    fclose(fp);
+    src->text[size] = '\0';
+
+    // 마지막 줄에 '\n'이 없어도 한 줄
+    uint32_t lines = (size > 0 && src->text[size - 1] != '\n');
+    for (long i = 0; i < size; i++)
+    {
+        lines += (src->text[i] == '\n');
+    }
+    src->lines = malloc((lines + 1) * sizeof(char *));
+    if (!src->lines)
+    {
+        return;
+    }
+    char *p = src->text;
+    while (src->count < lines)
+    {
+        src->lines[src->count++] = p;
+        char *nl = strchr(p, '\n');
+        if (!nl)
+        {
+            break;
+        }
+        *nl = '\0';
+        if (nl > p && nl[-1] == '\r')
+        {
+            nl[-1] = '\0';
+        }
+        p = nl + 1;
+    }
+    // 이미지처럼 줄 정보가 하나도 없으면 목록을 만들지 않음
+    bool mapped = false;
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        mapped |= (src->pcLine[pc] != 0 && src->pcLine[pc] <= src->count);
+    }
+    if (!mapped)
+    {
+        src->count = 0;
+    }
+}
+
+static void closeSource(SourceListing *src)
+{
+    free(src->lines);
+    free(src->text);
+}
+
+// pc에 있는 명령어의 소스 줄 (앞 공백 제외, 없으면 NULL)
+static const char *sourceText(const SourceListing *src, uint16_t pc)
+{
+    uint32_t line = src->pcLine[pc];
+    if (line == 0 || line > src->count)
+    {
+        return NULL;
+    }
+    const char *p = src->lines[line - 1];
+    while (*p == ' ' || *p == '\t')
+    {
+        p++;
+    }
+    return p;
+}
+
+// 지금 메모리에 있는 명령어 ("ADD_RR 0 1", 넓은 주소는 16진수)
+static void describeInstruction(const VM *vm, uint16_t pc, char *buf, size_t size)
+{
+    uint8_t op = vm->memory[pc];
+    int len = snprintf(buf, size, "%s", opcodeName(op < INVALID ? op : INVALID));
+    if (op == MOV_RF || op == MOV_FR)
+    {
+        uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(op));
+        uint8_t reg = wideRegister(vm, pc);
+        if (WIDE_ADDR_OFFSET(op) == 1)
+            snprintf(buf + len, size - len, " 0x%X %u", addr, reg);
+        else
+            snprintf(buf + len, size - len, " %u 0x%X", reg, addr);
+        return;
+    }
+    Instruction instr = {.opcode = (Opcode)op};
+    uint16_t n = getInstructionSize(&instr);
+    for (uint16_t i = 1; i < n && pc + i < MEMORY_SIZE && (size_t)len < size; i++)
+    {
+        len += snprintf(buf + len, size - len, " %u", vm->memory[pc + i]);
+    }
+}
+
+// 실행된 PC를 기본 블록으로 묶음 (leader[pc] = 블록 첫 PC)
+// 앞 명령어와 이어지지 않거나, 앞이 JMP/HALT거나, 실행된 JMP의 대상이면 새 블록
+static void findBlocks(const Profile *prof, const VM *vm, uint16_t leader[MEMORY_SIZE])
+{
+    bool target[MEMORY_SIZE] = {false};
+    for (int pc = 0; pc + 1 < MEMORY_SIZE; pc++)
+    {
+        if (pcCycles(prof, pc) && vm->memory[pc] == JMP)
+        {
+            target[vm->memory[pc + 1]] = true;
+        }
+    }
+
+    int next = -1;
+    bool branch = false;
+    uint16_t current = 0;
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        if (!pcCycles(prof, pc))
+        {
+            continue;
+        }
+        if (pc != next || branch || target[pc])
+        {
+            current = (uint16_t)pc;
+        }
+        leader[pc] = current;
+        Instruction instr = {.opcode = (Opcode)vm->memory[pc]};
+        next = pc + getInstructionSize(&instr);
+        branch = (instr.opcode == JMP || instr.opcode == HALT);
+    }
+}
+
+/*  -------------------------------------
+        보고서
+    -------------------------------------
+*/
+
+static void printHeader(const Profile *prof)
+{
+    switch (prof->mode)
+    {
+    case PROFILE_SAMPLED:
+        printf("----- Profile (every ~%u cycles, %llu samples of %llu cycles) -----\n", prof->period,
+               (unsigned long long)prof->total, (unsigned long long)prof->steps);
+        break;
+    case PROFILE_TIMER:
+        printf("----- Profile (timer %u us, %llu samples of %llu cycles) -----\n", prof->period,
+               (unsigned long long)prof->total, (unsigned long long)prof->steps);
+        break;
+    default:
+        printf("----- Profile (exact, %llu cycles) -----\n", (unsigned long long)prof->steps);
+        break;
+    }
+}
+
+void printProfileReport(const Profile *prof, const VM *vm, const char *source)
+{
+    SourceListing src;
+    openSource(&src, source);
+    double total = prof->total ? (double)prof->total : 1.0;
+    bool exact = (prof->mode == PROFILE_EXACT);
+
+    printHeader(prof);
+
+    // 단계별 합계
+    uint64_t slotTotal[PROFILE_SLOTS] = {0};
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+        {
+            slotTotal[slot] += prof->cycles[pc][slot];
+        }
+    }
+    printf("by stage:");
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+    {
+        printf(" %s %.1f%%", slotName(slot), 100.0 * slotTotal[slot] / total);
+    }
+    printf("\n");
+
+    // 핫스팟: 클록이 많은 PC부터 (같으면 작은 PC부터), exact면 명령어 수와 명령어당 클록
+    bool shown[MEMORY_SIZE] = {false};
+    printf("   PC %12s       %%", exact ? "cycles" : "samples");
+    if (exact)
+        printf("   instrs    CPI");
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+        printf(" %5s", slotName(slot));
+    printf("  instruction\n");
+    for (int rank = 0; rank < PROFILE_TOP; rank++)
+    {
+        int best = -1;
+        uint64_t bestCycles = 0;
+        for (int pc = 0; pc < MEMORY_SIZE; pc++)
+        {
+            uint64_t c = pcCycles(prof, pc);
+            if (!shown[pc] && c && (best < 0 || c > bestCycles))
+            {
+                best = pc;
+                bestCycles = c;
+            }
+        }
+        if (best < 0)
+        {
+            break;
+        }
+        shown[best] = true;
+
+        printf("%5d %12llu %6.2f%%", best, (unsigned long long)bestCycles, 100.0 * bestCycles / total);
+        if (exact)
+        {
+            printf(" %8llu %6.2f", (unsigned long long)prof->hits[best],
+                   prof->hits[best] ? (double)bestCycles / prof->hits[best] : 0.0);
+        }
+        for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+        {
+            printf(" %5llu", (unsigned long long)prof->cycles[best][slot]);
+        }
+        char desc[64];
+        describeInstruction(vm, (uint16_t)best, desc, sizeof(desc));
+        printf("  %-22s", desc);
+        const char *text = sourceText(&src, (uint16_t)best);
+        if (text)
+        {
+            printf(" %s:%u: %s", source, src.pcLine[best], text);
+        }
+        printf("\n");
+    }
+
+    // 소스 목록: 명령어가 있는 줄에 클록 수와 비율
+    if (src.count)
+    {
+        uint64_t *lineCycles = calloc(src.count + 1, sizeof(uint64_t));
+        bool *isCode = calloc(src.count + 1, sizeof(bool));
+        if (lineCycles && isCode)
+        {
+            for (int pc = 0; pc < MEMORY_SIZE; pc++)
+            {
+                uint32_t line = src.pcLine[pc];
+                if (line && line <= src.count)
+                {
+                    lineCycles[line] += pcCycles(prof, pc);
+                    isCode[line] = true;
+                }
+            }
+            printf("----- Annotated source (%s) -----\n", source);
+            for (uint32_t line = 1; line <= src.count; line++)
+            {
+                if (isCode[line])
+                    printf("%12llu %6.2f%% ", (unsigned long long)lineCycles[line], 100.0 * lineCycles[line] / total);
+                else
+                    printf("%21s", "");
+                printf("%5u  %s\n", line, src.lines[line - 1]);
+            }
+            // 소스에 없는 주소 (자기 수정 코드로 생긴 명령어 등)
+            for (int pc = 0; pc < MEMORY_SIZE; pc++)
+            {
+                uint64_t c = pcCycles(prof, pc);
+                if (c && !src.pcLine[pc])
+                {
+                    char desc[64];
+                    describeInstruction(vm, (uint16_t)pc, desc, sizeof(desc));
+                    printf("%12llu %6.2f%% (no source line) PC=%d %s\n", (unsigned long long)c, 100.0 * c / total,
+                           pc, desc);
+                }
+            }
+        }
+        free(lineCycles);
+        free(isCode);
+    }
+    closeSource(&src);
+}
+
+// collapsed stack 한 칸: ';'와 주석은 빼고 앞뒤 공백 제거
+static void writeFrame(FILE *fp, const char *text)
+{
+    while (*text == ' ' || *text == '\t')
+    {
+        text++;
+    }
+    size_t len = strcspn(text, "#;");
+    while (len > 0 && (text[len - 1] == ' ' || text[len - 1] == '\t'))
+    {
+        len--;
+    }
+    fwrite(text, 1, len, fp);
+}
+
+bool writeCollapsedStacks(const Profile *prof, const VM *vm, const char *source, const char *path)
+{
+    FILE *fp = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    if (!fp)
+    {
+        printf("Failed to open %s\n", path);
+        return false;
+    }
+    SourceListing src;
+    openSource(&src, source);
+    uint16_t leader[MEMORY_SIZE];
+    findBlocks(prof, vm, leader);
+
+    const char *program = "vm";
+    if (source)
+    {
+        const char *slash = strrchr(source, '/');
+        program = slash ? slash + 1 : source;
+    }
+
+    // 맨 아래 칸은 단계 (명령어 하나가 어느 단계에서 클록을 쓰는지)
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        for (int slot = 0; slot < PROFILE_SLOTS; slot++)
+        {
+            if (!prof->cycles[pc][slot])
+            {
+                continue;
+            }
+            writeFrame(fp, program);
+            fprintf(fp, ";bb@%u;", leader[pc]);
+            const char *text = sourceText(&src, (uint16_t)pc);
+            if (text)
+            {
+                fprintf(fp, "%u: ", src.pcLine[pc]);
+                writeFrame(fp, text);
+            }
+            else
+            {
+                char desc[64];
+                describeInstruction(vm, (uint16_t)pc, desc, sizeof(desc));
+                fprintf(fp, "PC=%d %s", pc, desc);
+            }
+            fprintf(fp, ";%s %llu\n", slotName(slot), (unsigned long long)prof->cycles[pc][slot]);
+        }
+    }
+    closeSource(&src);
+
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "cpu.h"
+
+/**
+ * PC별 프로파일러 (-P, multicycle 엔진)
+ * 클록마다 그 클록을 쓴 명령어(PC)와 단계(IF/ID/EX/MEM/WB, 캐시 대기는 stall)를 셈
+ *   exact    : 모든 클록 + PC별 실행한 명령어 수 (runVMFor()와 같은 루프에 카운터 두 개)
+ *   every:N  : 평균 N 클록마다 다음 클록의 PC와 단계 하나를 기록
+ *              runVMFor()를 조각으로 나눠 부르므로 클록마다 드는 비용은 없음
+ *              (조각 길이를 N/2 ~ 3N/2로 흔들어서 루프 길이와 맞물려 같은 PC만 잡히지 않게)
+ *   timer:US : CPU 시간 US 마이크로초마다 SIGPROF 핸들러가 VM의 PC와 단계를 기록 (실행 루프는 그대로)
+ * 결과는 PC별 핫스팟, 소스 줄에 클록 수를 붙인 주석 목록, flamegraph용 collapsed stack
+ */
+
+#define PROFILE_TOP 10 // 핫스팟 목록에 보일 PC 수
+#define PROFILE_STALL PERF_STAGES // 캐시 미스 대기 클록 (단계 번호 다음 칸)
+#define PROFILE_SLOTS (PERF_STAGES + 1)
+
+typedef enum {
+    PROFILE_EXACT,
+    PROFILE_SAMPLED, // every:N
+    PROFILE_TIMER    // timer:US
+} ProfileMode;
+
+typedef struct {
+    ProfileMode mode;
+    uint32_t period;            // SAMPLED: 평균 클록 수, TIMER: 마이크로초
+    uint64_t cycles[MEMORY_SIZE][PROFILE_SLOTS]; // EXACT: 클록 수, 나머지: 샘플 수
+    uint64_t hits[MEMORY_SIZE]; // 실행을 시작한 명령어 수 (EXACT만)
+    uint64_t total;             // cycles 합
+    uint64_t steps;             // 실행한 클록 수
+} Profile;
+
+// -P 옵션 해석: "exact", "every:N", "timer:US" (prof를 비우고 모드를 설정, 잘못되면 false)
+bool parseProfileSpec(Profile *prof, const char *spec);
+
+// 프로파일하면서 실행 (maxCycles = 0 이면 제한 없음), 실행한 클록 수 반환
+uint64_t runProfiled(VM *vm, uint64_t maxCycles, Profile *prof);
+
+// 핫스팟 목록, source(프로그램 파일)가 있으면 줄마다 클록 수를 붙인 소스 목록 (NULL이면 생략)
+void printProfileReport(const Profile *prof, const VM *vm, const char *source);
+
+// collapsed stack ("프로그램;bb@PC;줄;단계 클록", flamegraph.pl 입력)을 path에 저장 ("-" = 표준 출력)
+bool writeCollapsedStacks(const Profile *prof, const VM *vm, const char *source, const char *path);
+
+#endif
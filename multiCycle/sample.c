@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "sample.h"
+#include "functional.h"
+
+bool parseSampleSpec(SampleConfig *cfg, const char *spec)
+{
+    uint64_t values[3] = {0, 0, 0};
+    const char *p = spec;
+    int count = 0;
+    while (count < 3)
+    {
+        char *end;
+        values[count++] = strtoull(p, &end, 0);
+        if (end == p || (*end != ':' && *end != '\0'))
+        {
+            return false;
+        }
+        if (*end == '\0')
+        {
+            break;
+        }
+        p = end + 1;
+    }
+    // 빨리 감기 0은 전부 상세 실행 (검증용), 측정 단위는 1 이상
+    if (count < 2 || *p == '\0' || values[1] == 0)
+    {
+        return false;
+    }
+    cfg->fastForward = values[0];
+    cfg->measure = values[1];
+    cfg->warmup = values[2];
+    return true;
+}
+
+/*  -------------------------------------
+        상세 실행과 측정
+    -------------------------------------
+*/
+
+void saveCounters(const VM *vm, CounterSnapshot *snap)
+{
+    if (vm->mem)
+    {
+        snap->l1i = vm->mem->l1i.stats;
+        snap->l1d = vm->mem->l1d.stats;
+        snap->l2 = vm->mem->l2.stats;
+        snap->stallCycles = vm->mem->stallCycles;
+        snap->pagedAccesses = vm->mem->pagedAccesses;
+    }
+#ifdef PERF_COUNTERS
+    snap->perf = vm->perf;
+#endif
+}
+
+void restoreCounters(VM *vm, const CounterSnapshot *snap)
+{
+    if (vm->mem)
+    {
+        vm->mem->l1i.stats = snap->l1i;
+        vm->mem->l1d.stats = snap->l1d;
+        vm->mem->l2.stats = snap->l2;
+        vm->mem->stallCycles = snap->stallCycles;
+        vm->mem->pagedAccesses = snap->pagedAccesses;
+    }
+#ifdef PERF_COUNTERS
+    vm->perf = snap->perf;
+#endif
+}
+
+uint64_t runDetailed(VM *vm, uint64_t count, const SampleConfig *cfg, BranchPredictor *bp, PipelineStats *stats,
+                     uint64_t *done)
+{
+    if (cfg->pipelined)
+    {
+        uint64_t before = stats->retired;
+        uint64_t cycles = runPipelineWith(vm, 0, count, &cfg->pipe, bp, stats);
+        *done = stats->retired - before;
+        return cycles;
+    }
+
+    uint64_t cycles = 0;
+    uint64_t n = 0;
+    while (vm->running && n < count)
+    {
+        cycles += runInstruction(vm, 0);
+        n++;
+    }
+    *done = n;
+    return cycles;
+}
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 남은 명령어 예산 안에서 한 구간의 길이
+static uint64_t phaseLength(uint64_t want, uint64_t executed, uint64_t maxInstructions)
+{
+    if (maxInstructions && maxInstructions - executed < want)
+    {
+        return maxInstructions - executed;
+    }
+    return want;
+}
+
+uint64_t runSampled(VM *vm, uint64_t maxInstructions, const SampleConfig *cfg, SampleStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    double t0 = nowSeconds();
+
+    // 예측기는 측정 단위 사이에 이어서 학습 (warming이 없으면 상세 실행 구간에서만)
+    BranchPredictor bp;
+    initPredictor(&bp, cfg->pipe.predictor);
+    FunctionalHooks warm;
+    initWarming(&warm, cfg->warming ? vm->mem : NULL,
+                (cfg->warming && cfg->pipelined && cfg->pipe.predictor >= BP_BTB) ? &bp : NULL);
+    warm.accel = cfg->accel;
+
+    PipelineStats scratch;
+    CounterSnapshot snap;
+    vm->running = true;
+
+    // 체크포인트에서 이어 실행하면 명령어 중간일 수 있으므로 먼저 끝냄 (재지 않음)
+    if (vm->cpu.stage != STAGE_FETCH)
+    {
+        saveCounters(vm, &snap);
+        runInstruction(vm, 0);
+        restoreCounters(vm, &snap);
+        stats->instructions++;
+        stats->detailed++;
+    }
+
+    while (vm->running && (maxInstructions == 0 || stats->instructions < maxInstructions))
+    {
+        uint64_t n = phaseLength(cfg->fastForward, stats->instructions, maxInstructions);
+        saveCounters(vm, &snap);
+        stats->instructions += runFunctional(vm, n, &warm);
+
+        n = phaseLength(cfg->warmup, stats->instructions, maxInstructions);
+        if (vm->running && n > 0)
+        {
+            uint64_t done;
+            memset(&scratch, 0, sizeof(scratch));
+            runDetailed(vm, n, cfg, &bp, &scratch, &done);
+            stats->instructions += done;
+            stats->detailed += done;
+        }
+        restoreCounters(vm, &snap);
+
+        n = phaseLength(cfg->measure, stats->instructions, maxInstructions);
+        if (!vm->running || n == 0)
+        {
+            break;
+        }
+        uint64_t done;
+        uint64_t cycles = runDetailed(vm, n, cfg, &bp, &stats->pipe, &done);
+        stats->instructions += done;
+        stats->detailed += done;
+
+        // HALT나 명령어 제한으로 잘린 단위는 길이가 달라서 평균에 넣지 않음
+        if (done >= cfg->measure)
+        {
+            double cpi = (double)cycles / done;
+            stats->units++;
+            stats->cycles += cycles;
+            stats->measured += done;
+            stats->cpiSum += cpi;
+            stats->cpiSquares += cpi * cpi;
+        }
+    }
+
+    stats->seconds = nowSeconds() - t0;
+    return stats->instructions;
+}
+
+void printSampleReport(const SampleConfig *cfg, const SampleStats *stats)
+{
+    printf("----- Sampled simulation -----\n");
+    printf("engine          = %s\n", cfg->pipelined ? "pipeline" : "multicycle");
+    printf("interval        = fast-forward %llu, warm-up %llu, measure %llu (warming %s)\n",
+           (unsigned long long)cfg->fastForward, (unsigned long long)cfg->warmup, (unsigned long long)cfg->measure,
+           cfg->warming ? "on" : "off");
+    printf("instructions    = %llu (%.2f%% detailed)\n", (unsigned long long)stats->instructions,
+           stats->instructions ? 100.0 * stats->detailed / stats->instructions : 0.0);
+    printf("sample units    = %llu\n", (unsigned long long)stats->units);
+    printf("host time       = %.3f s\n", stats->seconds);
+    if (stats->units == 0)
+    {
+        printf("No complete sample unit (program shorter than one interval, lower N or M)\n");
+        return;
+    }
+
+    // 단위별 CPI의 표본 평균과 표준 편차 (단위가 하나면 구간 없음)
+    double n = (double)stats->units;
+    double mean = stats->cpiSum / n;
+    double var = (stats->units > 1) ? (stats->cpiSquares - n * mean * mean) / (n - 1) : 0.0;
+    double sd = var > 0 ? sqrt(var) : 0.0;
+    double half = SAMPLE_Z * sd / sqrt(n);
+    double total = (double)stats->instructions;
+
+    printf("CPI             = %.4f +/- %.4f (95%%)\n", mean, half);
+    printf("est. cycles     = %.0f +/- %.0f (95%%)\n", mean * total, half * total);
+    if (stats->units > 1 && mean > 0)
+    {
+        // 목표 오차 안에 들려면 필요한 단위 수: (z * 변동 계수 / 오차)^2
+        double cv = sd / mean;
+        double needed = fmax(2.0, ceil(pow(SAMPLE_Z * cv / SAMPLE_TARGET_ERROR, 2)));
+        printf("CPI CV          = %.3f (%.0f units needed for +/-%.0f%%)\n", cv, needed, SAMPLE_TARGET_ERROR * 100);
+    }
+    else
+    {
+        printf("CPI CV          = - (need at least 2 units for a confidence interval)\n");
+    }
+}
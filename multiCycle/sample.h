@@ -0,0 +1,75 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include "cpu.h"
+#include "pipeline.h"
+#include "cache.h"
+#include "functional.h"
+
+/**
+ * 샘플링 시뮬레이션 (-S, SMARTS 방식)
+ * 클록 없이 명령어 단위로만 실행하는 빨리 감기와 상세 실행(multicycle 또는 pipeline)을 번갈아 반복
+ *
+ *   [빨리 감기 N][warm-up W][측정 M][빨리 감기 N][warm-up W][측정 M]...
+ *
+ * 빨리 감기는 기능 실행 코어(functional.h)로 같은 VM 상태를 바꾸기만 함 (상세 실행보다 훨씬 빠름)
+ * warming을 켜면 빨리 감기 중에도 캐시 태그와 분기 예측기를 갱신해서 측정 구간이 식은 상태로 시작하지 않게 함
+ * warm-up은 상세 실행하지만 재지 않는 구간 (파이프라인을 채우고 warming 없이도 캐시를 어느 정도 데움)
+ * 측정 구간마다 CPI를 구해서 평균 CPI와 신뢰 구간으로 전체 클록 수를 추정
+ * 캐시 통계, 파이프라인 통계, 성능 카운터는 측정 구간 것만 남김
+ */
+
+#define SAMPLE_Z 1.96            // 95% 신뢰 구간
+#define SAMPLE_TARGET_ERROR 0.03 // 필요한 측정 단위 수를 안내할 때 목표 상대 오차 (±3%)
+
+typedef struct {
+    uint64_t fastForward; // N: 측정 단위 사이에 빨리 감을 명령어 수
+    uint64_t warmup;      // W: 측정 전에 상세 실행만 하는 명령어 수
+    uint64_t measure;     // M: 측정 단위 (명령어 수)
+    bool warming;         // 빨리 감기 중에도 캐시/예측기 갱신 (-W)
+    LoopAccel *accel;     // 빨리 감기 루프 가속 (NULL = 끔, -L, warming 중에는 안 함)
+    bool pipelined;       // 상세 엔진 (false = multicycle)
+    PipelineConfig pipe;
+} SampleConfig;
+
+typedef struct {
+    uint64_t instructions; // 전체 실행한 명령어 (빨리 감기 + 상세)
+    uint64_t detailed;     // 그중 상세 실행한 명령어 (warm-up + 측정)
+    uint64_t units;        // 끝까지 잰 측정 단위 수
+    uint64_t cycles;       // 측정 단위의 클록 합
+    uint64_t measured;     // 측정 단위의 명령어 합
+    double cpiSum;         // 단위별 CPI 합 (평균, 분산용)
+    double cpiSquares;
+    double seconds;        // 호스트 실행 시간
+    PipelineStats pipe;    // 측정 구간 파이프라인 통계 (pipeline 엔진)
+} SampleStats;
+
+// 재지 않는 구간 동안 바뀐 통계를 되돌리기 위한 사본 (캐시 태그와 예측기 상태는 그대로 둠)
+typedef struct {
+    CacheStats l1i, l1d, l2;
+    uint64_t stallCycles;
+    uint64_t pagedAccesses;
+#ifdef PERF_COUNTERS
+    PerfCounters perf;
+#endif
+} CounterSnapshot;
+
+void saveCounters(const VM *vm, CounterSnapshot *snap);
+void restoreCounters(VM *vm, const CounterSnapshot *snap);
+
+// 상세 엔진(cfg->pipelined, cfg->pipe)으로 명령어 count개 (pipeline은 멈출 때 하나 더 끝날 수 있음)
+// bp는 pipeline이 이어 쓸 예측기, stats에 파이프라인 통계를 더함
+// 걸린 클록 수 반환, *done = 끝낸 명령어 수
+uint64_t runDetailed(VM *vm, uint64_t count, const SampleConfig *cfg, BranchPredictor *bp, PipelineStats *stats,
+                     uint64_t *done);
+
+// -S 옵션 해석: "N:M" 또는 "N:M:W" (warm-up 기본 0), 잘못되면 false
+bool parseSampleSpec(SampleConfig *cfg, const char *spec);
+
+// 샘플링하며 실행 (maxInstructions = 0 이면 HALT까지), 실행한 명령어 수 반환
+uint64_t runSampled(VM *vm, uint64_t maxInstructions, const SampleConfig *cfg, SampleStats *stats);
+
+// 평균 CPI와 신뢰 구간, 추정 전체 클록 수 출력
+void printSampleReport(const SampleConfig *cfg, const SampleStats *stats);
+
+#endif
@@ -0,0 +1,726 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "simpoint.h"
+#include "functional.h"
+#include "checkpoint.h"
+#include "paged.h"
+
+bool parseIntervalSpec(SimPointConfig *cfg, const char *spec)
+{
+    char *end;
+    uint64_t interval = strtoull(spec, &end, 0);
+    uint64_t warmup = 0;
+    if (end == spec || interval == 0)
+    {
+        return false;
+    }
+    if (*end == ':')
+    {
+        const char *w = end + 1;
+        warmup = strtoull(w, &end, 0);
+        if (end == w)
+        {
+            return false;
+        }
+    }
+    if (*end != '\0' || warmup >= interval)
+    {
+        return false;
+    }
+    cfg->interval = interval;
+    cfg->warmup = warmup;
+    return true;
+}
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*  -------------------------------------
+        k-means + BIC
+    -------------------------------------
+*/
+
+// xorshift32 (실행마다 같은 결과)
+static uint32_t nextRandom(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static double uniform(uint32_t *state)
+{
+    return (nextRandom(state) >> 8) * (1.0 / 16777216.0);
+}
+
+static double distance2(const double *a, const double *b)
+{
+    double d = 0;
+    for (int i = 0; i < SIMPOINT_DIMS; i++)
+    {
+        d += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return d;
+}
+
+// 투영한 구간 벡터 (같은 BBV가 나온 구간은 하나로 합치고 구간 수를 가중치로)
+// 반복 루프는 구간 대부분이 같은 벡터라 k-means가 서로 다른 벡터 몇 개만 다룸
+typedef struct {
+    double *points;   // n x SIMPOINT_DIMS
+    uint64_t *weight; // 이 벡터가 나온 구간 수
+    uint64_t *first;  // 이 벡터가 처음 나온 구간 번호 (대표 구간 후보)
+    uint64_t n;       // 서로 다른 벡터 수
+    uint64_t total;   // 전체 구간 수 (weight 합)
+    uint64_t capacity;
+    uint32_t *table;  // 열린 주소 해시 (벡터 번호 + 1, 0 = 빈 칸), 크기 capacity * 2
+} VectorSet;
+
+#define VEC(set, i) (&(set)->points[(size_t)(i) * SIMPOINT_DIMS])
+
+// FNV-1a (투영 값이 비트까지 같은 벡터를 찾음)
+static uint32_t hashVector(const double *p)
+{
+    const uint8_t *bytes = (const uint8_t *)p;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < SIMPOINT_DIMS * sizeof(double); i++)
+    {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void insertHash(VectorSet *v, uint64_t index)
+{
+    uint64_t mask = v->capacity * 2 - 1;
+    uint64_t slot = hashVector(VEC(v, index)) & mask;
+    while (v->table[slot])
+    {
+        slot = (slot + 1) & mask;
+    }
+    v->table[slot] = (uint32_t)(index + 1);
+}
+
+static bool growVectors(VectorSet *v)
+{
+    uint64_t capacity = v->capacity ? v->capacity * 2 : 256;
+    double *points = realloc(v->points, (size_t)capacity * SIMPOINT_DIMS * sizeof(double));
+    if (points)
+        v->points = points;
+    uint64_t *weight = realloc(v->weight, (size_t)capacity * sizeof(uint64_t));
+    if (weight)
+        v->weight = weight;
+    uint64_t *first = realloc(v->first, (size_t)capacity * sizeof(uint64_t));
+    if (first)
+        v->first = first;
+    uint32_t *table = calloc((size_t)capacity * 2, sizeof(uint32_t));
+    if (!points || !weight || !first || !table || capacity >= UINT32_MAX)
+    {
+        free(table);
+        return false;
+    }
+    free(v->table);
+    v->table = table;
+    v->capacity = capacity;
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        insertHash(v, i);
+    }
+    return true;
+}
+
+// 구간 하나의 벡터를 더함 (이미 있으면 가중치만), 메모리가 없으면 false
+static bool addVector(VectorSet *v, const double *p, uint64_t interval)
+{
+    v->total++;
+    if (v->capacity)
+    {
+        uint64_t mask = v->capacity * 2 - 1;
+        for (uint64_t slot = hashVector(p) & mask; v->table[slot]; slot = (slot + 1) & mask)
+        {
+            uint64_t i = v->table[slot] - 1;
+            if (memcmp(VEC(v, i), p, SIMPOINT_DIMS * sizeof(double)) == 0)
+            {
+                v->weight[i]++;
+                return true;
+            }
+        }
+    }
+    if (v->n == v->capacity && !growVectors(v))
+    {
+        return false;
+    }
+    memcpy(VEC(v, v->n), p, SIMPOINT_DIMS * sizeof(double));
+    v->weight[v->n] = 1;
+    v->first[v->n] = interval;
+    insertHash(v, v->n++);
+    return true;
+}
+
+static void freeVectors(VectorSet *v)
+{
+    free(v->points);
+    free(v->weight);
+    free(v->first);
+    free(v->table);
+}
+
+typedef struct {
+    int k;
+    double centers[SIMPOINT_MAX_K][SIMPOINT_DIMS];
+    uint64_t sizes[SIMPOINT_MAX_K]; // 클러스터에 속한 구간 수
+    double distortion;              // 구간마다 가장 가까운 중심까지 거리 제곱 합
+} Clustering;
+
+// 가중치 x value에 비례해서 벡터 하나를 고름 (합이 0이면 가중치만으로)
+static uint64_t pickWeighted(const VectorSet *v, const double *value, uint32_t *rng)
+{
+    double total = 0;
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        total += v->weight[i] * (value ? value[i] : 1.0);
+    }
+    if (total <= 0)
+    {
+        return value ? pickWeighted(v, NULL, rng) : 0;
+    }
+    double r = uniform(rng) * total;
+    uint64_t i = 0;
+    for (; i + 1 < v->n; i++)
+    {
+        double w = v->weight[i] * (value ? value[i] : 1.0);
+        if (r < w)
+            break;
+        r -= w;
+    }
+    return i;
+}
+
+// k-means++ 시작점: 첫 중심은 무작위, 나머지는 가까운 중심까지 거리 제곱에 비례해서
+static void seedCenters(const VectorSet *v, Clustering *c, double *nearest, uint32_t *rng)
+{
+    memcpy(c->centers[0], VEC(v, pickWeighted(v, NULL, rng)), sizeof(c->centers[0]));
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        nearest[i] = distance2(VEC(v, i), c->centers[0]);
+    }
+    for (int j = 1; j < c->k; j++)
+    {
+        memcpy(c->centers[j], VEC(v, pickWeighted(v, nearest, rng)), sizeof(c->centers[j]));
+        for (uint64_t i = 0; i < v->n; i++)
+        {
+            double d = distance2(VEC(v, i), c->centers[j]);
+            if (d < nearest[i])
+                nearest[i] = d;
+        }
+    }
+}
+
+static int closestCenter(const Clustering *c, const double *p, double *dist)
+{
+    int best = 0;
+    double bestDist = distance2(p, c->centers[0]);
+    for (int j = 1; j < c->k; j++)
+    {
+        double d = distance2(p, c->centers[j]);
+        if (d < bestDist)
+        {
+            best = j;
+            bestDist = d;
+        }
+    }
+    *dist = bestDist;
+    return best;
+}
+
+// Lloyd 반복 (배정이 바뀌지 않거나 SIMPOINT_ITERATIONS번까지)
+static void runKMeans(const VectorSet *v, Clustering *c, int *assign)
+{
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        assign[i] = -1;
+    }
+    for (int iter = 0; iter < SIMPOINT_ITERATIONS; iter++)
+    {
+        bool changed = false;
+        c->distortion = 0;
+        for (uint64_t i = 0; i < v->n; i++)
+        {
+            double d;
+            int j = closestCenter(c, VEC(v, i), &d);
+            changed |= (assign[i] != j);
+            assign[i] = j;
+            c->distortion += v->weight[i] * d;
+        }
+        if (!changed)
+        {
+            break;
+        }
+
+        // 빈 클러스터는 중심을 그대로 둠
+        double sums[SIMPOINT_MAX_K][SIMPOINT_DIMS] = {{0}};
+        memset(c->sizes, 0, sizeof(c->sizes));
+        for (uint64_t i = 0; i < v->n; i++)
+        {
+            c->sizes[assign[i]] += v->weight[i];
+            for (int d = 0; d < SIMPOINT_DIMS; d++)
+            {
+                sums[assign[i]][d] += v->weight[i] * VEC(v, i)[d];
+            }
+        }
+        for (int j = 0; j < c->k; j++)
+        {
+            for (int d = 0; c->sizes[j] && d < SIMPOINT_DIMS; d++)
+            {
+                c->centers[j][d] = sums[j][d] / c->sizes[j];
+            }
+        }
+    }
+    memset(c->sizes, 0, sizeof(c->sizes));
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        c->sizes[assign[i]] += v->weight[i];
+    }
+}
+
+/**
+ * BIC (X-means의 구형 가우시안 모델, n = 구간 수)
+ *   분산 s2 = 왜곡 / (차원 x (n - k)), 로그 우도 = sum(n_j log(n_j / n)) - n D/2 log(2 pi s2) - 왜곡 / (2 s2)
+ *   매개변수 (k - 1) + kD + 1 개에 대해 - p/2 log n
+ * 구간이 모두 같으면 분산이 0이 되므로 아주 작은 값으로 막음
+ */
+static double bicScore(const Clustering *c, uint64_t n)
+{
+    double variance = c->distortion / ((double)SIMPOINT_DIMS * (double)(n - c->k));
+    if (variance < 1e-12)
+    {
+        variance = 1e-12;
+    }
+    double logLikelihood = -(double)n * SIMPOINT_DIMS / 2.0 * log(2.0 * M_PI * variance) - c->distortion / (2.0 * variance);
+    for (int j = 0; j < c->k; j++)
+    {
+        if (c->sizes[j])
+        {
+            logLikelihood += c->sizes[j] * log((double)c->sizes[j] / n);
+        }
+    }
+    double params = (c->k - 1) + (double)c->k * SIMPOINT_DIMS + 1;
+    return logLikelihood - params / 2.0 * log((double)n);
+}
+
+// k마다 시작점을 바꿔 여러 번 돌려서 왜곡이 가장 작은 것
+static void bestKMeans(const VectorSet *v, int k, Clustering *best, int *assign, int *scratch, double *nearest)
+{
+    uint32_t rng = 0x5EED0000u + (uint32_t)k;
+    Clustering c;
+    best->distortion = INFINITY;
+    for (int s = 0; s < SIMPOINT_SEEDS; s++)
+    {
+        memset(&c, 0, sizeof(c));
+        c.k = k;
+        seedCenters(v, &c, nearest, &rng);
+        runKMeans(v, &c, scratch);
+        if (c.distortion < best->distortion)
+        {
+            *best = c;
+            memcpy(assign, scratch, v->n * sizeof(int));
+        }
+    }
+}
+
+// k를 고르고 클러스터마다 중심에 가장 가까운 구간을 set에 채움
+static bool selectSimPoints(const VectorSet *v, int maxK, SimPointSet *set)
+{
+    int *assign = malloc(v->n * sizeof(int));
+    int *scratch = malloc(v->n * sizeof(int));
+    double *nearest = malloc(v->n * sizeof(double));
+    if (!assign || !scratch || !nearest)
+    {
+        printf("Out of memory for %llu intervals\n", (unsigned long long)v->n);
+        free(assign);
+        free(scratch);
+        free(nearest);
+        return false;
+    }
+
+    // 서로 다른 벡터 수보다 많은 클러스터는 의미 없고, BIC는 n > k에서만 정의됨
+    int kLimit = maxK;
+    if ((uint64_t)kLimit > v->n)
+    {
+        kLimit = (int)v->n;
+    }
+    if ((uint64_t)kLimit >= v->total)
+    {
+        kLimit = (v->total > 1) ? (int)v->total - 1 : 1;
+    }
+    double bic[SIMPOINT_MAX_K + 1];
+    double lo = INFINITY, hi = -INFINITY;
+    Clustering c;
+    for (int k = 1; k <= kLimit; k++)
+    {
+        bestKMeans(v, k, &c, assign, scratch, nearest);
+        bic[k] = (v->total > 1) ? bicScore(&c, v->total) : 0.0;
+        lo = fmin(lo, bic[k]);
+        hi = fmax(hi, bic[k]);
+    }
+    int chosen = 1;
+    while (chosen < kLimit && bic[chosen] < lo + SIMPOINT_BIC_THRESHOLD * (hi - lo))
+    {
+        chosen++;
+    }
+    bestKMeans(v, chosen, &c, assign, scratch, nearest);
+
+    // 대표 구간: 중심에 가장 가까운 벡터가 처음 나온 구간 (빈 클러스터는 건너뜀)
+    uint64_t rep[SIMPOINT_MAX_K];
+    double repDist[SIMPOINT_MAX_K];
+    for (int j = 0; j < chosen; j++)
+    {
+        repDist[j] = INFINITY;
+    }
+    for (uint64_t i = 0; i < v->n; i++)
+    {
+        double d = distance2(VEC(v, i), c.centers[assign[i]]);
+        if (d < repDist[assign[i]])
+        {
+            repDist[assign[i]] = d;
+            rep[assign[i]] = v->first[i];
+        }
+    }
+    set->k = 0;
+    for (int j = 0; j < chosen; j++)
+    {
+        if (c.sizes[j])
+        {
+            SimPoint *p = &set->points[set->k++];
+            p->index = rep[j];
+            p->weight = (double)c.sizes[j] / v->total;
+            p->cluster = j;
+        }
+    }
+    // 구간 번호 순 (체크포인트도 이 순서로)
+    for (int a = 1; a < set->k; a++)
+    {
+        SimPoint p = set->points[a];
+        int b = a;
+        for (; b > 0 && set->points[b - 1].index > p.index; b--)
+        {
+            set->points[b] = set->points[b - 1];
+        }
+        set->points[b] = p;
+    }
+
+    free(assign);
+    free(scratch);
+    free(nearest);
+    return true;
+}
+
+/*  -------------------------------------
+        프로파일 (-B)
+    -------------------------------------
+*/
+
+// 대표 구간의 warm-up 시작 위치 (명령어)
+static uint64_t warmupStart(const SimPointSet *set, const SimPoint *p)
+{
+    uint64_t start = p->index * set->interval;
+    return start - (set->warmup < start ? set->warmup : start);
+}
+
+// 처음 상태부터 빨리 감으면서 대표 구간마다 체크포인트
+static bool writeSimPointCheckpoints(VM *vm, const SimPointSet *set, const char *path, LoopAccel *accel)
+{
+    CheckpointLog log;
+    if (!openCheckpointLog(&log, path))
+    {
+        return false;
+    }
+    FunctionalHooks hooks;
+    initWarming(&hooks, NULL, NULL);
+    hooks.accel = accel;
+    bool ok = true;
+    uint64_t pos = 0;
+    vm->running = true;
+    for (int i = 0; ok && i < set->k; i++)
+    {
+        uint64_t target = warmupStart(set, &set->points[i]);
+        pos += runFunctional(vm, target - pos, &hooks);
+        ok = (pos == target) && saveCheckpoint(&log, vm, pos);
+    }
+    if (ok)
+    {
+        printf("%u checkpoints written to %s (%llu lines of %d bytes)\n", log.count, path,
+               (unsigned long long)log.linesWritten, DIRTY_LINE_SIZE);
+    }
+    closeCheckpointLog(&log);
+    return ok;
+}
+
+bool profileSimPoints(VM *vm, uint64_t maxInstructions, const SimPointConfig *cfg, SimPointSet *set,
+                      const char *checkpointPath)
+{
+    memset(set, 0, sizeof(*set));
+    set->interval = cfg->interval;
+    set->warmup = cfg->warmup;
+    VM start = *vm; // 체크포인트를 만들 때 다시 시작할 상태
+
+    // 무작위 투영 행렬 (블록 시작 PC x SIMPOINT_DIMS, -1 ~ 1)
+    static double projection[MEMORY_SIZE][SIMPOINT_DIMS];
+    uint32_t rng = 0x51A9017u;
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        for (int d = 0; d < SIMPOINT_DIMS; d++)
+        {
+            projection[pc][d] = uniform(&rng) * 2.0 - 1.0;
+        }
+    }
+
+    static uint64_t bbv[MEMORY_SIZE];
+    FunctionalHooks hooks;
+    initWarming(&hooks, NULL, NULL);
+    hooks.bbv = bbv;
+    hooks.blockStart = vm->cpu.PC;
+    hooks.accel = cfg->accel;
+
+    VectorSet v = {0};
+    double point[SIMPOINT_DIMS];
+    vm->running = true;
+    while (vm->running && (maxInstructions == 0 || set->instructions < maxInstructions))
+    {
+        uint64_t len = cfg->interval;
+        if (maxInstructions && maxInstructions - set->instructions < len)
+        {
+            len = maxInstructions - set->instructions;
+        }
+        memset(bbv, 0, sizeof(bbv));
+        uint64_t done = runFunctional(vm, len, &hooks);
+        set->instructions += done;
+        if (done < cfg->interval)
+        {
+            break; // 끝의 잘린 구간은 클러스터링하지 않음
+        }
+
+        memset(point, 0, sizeof(point));
+        for (int pc = 0; pc < MEMORY_SIZE; pc++)
+        {
+            if (bbv[pc])
+            {
+                double share = (double)bbv[pc] / cfg->interval;
+                for (int d = 0; d < SIMPOINT_DIMS; d++)
+                {
+                    point[d] += share * projection[pc][d];
+                }
+            }
+        }
+        if (!addVector(&v, point, v.total))
+        {
+            printf("Out of memory after %llu intervals\n", (unsigned long long)v.total);
+            freeVectors(&v);
+            return false;
+        }
+    }
+    set->intervals = v.total;
+
+    if (v.total == 0)
+    {
+        printf("Program ran %llu instructions, shorter than one interval (%llu)\n",
+               (unsigned long long)set->instructions, (unsigned long long)cfg->interval);
+        freeVectors(&v);
+        return false;
+    }
+    bool ok = selectSimPoints(&v, cfg->maxK, set);
+    freeVectors(&v);
+
+    if (ok && checkpointPath)
+    {
+        freePagedMemory(vm);
+        *vm = start;
+        ok = writeSimPointCheckpoints(vm, set, checkpointPath, cfg->accel);
+    }
+    return ok;
+}
+
+/*  -------------------------------------
+        파일
+    -------------------------------------
+*/
+
+bool writeSimPoints(const char *path, const SimPointSet *set)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        printf("Failed to open file: %s\n", path);
+        return false;
+    }
+    fprintf(fp, "# interval weight cluster (start instruction = interval x %llu)\n",
+            (unsigned long long)set->interval);
+    fprintf(fp, "simpoints interval=%llu warmup=%llu instructions=%llu intervals=%llu k=%d\n",
+            (unsigned long long)set->interval, (unsigned long long)set->warmup,
+            (unsigned long long)set->instructions, (unsigned long long)set->intervals, set->k);
+    for (int i = 0; i < set->k; i++)
+    {
+        fprintf(fp, "%llu %.6f %d\n", (unsigned long long)set->points[i].index, set->points[i].weight,
+                set->points[i].cluster);
+    }
+    return fclose(fp) == 0;
+}
+
+bool readSimPoints(const char *path, SimPointSet *set)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        printf("Failed to open file: %s\n", path);
+        return false;
+    }
+    memset(set, 0, sizeof(*set));
+    char line[256];
+    bool header = false;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        unsigned long long interval, warmup, instructions, intervals, index;
+        int k, cluster;
+        double weight;
+        if (!header)
+        {
+            ok = sscanf(line, "simpoints interval=%llu warmup=%llu instructions=%llu intervals=%llu k=%d", &interval,
+                        &warmup, &instructions, &intervals, &k) == 5 &&
+                 interval > 0 && k > 0 && k <= SIMPOINT_MAX_K;
+            set->interval = interval;
+            set->warmup = warmup;
+            set->instructions = instructions;
+            set->intervals = intervals;
+            header = true;
+        }
+        else if (set->k < SIMPOINT_MAX_K && sscanf(line, "%llu %lf %d", &index, &weight, &cluster) == 3)
+        {
+            set->points[set->k++] = (SimPoint){.index = index, .weight = weight, .cluster = cluster};
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    fclose(fp);
+    if (!ok || !header || set->k == 0)
+    {
+        printf("%s: not a simpoints file\n", path);
+        return false;
+    }
+    return true;
+}
+
+void printSimPoints(const SimPointSet *set)
+{
+    printf("----- SimPoints -----\n");
+    printf("instructions    = %llu (%llu intervals of %llu)\n", (unsigned long long)set->instructions,
+           (unsigned long long)set->intervals, (unsigned long long)set->interval);
+    printf("clusters        = %d\n", set->k);
+    printf("%10s %14s %8s %8s\n", "interval", "start", "weight", "cluster");
+    for (int i = 0; i < set->k; i++)
+    {
+        const SimPoint *p = &set->points[i];
+        printf("%10llu %14llu %8.4f %8d\n", (unsigned long long)p->index,
+               (unsigned long long)(p->index * set->interval), p->weight, p->cluster);
+    }
+}
+
+/*  -------------------------------------
+        대표 구간 상세 실행 (-Y)
+    -------------------------------------
+*/
+
+bool simulateSimPoints(VM *vm, const SimPointSet *set, const SampleConfig *cfg, const char *checkpointPath,
+                       SimPointResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    double t0 = nowSeconds();
+
+    BranchPredictor bp;
+    initPredictor(&bp, cfg->pipe.predictor);
+    FunctionalHooks warm;
+    initWarming(&warm, cfg->warming ? vm->mem : NULL,
+                (cfg->warming && cfg->pipelined && cfg->pipe.predictor >= BP_BTB) ? &bp : NULL);
+    warm.accel = cfg->accel;
+
+    PipelineStats scratch;
+    CounterSnapshot snap;
+    uint64_t pos = 0;
+    vm->running = true;
+    for (int i = 0; i < set->k; i++)
+    {
+        const SimPoint *p = &set->points[i];
+        uint64_t from = warmupStart(set, p);
+        uint64_t start = p->index * set->interval;
+
+        saveCounters(vm, &snap);
+        if (checkpointPath)
+        {
+            if (!resumeCheckpoint(vm, checkpointPath, i, &pos, false) || pos != from)
+            {
+                printf("%s: no checkpoint for interval %llu (run -B with -C and the same -I)\n", checkpointPath,
+                       (unsigned long long)p->index);
+                return false;
+            }
+        }
+        else if (pos <= from)
+        {
+            pos += runFunctional(vm, from - pos, &warm);
+        }
+
+        uint64_t done = 0;
+        if (vm->running && start > pos)
+        {
+            memset(&scratch, 0, sizeof(scratch));
+            runDetailed(vm, start - pos, cfg, &bp, &scratch, &done);
+            pos += done;
+            res->detailed += done;
+        }
+        restoreCounters(vm, &snap);
+        if (!vm->running)
+        {
+            printf("Program stopped before interval %llu (instruction %llu)\n", (unsigned long long)p->index,
+                   (unsigned long long)pos);
+            return false;
+        }
+
+        uint64_t cycles = runDetailed(vm, set->interval, cfg, &bp, &res->pipe, &done);
+        pos += done;
+        res->detailed += done;
+        res->cpi[i] = done ? (double)cycles / done : 0.0;
+        res->weightedCpi += p->weight * res->cpi[i];
+    }
+
+    res->cycles = res->weightedCpi * set->instructions;
+    res->seconds = nowSeconds() - t0;
+    return true;
+}
+
+void printSimPointResult(const SimPointSet *set, const SimPointResult *res)
+{
+    printf("----- SimPoint estimate -----\n");
+    printf("%10s %8s %10s\n", "interval", "weight", "CPI");
+    for (int i = 0; i < set->k; i++)
+    {
+        printf("%10llu %8.4f %10.4f\n", (unsigned long long)set->points[i].index, set->points[i].weight, res->cpi[i]);
+    }
+    printf("instructions    = %llu (%.3f%% detailed)\n", (unsigned long long)set->instructions,
+           set->instructions ? 100.0 * res->detailed / set->instructions : 0.0);
+    printf("weighted CPI    = %.4f\n", res->weightedCpi);
+    printf("est. cycles     = %.0f\n", res->cycles);
+    printf("host time       = %.3f s\n", res->seconds);
+}
@@ -0,0 +1,88 @@
+#ifndef SIMPOINT_H
+#define SIMPOINT_H
+
+#include "cpu.h"
+#include "sample.h"
+
+/**
+ * SimPoint 방식 구간 선택 (-B 프로파일, -Y 대표 구간만 상세 실행)
+ * 1. 기능 실행 코어(functional.h)로 실행하면서 고정 길이 구간마다 기본 블록 벡터(BBV)를 모음
+ *    BBV = 블록 시작 PC(JMP 대상)별 실행한 명령어 수 / 구간 길이 (256차원)
+ * 2. 무작위 투영으로 SIMPOINT_DIMS차원으로 줄이고 k = 1..maxK마다 k-means (k-means++ 시작점 여러 개 중 최선)
+ * 3. BIC가 최저~최고 범위의 SIMPOINT_BIC_THRESHOLD 이상인 가장 작은 k를 고르고
+ *    클러스터마다 중심에 가장 가까운 구간을 대표로, 클러스터 크기 비율을 가중치로
+ * 4. -C가 있으면 대표 구간마다 (warm-up 시작점에) 체크포인트를 남김
+ * -Y는 대표 구간만 상세 실행해서 가중 평균 CPI x 전체 명령어 수로 전체 클록 수를 추정
+ * 반복 루프 프로그램은 구간들이 한두 클러스터로 모여서 상세 실행이 구간 몇 개로 줄어듦
+ *
+ * 결과 파일 (텍스트, # 줄은 주석)
+ *   simpoints interval=N warmup=W instructions=I intervals=R k=K
+ *   구간번호 가중치 클러스터      (K줄, 구간 번호 순, 시작 명령어 = 구간번호 x N)
+ */
+
+#define SIMPOINT_DIMS 15           // 무작위 투영 차원 (SimPoint 기본값)
+#define SIMPOINT_MAX_K 30          // -K 최대값
+#define SIMPOINT_SEEDS 5           // k마다 k-means를 다시 시작하는 횟수
+#define SIMPOINT_ITERATIONS 100    // k-means 최대 반복
+#define SIMPOINT_BIC_THRESHOLD 0.9 // BIC가 (최저 + 범위 x 이 값) 이상인 가장 작은 k
+
+typedef struct {
+    uint64_t interval; // 구간 길이 (명령어, -I N)
+    uint64_t warmup;   // 대표 구간 앞에서 상세 실행만 할 명령어 (-I N:W)
+    int maxK;          // 최대 클러스터 수 (-K)
+    LoopAccel *accel;  // 프로파일/체크포인트 빨리 감기 루프 가속 (NULL = 끔, -L)
+} SimPointConfig;
+
+typedef struct {
+    uint64_t index; // 구간 번호
+    double weight;  // 전체 구간 중 이 클러스터의 비율
+    int cluster;
+} SimPoint;
+
+typedef struct {
+    uint64_t interval;
+    uint64_t warmup;
+    uint64_t instructions; // 프로파일한 전체 명령어 수 (끝의 잘린 구간 포함)
+    uint64_t intervals;    // 클러스터링한 (끝까지 찬) 구간 수
+    int k;                 // 대표 구간 수
+    SimPoint points[SIMPOINT_MAX_K]; // 구간 번호 순
+} SimPointSet;
+
+// -I 옵션 해석: "N" 또는 "N:W" (W < N), 잘못되면 false
+bool parseIntervalSpec(SimPointConfig *cfg, const char *spec);
+
+/**
+ * 기능 실행으로 BBV를 모아 대표 구간을 고름 (maxInstructions = 0 이면 HALT까지)
+ * checkpointPath가 있으면 처음 상태부터 다시 빨리 감으면서 대표 구간마다 체크포인트 하나씩 (구간 번호 순)
+ * 구간이 하나도 안 차거나 체크포인트를 못 쓰면 메시지를 출력하고 false
+ */
+bool profileSimPoints(VM *vm, uint64_t maxInstructions, const SimPointConfig *cfg, SimPointSet *set,
+                      const char *checkpointPath);
+
+bool writeSimPoints(const char *path, const SimPointSet *set);
+bool readSimPoints(const char *path, SimPointSet *set);
+
+// 고른 구간 목록 출력
+void printSimPoints(const SimPointSet *set);
+
+typedef struct {
+    double cpi[SIMPOINT_MAX_K]; // 대표 구간별 CPI
+    double weightedCpi;
+    double cycles;              // 추정 전체 클록 수
+    uint64_t detailed;          // 상세 실행한 명령어 (warm-up 포함)
+    double seconds;             // 호스트 실행 시간
+    PipelineStats pipe;         // 측정 구간 파이프라인 통계 (pipeline 엔진)
+} SimPointResult;
+
+/**
+ * 대표 구간만 cfg의 엔진으로 상세 실행 (cfg->warmup/measure는 쓰지 않고 set의 구간 길이를 씀)
+ * checkpointPath가 있으면 -B -C로 만든 체크포인트에서 구간마다 복원, 없으면 프로그램 처음부터
+ * 구간 사이를 빨리 감기 (cfg->warming이면 캐시/예측기 갱신)
+ */
+bool simulateSimPoints(VM *vm, const SimPointSet *set, const SampleConfig *cfg, const char *checkpointPath,
+                       SimPointResult *res);
+
+// 구간별 CPI, 가중 CPI, 추정 전체 클록 수 출력
+void printSimPointResult(const SimPointSet *set, const SimPointResult *res);
+
+#endif
@@ -0,0 +1,571 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "superscalar.h"
+#include "functional.h"
+#include "cache.h"
+#include "paged.h"
+
+#define NO_REG_MASK 0
+#define BUFFER_SIZE (2 * SUPERSCALAR_MAX_FETCH)
+#define QUEUE_SIZE (2 * SUPERSCALAR_MAX_WIDTH)
+
+// 명령어 큐 항목 (길이 decode까지 끝난 명령어)
+typedef struct {
+    bool fault;      // 메모리 밖 PC
+    uint16_t pc;
+    uint16_t nextPC; // 순차 실행 시 다음 PC
+    uint8_t opcode;  // INVALID 이상은 INVALID
+    uint8_t reads;   // 읽는 레지스터 비트마스크
+    uint8_t writes;  // 쓰는 레지스터 비트마스크
+    uint32_t addr;   // 메모리 명령어 주소
+} QueueSlot;
+
+typedef struct {
+    SuperscalarConfig cfg;
+    SuperscalarStats stats;
+
+    uint8_t buffer[BUFFER_SIZE]; // fetch 버퍼: bufferPC부터 연속된 바이트
+    uint16_t bufferPC, bufferLen;
+    uint16_t fetchPC;            // = bufferPC + bufferLen (방향이 바뀌면 버퍼를 비움)
+    bool fetchStopped;           // HALT/INVALID/PC 오류를 decode한 뒤 방향이 바뀔 때까지 fetch 중단
+    uint32_t fetchStall;         // 명령어 캐시 미스로 남은 대기 클록
+    uint16_t pendingBytes;       // 대기가 끝나면 버퍼에 들어갈 바이트
+
+    QueueSlot queue[QUEUE_SIZE];
+    uint16_t queueHead, queueCount;
+
+    uint64_t readyAt[NUM_REGS]; // 레지스터 값을 읽을 수 있는 클록
+} Superscalar;
+
+void initSuperscalarConfig(SuperscalarConfig *cfg)
+{
+    cfg->width = 2;
+    cfg->fetchBytes = 8;
+    cfg->memPorts = 1;
+    cfg->aluLatency = 1;
+    cfg->loadLatency = 2;
+}
+
+static bool parseValue(const char *s, uint16_t *out)
+{
+    char *end;
+    unsigned long v = strtoul(s, &end, 0);
+    if (*s == '\0' || *end != '\0' || v == 0 || v > 0xFFFF)
+    {
+        return false;
+    }
+    *out = (uint16_t)v;
+    return true;
+}
+
+bool parseSuperscalarOption(SuperscalarConfig *cfg, const char *spec)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    char *params = strchr(buf, ':');
+    if (params)
+    {
+        *params++ = '\0';
+    }
+    if (!parseValue(buf, &cfg->width) || cfg->width > SUPERSCALAR_MAX_WIDTH)
+    {
+        printf("Issue width must be 1..%d: %s\n", SUPERSCALAR_MAX_WIDTH, buf);
+        return false;
+    }
+    cfg->fetchBytes = 4 * cfg->width;
+
+    char *save = NULL;
+    for (char *kv = params ? strtok_r(params, ",", &save) : NULL; kv; kv = strtok_r(NULL, ",", &save))
+    {
+        char *value = strchr(kv, '=');
+        bool ok = false;
+        if (value)
+        {
+            *value++ = '\0';
+            if (strcmp(kv, "fetch") == 0)
+                ok = parseValue(value, &cfg->fetchBytes) && cfg->fetchBytes <= SUPERSCALAR_MAX_FETCH;
+            else if (strcmp(kv, "ports") == 0)
+                ok = parseValue(value, &cfg->memPorts);
+            else if (strcmp(kv, "alu") == 0)
+                ok = parseValue(value, &cfg->aluLatency);
+            else if (strcmp(kv, "load") == 0)
+                ok = parseValue(value, &cfg->loadLatency);
+        }
+        if (!ok)
+        {
+            printf("Bad superscalar parameter: %s%s%s\n", kv, value ? "=" : "", value ? value : "");
+            return false;
+        }
+    }
+    return true;
+}
+
+/*  -------------------------------------
+        fetch / length decode
+    -------------------------------------
+*/
+
+// 버퍼를 비우고 pc부터 다시 fetch (진행 중인 캐시 미스도 취소)
+static void redirectFetch(Superscalar *s, uint16_t pc)
+{
+    s->bufferPC = s->fetchPC = pc;
+    s->bufferLen = 0;
+    s->fetchStall = 0;
+    s->pendingBytes = 0;
+    s->fetchStopped = false;
+}
+
+static void appendBytes(VM *vm, Superscalar *s, uint16_t n)
+{
+    memcpy(&s->buffer[s->bufferLen], &vm->memory[s->fetchPC], n);
+    s->bufferLen += n;
+    s->fetchPC += n;
+    s->stats.fetchedBytes += n;
+}
+
+// 클록마다 fetchBytes 바이트 (버퍼에 자리가 있는 만큼, 메모리 끝까지)
+static void ssFetch(VM *vm, Superscalar *s)
+{
+    if (s->fetchStall > 0)
+    {
+        s->stats.fetchStalls++;
+        vm->mem->stallCycles++;
+        PERF_INC(vm, stallCycles);
+        if (--s->fetchStall == 0)
+        {
+            appendBytes(vm, s, s->pendingBytes);
+            s->pendingBytes = 0;
+        }
+        return;
+    }
+    if (s->fetchStopped || s->fetchPC >= MEMORY_SIZE)
+    {
+        return;
+    }
+
+    uint16_t n = s->cfg.fetchBytes;
+    if (n > BUFFER_SIZE - s->bufferLen)
+        n = BUFFER_SIZE - s->bufferLen;
+    if (n > MEMORY_SIZE - s->fetchPC)
+        n = MEMORY_SIZE - s->fetchPC;
+    if (n == 0)
+    {
+        return;
+    }
+    if (vm->mem)
+    {
+        uint32_t latency = memAccess(vm->mem, MEM_IFETCH, s->fetchPC, n);
+        if (latency > 1)
+        {
+            s->fetchStall = latency - 1;
+            s->pendingBytes = n;
+            return;
+        }
+    }
+    appendBytes(vm, s, n);
+}
+
+// 버퍼의 pc 바이트 (메모리 밖은 0, pipeline과 같음)
+static uint8_t bufferByte(const Superscalar *s, uint32_t pc)
+{
+    return (pc < MEMORY_SIZE) ? s->buffer[pc - s->bufferPC] : 0;
+}
+
+static uint8_t regBit(uint8_t reg)
+{
+    return (uint8_t)(1u << (reg & (NUM_REGS - 1)));
+}
+
+// 버퍼 앞 명령어의 읽기/쓰기 레지스터와 주소 (stageDecode()와 같은 오퍼랜드 배치)
+static void decodeSlot(const Superscalar *s, uint16_t pc, QueueSlot *q)
+{
+    uint8_t b[WIDE_INSTR_SIZE];
+    for (int i = 0; i < WIDE_INSTR_SIZE; i++)
+    {
+        b[i] = bufferByte(s, pc + i);
+    }
+    q->opcode = (b[0] < INVALID) ? b[0] : INVALID;
+    q->nextPC = pc + instrLength(b[0]);
+    q->reads = q->writes = NO_REG_MASK;
+    q->addr = 0;
+
+    switch (q->opcode)
+    {
+    case MOV_RR: // dst <- src
+        q->writes = regBit(b[1]);
+        q->reads = regBit(b[2]);
+        break;
+    case ADD_RR: // dst <- dst (+/-) src
+    case SUB_RR:
+        q->writes = regBit(b[1]);
+        q->reads = regBit(b[1]) | regBit(b[2]);
+        break;
+    case MOV_RM: // [addr] <- reg
+        q->addr = b[1];
+        q->reads = regBit(b[2]);
+        break;
+    case MOV_MR: // reg <- [addr]
+        q->writes = regBit(b[1]);
+        q->addr = b[2];
+        break;
+    case JMP:
+        q->addr = b[1]; // 대상
+        break;
+    case MOV_RF: // [addr32] <- reg
+    case MOV_FR: // reg <- [addr32]
+    {
+        int at = WIDE_ADDR_OFFSET(q->opcode);
+        q->addr = b[at] | (uint32_t)b[at + 1] << 8 | (uint32_t)b[at + 2] << 16 | (uint32_t)b[at + 3] << 24;
+        uint8_t reg = regBit(b[WIDE_REG_OFFSET(q->opcode)]);
+        if (q->opcode == MOV_RF)
+            q->reads = reg;
+        else
+            q->writes = reg;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// 한 클록에 width개까지 경계를 나눠 명령어 큐로
+static void ssDecode(VM *vm, Superscalar *s)
+{
+    for (int n = 0; n < s->cfg.width && s->queueCount < 2 * s->cfg.width; n++)
+    {
+        if (s->fetchStopped && s->bufferLen == 0)
+        {
+            return;
+        }
+        uint16_t pc = s->bufferPC;
+        QueueSlot *q = &s->queue[(s->queueHead + s->queueCount) % QUEUE_SIZE];
+        memset(q, 0, sizeof(*q));
+        q->pc = pc;
+        if (pc >= MEMORY_SIZE)
+        {
+            // 실행될 일이 없는 뒤쪽은 fetch하지 않음 (issue에서 오류)
+            q->fault = true;
+            s->queueCount++;
+            s->stats.decoded++;
+            PERF_INC(vm, fetches);
+            s->fetchStopped = true;
+            return;
+        }
+        if (s->bufferLen == 0)
+        {
+            return;
+        }
+
+        // 길이는 opcode 바이트만 보면 정해짐, 메모리 끝을 넘는 바이트는 0으로 읽으므로 필요 없음
+        uint8_t op = s->buffer[0];
+        uint16_t size = instrLength(op);
+        uint16_t need = (pc + size <= MEMORY_SIZE) ? size : MEMORY_SIZE - pc;
+        if (s->bufferLen < need)
+        {
+            s->stats.decodeWaits++;
+            return;
+        }
+        decodeSlot(s, pc, q);
+        s->queueCount++;
+        s->stats.decoded++;
+        PERF_INC(vm, fetches);
+
+        memmove(s->buffer, s->buffer + need, s->bufferLen - need);
+        s->bufferLen -= need;
+        s->bufferPC += size;
+
+        if (q->opcode == JMP)
+        {
+            s->stats.jmpRedirects++;
+            redirectFetch(s, (uint16_t)q->addr);
+            return;
+        }
+        if (q->opcode == HALT || q->opcode == INVALID)
+        {
+            s->bufferLen = 0;
+            s->pendingBytes = 0;
+            s->fetchStall = 0;
+            s->fetchStopped = true;
+            return;
+        }
+    }
+}
+
+/*  -------------------------------------
+        issue
+    -------------------------------------
+*/
+
+static bool isMemory(uint8_t op)
+{
+    return op == MOV_RM || op == MOV_MR || op == MOV_RF || op == MOV_FR;
+}
+
+static bool isWide(uint8_t op)
+{
+    return op == MOV_RF || op == MOV_FR;
+}
+
+// mask의 레지스터가 모두 이번 클록에 읽을 수 있는지
+static bool operandsReady(const Superscalar *s, uint8_t mask)
+{
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        if ((mask & (1u << r)) && s->readyAt[r] > s->stats.cycles)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// q가 이번 묶음에 들어갈 수 없는 이유 (SLOT_REASONS = 들어갈 수 있음)
+static SlotReason pairingCheck(const Superscalar *s, const QueueSlot *q, int issued, uint8_t groupWrites,
+                               int memOps)
+{
+    if (q->fault)
+    {
+        return SLOT_REASONS;
+    }
+    if ((q->reads | q->writes) & groupWrites)
+    {
+        return SLOT_PAIR;
+    }
+    if (!operandsReady(s, q->reads))
+    {
+        return SLOT_DATA;
+    }
+    if (isMemory(q->opcode) && memOps == s->cfg.memPorts)
+    {
+        return SLOT_PORT;
+    }
+    if (isWide(q->opcode) && issued > 0)
+    {
+        return SLOT_WIDE;
+    }
+    return SLOT_REASONS;
+}
+
+// store가 이미 fetch한 바이트를 바꿨을 때: 아직 decode 안 한 버퍼 바이트는 새 값으로 고치고 (JMP 뒤 데이터일 수도 있음)
+// decode해서 큐에 있는 명령어의 바이트면 true (비우고 다시 fetch)
+static bool snoopStore(const VM *vm, Superscalar *s, uint32_t addr)
+{
+    if (addr >= s->bufferPC && addr < (uint32_t)s->bufferPC + s->bufferLen)
+    {
+        s->buffer[addr - s->bufferPC] = vm->memory[addr];
+    }
+    for (uint16_t i = 0; i < s->queueCount; i++)
+    {
+        const QueueSlot *q = &s->queue[(s->queueHead + i) % QUEUE_SIZE];
+        if (!q->fault && addr >= q->pc && addr < q->nextPC)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 명령어 하나 실행 (기능 실행 코어, 캐시 지연은 여기서), 결과를 쓸 수 있을 때까지의 클록 수 반환
+static uint32_t executeSlot(VM *vm, Superscalar *s, const QueueSlot *q)
+{
+    // HALT도 실행한 명령어로 셈, 오류 난 명령어는 세지 않음
+    if (stepFunctional(vm, NULL))
+    {
+        PERF_INC(vm, retired);
+        PERF_INC(vm, opcodes[q->opcode]);
+        s->stats.retired++;
+    }
+    if (!vm->running || !isMemory(q->opcode))
+    {
+        return s->cfg.aluLatency;
+    }
+
+    // store는 쓰기 버퍼가 있다고 보고 기다리지 않음 (캐시 상태와 통계에만 반영)
+    bool load = (q->opcode == MOV_MR || q->opcode == MOV_FR);
+    uint32_t latency = vm->mem ? memAccessWide(vm->mem, load ? MEM_READ : MEM_WRITE, q->addr) : s->cfg.loadLatency;
+    if (load)
+    {
+        PERF_INC(vm, memReads);
+        return latency;
+    }
+    PERF_INC(vm, memWrites);
+    return s->cfg.aluLatency;
+}
+
+// 한 묶음 issue, 멈춰야 하면 false
+static bool ssIssue(VM *vm, Superscalar *s)
+{
+    int issued = 0;
+    int memOps = 0;
+    uint8_t groupWrites = 0;
+    SlotReason reason = SLOT_EMPTY;
+    bool running = true;
+
+    while (issued < s->cfg.width)
+    {
+        if (s->queueCount == 0)
+        {
+            reason = SLOT_EMPTY;
+            break;
+        }
+        const QueueSlot q = s->queue[s->queueHead];
+        reason = pairingCheck(s, &q, issued, groupWrites, memOps);
+        if (reason != SLOT_REASONS)
+        {
+            break;
+        }
+        s->queueHead = (s->queueHead + 1) % QUEUE_SIZE;
+        s->queueCount--;
+        issued++;
+
+        uint32_t latency = executeSlot(vm, s, &q);
+        if (!vm->running)
+        {
+            running = false;
+            break;
+        }
+        for (int r = 0; r < NUM_REGS; r++)
+        {
+            if (q.writes & (1u << r))
+            {
+                s->readyAt[r] = s->stats.cycles + latency;
+            }
+        }
+        groupWrites |= q.writes;
+        memOps += isMemory(q.opcode);
+
+        // 자기 수정 코드: store 다음 명령어부터 바뀐 메모리로 다시 fetch
+        if ((q.opcode == MOV_RM || q.opcode == MOV_RF) && q.addr < MEMORY_SIZE && snoopStore(vm, s, q.addr))
+        {
+            s->stats.smcFlushes++;
+            s->queueCount = 0;
+            redirectFetch(s, q.nextPC);
+            reason = SLOT_FLUSH;
+            break;
+        }
+        if (q.opcode == JMP)
+        {
+            reason = SLOT_BRANCH;
+            break;
+        }
+        if (isWide(q.opcode))
+        {
+            reason = SLOT_WIDE;
+            break;
+        }
+    }
+
+    s->stats.groupHist[issued]++;
+    if (issued < s->cfg.width && running)
+    {
+        s->stats.unused[reason] += s->cfg.width - issued;
+    }
+    return running;
+}
+
+// 한 클록
+static void ssClock(VM *vm, Superscalar *s)
+{
+    s->stats.cycles++;
+    PERF_INC(vm, cycles);
+
+    if (!ssIssue(vm, s))
+    {
+        return;
+    }
+    ssDecode(vm, s);
+    ssFetch(vm, s);
+}
+
+static void addStats(SuperscalarStats *dst, const SuperscalarStats *src)
+{
+    dst->cycles += src->cycles;
+    dst->retired += src->retired;
+    dst->fetchedBytes += src->fetchedBytes;
+    dst->decoded += src->decoded;
+    dst->decodeWaits += src->decodeWaits;
+    dst->fetchStalls += src->fetchStalls;
+    dst->jmpRedirects += src->jmpRedirects;
+    dst->smcFlushes += src->smcFlushes;
+    for (int i = 0; i < SLOT_REASONS; i++)
+    {
+        dst->unused[i] += src->unused[i];
+    }
+    for (int i = 0; i <= SUPERSCALAR_MAX_WIDTH; i++)
+    {
+        dst->groupHist[i] += src->groupHist[i];
+    }
+    dst->width = src->width;
+}
+
+uint64_t runSuperscalar(VM *vm, uint64_t maxCycles, const SuperscalarConfig *cfg, SuperscalarStats *stats)
+{
+    Superscalar s;
+    memset(&s, 0, sizeof(s));
+    if (cfg)
+        s.cfg = *cfg;
+    else
+        initSuperscalarConfig(&s.cfg);
+    if (s.cfg.fetchBytes == 0)
+        s.cfg.fetchBytes = 4 * s.cfg.width;
+    s.stats.width = s.cfg.width;
+    redirectFetch(&s, vm->cpu.PC);
+
+    vm->running = true;
+    while (vm->running && (maxCycles == 0 || s.stats.cycles < maxCycles))
+    {
+        ssClock(vm, &s);
+    }
+    // 실행은 issue에서 순서대로 하므로 멈추면 vm->cpu.PC가 issue 안 된 첫 명령어
+
+    if (stats)
+    {
+        addStats(stats, &s.stats);
+    }
+    return s.stats.cycles;
+}
+
+void printSuperscalarStats(const SuperscalarConfig *cfg, const SuperscalarStats *stats)
+{
+    static const char *reasonNames[SLOT_REASONS] = {
+        [SLOT_EMPTY] = "queue empty", [SLOT_DATA] = "data wait", [SLOT_PAIR] = "intra-group dep",
+        [SLOT_PORT] = "memory port", [SLOT_BRANCH] = "after JMP", [SLOT_WIDE] = "wide MOV_RF/FR",
+        [SLOT_FLUSH] = "SMC flush",
+    };
+    uint64_t slots = stats->cycles * stats->width;
+
+    printf("----- Superscalar -----\n");
+    printf("config          = %u-wide in-order, fetch %u B/cycle, %u mem port(s), ALU %u clk, load %u clk\n",
+           cfg->width, cfg->fetchBytes ? cfg->fetchBytes : 4 * cfg->width, cfg->memPorts, cfg->aluLatency,
+           cfg->loadLatency);
+    printf("cycles          = %llu\n", (unsigned long long)stats->cycles);
+    printf("retired         = %llu\n", (unsigned long long)stats->retired);
+    printf("IPC             = %.3f (CPI %.3f)\n", stats->cycles ? (double)stats->retired / stats->cycles : 0.0,
+           stats->retired ? (double)stats->cycles / stats->retired : 0.0);
+    printf("fetched bytes   = %llu (decoded %llu, decode waits %llu)\n", (unsigned long long)stats->fetchedBytes,
+           (unsigned long long)stats->decoded, (unsigned long long)stats->decodeWaits);
+    printf("JMP redirects   = %llu\n", (unsigned long long)stats->jmpRedirects);
+    printf("SMC flushes     = %llu\n", (unsigned long long)stats->smcFlushes);
+    if (stats->fetchStalls)
+    {
+        printf("fetch stalls    = %llu\n", (unsigned long long)stats->fetchStalls);
+    }
+    printf("issue slots     = %llu used of %llu (%.1f%%)\n", (unsigned long long)stats->retired,
+           (unsigned long long)slots, slots ? 100.0 * stats->retired / slots : 0.0);
+    for (int i = 0; i < SLOT_REASONS; i++)
+    {
+        if (stats->unused[i])
+        {
+            printf("  unused: %-16s %llu (%.1f%%)\n", reasonNames[i], (unsigned long long)stats->unused[i],
+                   slots ? 100.0 * stats->unused[i] / slots : 0.0);
+        }
+    }
+    printf("issue/cycle     =");
+    for (int i = 0; i <= stats->width; i++)
+    {
+        printf(" %d:%.1f%%", i, stats->cycles ? 100.0 * stats->groupHist[i] / stats->cycles : 0.0);
+    }
+    printf("\n");
+}
@@ -0,0 +1,80 @@
+#ifndef SUPERSCALAR_H
+#define SUPERSCALAR_H
+
+#include "cpu.h"
+
+/**
+ * 순차 N-wide 슈퍼스칼라 엔진 (-e superscalar, -w로 폭)
+ * 매 클록 issue -> decode -> fetch 순서
+ *
+ * - fetch: 클록마다 fetchBytes 바이트를 fetch 버퍼로 (명령어 경계와 상관없이 바이트 단위)
+ * - decode: 버퍼 앞에서부터 opcode 바이트로 길이(1/2/3/6)를 정해 한 클록에 N개까지 경계를 나눔
+ *   명령어 바이트가 아직 다 안 왔으면 기다림, JMP를 만나면 뒤쪽 바이트를 버리고 대상에서 다시 fetch
+ * - issue: 명령어 큐 앞에서부터 순서대로 N개까지 한 묶음, 다음 규칙(pairing)을 어기면 묶음을 거기서 끊음
+ *     1. 앞선 결과가 아직 안 나온 레지스터를 읽지 않음 (ALU 지연, load 지연)
+ *     2. 같은 묶음 안의 앞 명령어가 쓰는 레지스터를 읽거나 쓰지 않음 (RAW/WAW)
+ *     3. 메모리 명령어는 묶음마다 memPorts개까지
+ *     4. JMP는 묶음의 마지막, 6바이트 MOV_RF/MOV_FR는 혼자
+ *   issue한 명령어는 그 자리에서 기능 실행 코어로 실행 (순서대로이므로 결과는 runVM()과 같음)
+ * - store가 fetch 버퍼의 바이트를 바꾸면 버퍼만 고치고, decode한 명령어의 바이트면 큐를 비우고 다음 명령어부터 다시 fetch
+ * 클록마다 쓰지 못한 issue 슬롯을 처음 막은 원인별로 셈
+ */
+
+#define SUPERSCALAR_MAX_WIDTH 8
+#define SUPERSCALAR_MAX_FETCH 32 // 클록당 fetch 바이트 최대값
+
+// 쓰지 못한 issue 슬롯의 원인
+typedef enum {
+    SLOT_EMPTY,  // 명령어 큐가 빔 (fetch/decode가 못 따라옴, JMP 직후, 캐시 미스)
+    SLOT_DATA,   // 앞선 묶음의 결과를 기다림
+    SLOT_PAIR,   // 같은 묶음 안의 앞 명령어에 의존 (RAW/WAW)
+    SLOT_PORT,   // 메모리 포트가 모자람
+    SLOT_BRANCH, // JMP 뒤는 다음 묶음
+    SLOT_WIDE,   // MOV_RF/MOV_FR는 혼자 issue
+    SLOT_FLUSH,  // 자기 수정 코드로 비움
+    SLOT_REASONS
+} SlotReason;
+
+typedef struct {
+    uint16_t width;       // decode/issue 폭
+    uint16_t fetchBytes;  // 클록당 fetch 바이트 (0 = 4 x width)
+    uint16_t memPorts;    // 묶음당 메모리 명령어 수
+    uint16_t aluLatency;  // ALU 결과를 쓸 수 있을 때까지 클록
+    uint16_t loadLatency; // 캐시가 없을 때 load 지연 (캐시가 있으면 캐시 지연)
+} SuperscalarConfig;
+
+typedef struct {
+    uint64_t cycles;
+    uint64_t retired;      // issue(실행)한 명령어 (HALT 포함)
+    uint64_t fetchedBytes; // fetch 버퍼에 넣은 바이트 (버린 것 포함)
+    uint64_t decoded;      // 경계를 나눈 명령어
+    uint64_t decodeWaits;  // 다음 명령어 바이트가 덜 와서 decode가 멈춘 클록
+    uint64_t fetchStalls;  // 명령어 캐시 미스로 fetch가 기다린 클록
+    uint64_t jmpRedirects; // decode에서 JMP로 fetch 방향을 바꾼 횟수
+    uint64_t smcFlushes;
+    uint64_t unused[SLOT_REASONS]; // 원인별 쓰지 못한 issue 슬롯
+    uint64_t groupHist[SUPERSCALAR_MAX_WIDTH + 1]; // 클록당 issue 수 분포
+    uint16_t width;        // 분포를 낸 폭
+} SuperscalarStats;
+
+// 기본값: 2-wide (dual issue), 8바이트 fetch, 메모리 포트 1, ALU 1클록, load 2클록
+void initSuperscalarConfig(SuperscalarConfig *cfg);
+
+/**
+ * -w 옵션 해석: "N" 또는 "N:key=value,..." (N = 1~8)
+ * key: fetch (바이트, 1~32), ports, alu, load (지연 1 이상)
+ * 예) 4:fetch=12,ports=2,load=3
+ */
+bool parseSuperscalarOption(SuperscalarConfig *cfg, const char *spec);
+
+/**
+ * 슈퍼스칼라 엔진으로 실행 (maxCycles = 0 이면 제한 없음)
+ * 제한에 걸리면 issue 안 된 명령어를 버리고 그 PC에서 멈춤 (다시 호출하면 이어서 실행)
+ * stats가 NULL이 아니면 통계를 더함, 실행한 클록 수를 반환
+ */
+uint64_t runSuperscalar(VM *vm, uint64_t maxCycles, const SuperscalarConfig *cfg, SuperscalarStats *stats);
+
+// 통계 출력 (IPC, issue 슬롯 사용률과 못 쓴 원인, 묶음 크기 분포)
+void printSuperscalarStats(const SuperscalarConfig *cfg, const SuperscalarStats *stats);
+
+#endif
@@ -0,0 +1,515 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "trace.h"
+
+_Static_assert(sizeof(TraceHeader) == 16, "TraceHeader layout");
+
+#define TRACE_RING_SIZE (1u << 16) // 링 버퍼 레코드 수 (1MiB, 2의 거듭제곱)
+#define TRACE_PUBLISH 256          // 실행 루프가 head를 공개하는 간격 (레코드 수, 2의 거듭제곱)
+#define TRACE_RELEASE 4096         // flush 스레드가 tail을 돌려주는 간격
+#define TRACE_OUT_SIZE (1 << 16)   // 파일 쓰기 버퍼
+#define TRACE_MAX_RECORD 20        // 압축한 레코드 하나의 최대 바이트 (1 + 3 + 2 + 6 + 5)
+#define TRACE_IDLE_NS 100000       // 링이 비었을 때 flush 스레드가 쉬는 시간
+
+// 링 버퍼 레코드 (실행 루프가 채우는 압축 전 형태)
+typedef struct {
+    uint32_t memAddr;
+    uint32_t cycles; // 이 명령어에 든 클록 수 (캐시 미스 대기 포함)
+    uint16_t pc;
+    uint8_t flags;   // opcode | TRACE_REG | TRACE_MEM
+    uint8_t reg;
+    uint8_t regValue;
+    uint8_t memValue;
+    uint8_t reserved[2];
+} TraceRecord;
+
+_Static_assert(sizeof(TraceRecord) == 16, "TraceRecord layout");
+
+// 압축 기준 (쓰는 쪽과 읽는 쪽이 레코드마다 같은 규칙으로 갱신)
+typedef struct {
+    uint32_t expectPC; // 앞 명령어가 순차 진행했을 때의 PC
+    uint32_t cycles;   // 앞 명령어의 클록 수
+    uint32_t memAddr;  // 앞 메모리 접근 주소
+} TraceState;
+
+// head/tail은 서로 다른 캐시 라인에 (실행 루프와 flush 스레드가 각자 씀)
+struct TraceWriter {
+    _Alignas(64) _Atomic uint64_t head; // 공개한 레코드 수 (실행 루프만 씀)
+    _Alignas(64) _Atomic uint64_t tail; // 압축을 끝낸 레코드 수 (flush 스레드만 씀)
+    _Atomic bool closing;               // head의 마지막 값을 공개한 뒤 true
+
+    // 실행 루프 전용
+    _Alignas(64) TraceRecord *ring;
+    uint64_t produced; // 링에 넣은 레코드 수 (head보다 최대 TRACE_PUBLISH - 1 앞섬)
+    uint64_t tailSeen; // 마지막으로 읽은 tail
+    uint64_t ringFull; // 링이 가득 차서 기다린 횟수
+
+    // flush 스레드 전용
+    _Alignas(64) TraceState state;
+    FILE *fp;
+    size_t outLen;
+    uint64_t bytes; // 파일에 쓴 바이트 (헤더 포함)
+    bool error;
+    uint8_t out[TRACE_OUT_SIZE];
+
+    pthread_t thread;
+    const char *path;
+};
+
+// opcode별 명령어 길이 (예상 PC 계산용, 압축 루프에서 함수 호출을 피하려고 한 번만 채움)
+static uint8_t lengthTable[TRACE_OP_MASK + 1];
+static pthread_once_t lengthOnce = PTHREAD_ONCE_INIT;
+
+static void fillLengthTable(void)
+{
+    for (int op = 0; op <= TRACE_OP_MASK; op++)
+    {
+        Instruction instr = {.opcode = (Opcode)op};
+        lengthTable[op] = (uint8_t)getInstructionSize(&instr);
+    }
+}
+
+static bool isStore(uint8_t op)
+{
+    return op == MOV_RM || op == MOV_RF;
+}
+
+/*  -------------------------------------
+        delta + varint 압축
+    -------------------------------------
+*/
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static uint8_t *putVarint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static bool getVarint(FILE *fp, uint64_t *v)
+{
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int c = getc(fp);
+        if (c == EOF)
+        {
+            return false;
+        }
+        *v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 레코드 하나를 p에 압축, 끝 위치 반환
+static uint8_t *encodeRecord(TraceState *s, const TraceRecord *r, uint8_t *p)
+{
+    uint8_t op = r->flags & TRACE_OP_MASK;
+    uint8_t header = r->flags;
+    if (r->pc != s->expectPC)
+    {
+        header |= TRACE_JUMP;
+    }
+    if (r->cycles != s->cycles)
+    {
+        header |= TRACE_CYCLE;
+    }
+    *p++ = header;
+    if (header & TRACE_JUMP)
+    {
+        p = putVarint(p, zigzag((int64_t)r->pc - s->expectPC));
+    }
+    if (header & TRACE_REG)
+    {
+        *p++ = r->reg;
+        *p++ = r->regValue;
+    }
+    if (header & TRACE_MEM)
+    {
+        p = putVarint(p, zigzag((int64_t)r->memAddr - s->memAddr));
+        *p++ = r->memValue;
+        s->memAddr = r->memAddr;
+    }
+    if (header & TRACE_CYCLE)
+    {
+        p = putVarint(p, r->cycles);
+        s->cycles = r->cycles;
+    }
+    s->expectPC = r->pc + lengthTable[op];
+    return p;
+}
+
+// 레코드 하나를 읽음, 파일이 레코드 중간에서 끝나면 false
+static bool decodeRecord(TraceState *s, FILE *fp, int header, TraceRecord *r)
+{
+    uint64_t v;
+    memset(r, 0, sizeof(*r));
+    r->flags = (uint8_t)(header & (TRACE_OP_MASK | TRACE_REG | TRACE_MEM));
+    r->pc = (uint16_t)s->expectPC;
+    if (header & TRACE_JUMP)
+    {
+        if (!getVarint(fp, &v))
+        {
+            return false;
+        }
+        r->pc = (uint16_t)(s->expectPC + unzigzag(v));
+    }
+    if (header & TRACE_REG)
+    {
+        int reg = getc(fp);
+        int value = getc(fp);
+        if (value == EOF)
+        {
+            return false;
+        }
+        r->reg = (uint8_t)reg;
+        r->regValue = (uint8_t)value;
+    }
+    if (header & TRACE_MEM)
+    {
+        if (!getVarint(fp, &v))
+        {
+            return false;
+        }
+        int value = getc(fp);
+        if (value == EOF)
+        {
+            return false;
+        }
+        s->memAddr = (uint32_t)(s->memAddr + unzigzag(v));
+        r->memAddr = s->memAddr;
+        r->memValue = (uint8_t)value;
+    }
+    if (header & TRACE_CYCLE)
+    {
+        if (!getVarint(fp, &v))
+        {
+            return false;
+        }
+        s->cycles = (uint32_t)v;
+    }
+    r->cycles = s->cycles;
+    s->expectPC = r->pc + lengthTable[header & TRACE_OP_MASK];
+    return true;
+}
+
+/*  -------------------------------------
+        flush 스레드 (SPSC 링의 소비자)
+    -------------------------------------
+*/
+
+static void writeOut(TraceWriter *t)
+{
+    if (t->outLen > 0 && !t->error && fwrite(t->out, 1, t->outLen, t->fp) != t->outLen)
+    {
+        t->error = true;
+    }
+    t->bytes += t->outLen;
+    t->outLen = 0;
+}
+
+static void *flushMain(void *arg)
+{
+    TraceWriter *t = arg;
+    uint64_t tail = 0;
+    for (;;)
+    {
+        // closing을 먼저 읽어야 그 뒤에 읽은 head가 마지막 값
+        bool closing = atomic_load_explicit(&t->closing, memory_order_acquire);
+        uint64_t head = atomic_load_explicit(&t->head, memory_order_acquire);
+        if (head == tail)
+        {
+            if (closing)
+            {
+                break;
+            }
+            struct timespec idle = {0, TRACE_IDLE_NS};
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        while (tail < head)
+        {
+            if (t->outLen > TRACE_OUT_SIZE - TRACE_MAX_RECORD)
+            {
+                writeOut(t);
+            }
+            uint8_t *end = encodeRecord(&t->state, &t->ring[tail & (TRACE_RING_SIZE - 1)], t->out + t->outLen);
+            t->outLen = (size_t)(end - t->out);
+            tail++;
+            if ((tail & (TRACE_RELEASE - 1)) == 0)
+            {
+                atomic_store_explicit(&t->tail, tail, memory_order_release);
+            }
+        }
+        atomic_store_explicit(&t->tail, tail, memory_order_release);
+    }
+    writeOut(t);
+    return NULL;
+}
+
+TraceWriter *openTrace(const char *path, uint64_t startCycle)
+{
+    pthread_once(&lengthOnce, fillLengthTable);
+    TraceWriter *t = aligned_alloc(64, sizeof(TraceWriter));
+    TraceRecord *ring = malloc(TRACE_RING_SIZE * sizeof(TraceRecord));
+    FILE *fp = fopen(path, "wb");
+    if (!t || !ring || !fp)
+    {
+        printf("Failed to open trace file: %s\n", path);
+        free(t);
+        free(ring);
+        if (fp)
+        {
+            fclose(fp);
+        }
+        return NULL;
+    }
+    memset(t, 0, sizeof(*t));
+    t->ring = ring;
+    t->fp = fp;
+    t->path = path;
+    atomic_init(&t->head, 0);
+    atomic_init(&t->tail, 0);
+    atomic_init(&t->closing, false);
+
+    TraceHeader h = {.version = TRACE_VERSION, .flags = TRACE_MULTICYCLE, .startCycle = startCycle};
+    memcpy(h.magic, TRACE_MAGIC, 4);
+    if (fwrite(&h, sizeof(h), 1, fp) != 1 || pthread_create(&t->thread, NULL, flushMain, t) != 0)
+    {
+        printf("Failed to open trace file: %s\n", path);
+        fclose(fp);
+        free(ring);
+        free(t);
+        return NULL;
+    }
+    t->bytes = sizeof(h);
+    return t;
+}
+
+bool closeTrace(TraceWriter *t)
+{
+    atomic_store_explicit(&t->head, t->produced, memory_order_release);
+    atomic_store_explicit(&t->closing, true, memory_order_release);
+    pthread_join(t->thread, NULL);
+    bool ok = !t->error;
+    if (fclose(t->fp) != 0)
+    {
+        ok = false;
+    }
+
+    if (ok)
+    {
+        printf("Trace written to %s: %llu instructions, %llu bytes (%.2f bytes/instruction)", t->path,
+               (unsigned long long)t->produced, (unsigned long long)t->bytes,
+               t->produced ? (double)t->bytes / t->produced : 0.0);
+        if (t->ringFull)
+        {
+            printf(", ring full %llu times", (unsigned long long)t->ringFull);
+        }
+        printf("\n");
+    }
+    else
+    {
+        printf("Failed to write trace file: %s\n", t->path);
+    }
+    free(t->ring);
+    free(t);
+    return ok;
+}
+
+/*  -------------------------------------
+        실행 루프 (SPSC 링의 생산자)
+    -------------------------------------
+*/
+
+// 링이 가득 차면 지금까지 넣은 레코드를 공개하고 flush 스레드가 비울 때까지 양보
+static void waitForSpace(TraceWriter *t)
+{
+    atomic_store_explicit(&t->head, t->produced, memory_order_release);
+    t->ringFull++;
+    for (;;)
+    {
+        t->tailSeen = atomic_load_explicit(&t->tail, memory_order_acquire);
+        if (t->produced - t->tailSeen < TRACE_RING_SIZE)
+        {
+            return;
+        }
+        sched_yield();
+    }
+}
+
+static inline TraceRecord *nextRecord(TraceWriter *t)
+{
+    if (t->produced - t->tailSeen == TRACE_RING_SIZE)
+    {
+        waitForSpace(t);
+    }
+    return &t->ring[t->produced & (TRACE_RING_SIZE - 1)];
+}
+
+// 레코드를 채운 뒤 호출, TRACE_PUBLISH개마다 한 번만 head를 공개
+static inline void commitRecord(TraceWriter *t)
+{
+    t->produced++;
+    if ((t->produced & (TRACE_PUBLISH - 1)) == 0)
+    {
+        atomic_store_explicit(&t->head, t->produced, memory_order_release);
+    }
+}
+
+// 끝난 명령어가 쓴 레지스터와 접근한 메모리 (값은 WB 후 레지스터에서)
+static void recordEffects(TraceRecord *r, const VM *vm, const Instruction *instr)
+{
+    switch (instr->opcode)
+    {
+    case MOV_RR:
+    case ADD_RR:
+    case SUB_RR:
+        r->flags |= TRACE_REG;
+        r->reg = instr->regA;
+        r->regValue = vm->cpu.regs[instr->regA];
+        break;
+    // MOV_MR reg, addr / MOV_FR reg, addr32
+    case MOV_MR:
+    case MOV_FR:
+        r->flags |= TRACE_REG | TRACE_MEM;
+        r->reg = instr->regA;
+        r->regValue = vm->cpu.regs[instr->regA];
+        r->memAddr = instr->imm;
+        r->memValue = r->regValue;
+        break;
+    // MOV_RM addr, reg / MOV_RF addr32, reg
+    case MOV_RM:
+    case MOV_RF:
+        r->flags |= TRACE_MEM;
+        r->memAddr = instr->imm;
+        r->memValue = vm->cpu.regs[instr->regB];
+        break;
+    default:
+        break;
+    }
+}
+
+// runVMFor()와 같은 결과, 명령어가 끝나거나 도중에 VM이 멈추면 레코드 하나
+uint64_t runTraced(VM *vm, uint64_t maxCycles, TraceWriter *trace)
+{
+    CPUState *cpu = &vm->cpu;
+    uint64_t cycles = 0;
+    uint64_t lastEnd = 0; // 앞 명령어가 끝난 클록
+    vm->running = true;
+    while (vm->running && (maxCycles == 0 || cycles < maxCycles))
+    {
+        uint16_t pc = cpu->PC;
+        bool fetchFault = cpu->stage == STAGE_FETCH && pc >= MEMORY_SIZE; // 시작한 명령어가 없음
+        cycles += runInstruction(vm, maxCycles ? maxCycles - cycles : 0);
+        // 클록 제한에 걸려 명령어 도중이면 다음 호출에서 이어서 (걸린 클록은 그 명령어에)
+        if (fetchFault || (vm->running && cpu->stage != STAGE_FETCH))
+        {
+            continue;
+        }
+
+        const Instruction *instr = &cpu->currentInstr;
+        uint8_t op = instr->opcode < INVALID ? (uint8_t)instr->opcode : INVALID;
+        TraceRecord *r = nextRecord(trace);
+        *r = (TraceRecord){.pc = pc, .cycles = (uint32_t)(cycles - lastEnd), .flags = op};
+        lastEnd = cycles;
+        // 오류로 멈춘 명령어는 아무것도 쓰지 않음 (HALT는 EX에서 멈춤)
+        if (vm->running || op == HALT)
+        {
+            recordEffects(r, vm, instr);
+        }
+        commitRecord(trace);
+    }
+    return cycles;
+}
+
+/*  -------------------------------------
+        텍스트 변환 (-X)
+    -------------------------------------
+*/
+
+bool dumpTrace(const char *path, FILE *out, uint64_t limit)
+{
+    pthread_once(&lengthOnce, fillLengthTable);
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        printf("Failed to open trace file: %s\n", path);
+        return false;
+    }
+    TraceHeader h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, TRACE_MAGIC, 4) != 0 || h.version != TRACE_VERSION)
+    {
+        printf("Not a trace file (or unsupported version): %s\n", path);
+        fclose(fp);
+        return false;
+    }
+
+    fprintf(out, "# %s trace, start cycle %llu\n", (h.flags & TRACE_MULTICYCLE) ? "multiCycle" : "singleCycle",
+            (unsigned long long)h.startCycle);
+    fprintf(out, "# %10s  %4s  %-7s  effects\n", "cycle", "PC", "opcode");
+
+    TraceState s = {0};
+    uint64_t cycle = h.startCycle;
+    uint64_t count = 0;
+    bool ok = true;
+    int header;
+    while ((limit == 0 || count < limit) && (header = getc(fp)) != EOF)
+    {
+        TraceRecord r;
+        if (!decodeRecord(&s, fp, header, &r))
+        {
+            ok = false;
+            break;
+        }
+        uint8_t op = r.flags & TRACE_OP_MASK;
+        cycle += r.cycles;
+        count++;
+        fprintf(out, "%12llu  %4u  %s", (unsigned long long)cycle, r.pc, opcodeName(op));
+        if (r.flags & (TRACE_REG | TRACE_MEM))
+        {
+            fprintf(out, "%*s", 7 - (int)strlen(opcodeName(op)), "");
+        }
+        if (r.flags & TRACE_REG)
+        {
+            fprintf(out, "  R%u=%u", r.reg, r.regValue);
+        }
+        if (r.flags & TRACE_MEM)
+        {
+            fprintf(out, "  [%u]%s%u", r.memAddr, isStore(op) ? "<-" : "->", r.memValue);
+        }
+        fprintf(out, "\n");
+    }
+    fclose(fp);
+
+    if (!ok)
+    {
+        printf("Trace truncated after %llu instructions: %s\n", (unsigned long long)count, path);
+        return false;
+    }
+    fprintf(out, "# %llu instructions\n", (unsigned long long)count);
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/**
+ * 실행 트레이스 (-T 기록, -X 텍스트 변환, multicycle 엔진)
+ * 명령어가 끝날 때마다 PC, opcode, 쓴 레지스터와 값, 메모리 주소와 값, 걸린 클록 수를 기록 (리틀 엔디언)
+ *
+ *   [TraceHeader 16바이트][레코드...]
+ *
+ * 실행 루프는 16바이트 고정 레코드를 lock-free SPSC 링 버퍼에 넣기만 하고
+ * flush 스레드가 앞 레코드 기준 delta + varint로 압축해서 파일에 씀
+ * 레코드 = 헤더 바이트 (하위 4비트 opcode + 아래 플래그) 뒤에 플래그 비트 순서대로 필드
+ * 명령어 길이만큼 순차 진행하고 클록 수가 앞과 같으면 헤더 바이트만 남음
+ */
+
+#define TRACE_MAGIC "VMTR"
+#define TRACE_VERSION 1
+
+// 레코드 헤더 바이트
+#define TRACE_OP_MASK 0x0F
+#define TRACE_JUMP 0x10  // PC가 앞 명령어 다음 주소가 아님: zigzag varint (PC - 예상 PC)
+#define TRACE_REG 0x20   // 레지스터 쓰기: 번호 1바이트, 값 1바이트
+#define TRACE_MEM 0x40   // 메모리 접근: zigzag varint (주소 - 앞 주소), 값 1바이트 (읽기/쓰기는 opcode로 구분)
+#define TRACE_CYCLE 0x80 // 명령어 클록 수가 앞 명령어와 다름: varint 클록 수
+
+// TraceHeader.flags
+#define TRACE_MULTICYCLE 0x0001 // multiCycle 트레이스 (없으면 singleCycle, 명령어당 1사이클)
+
+typedef struct {
+    char magic[4];       // "VMTR"
+    uint16_t version;    // TRACE_VERSION
+    uint16_t flags;
+    uint64_t startCycle; // 첫 명령어 직전 사이클 (-R로 이어 실행하면 체크포인트 위치)
+} TraceHeader;
+
+typedef struct TraceWriter TraceWriter;
+
+// path에 트레이스 파일을 만들고 flush 스레드 시작 (실패하면 NULL)
+TraceWriter *openTrace(const char *path, uint64_t startCycle);
+
+// 명령어가 끝날 때마다 트레이스를 남기면서 실행 (runVMFor()와 같은 결과), 실행한 클록 수 반환
+uint64_t runTraced(VM *vm, uint64_t maxCycles, TraceWriter *trace);
+
+// 남은 레코드를 쓰고 스레드를 끝낸 뒤 요약 출력, 쓰기 오류가 있었으면 false
+bool closeTrace(TraceWriter *trace);
+
+// 트레이스 파일을 한 줄에 명령어 하나씩 텍스트로 출력 (limit = 0이면 전부)
+bool dumpTrace(const char *path, FILE *out, uint64_t limit);
+
+#endif
@@ -0,0 +1,645 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include "asm.h"
+
+#define ASM_HASH_SIZE 2048 // 기호 해시 테이블 크기 (2의 거듭제곱)
+#define ASM_MAX_SYMBOLS (ASM_HASH_SIZE * 3 / 4)
+#define ASM_MAX_NAME 64
+#define ASM_MAX_ERRORS 50
+
+typedef struct {
+    char name[ASM_MAX_NAME];
+    long value; // MOV_RF/MOV_FR 주소까지 (32비트)
+    int line; // 정의한 줄 (0 = 빈 슬롯)
+} Symbol;
+
+typedef struct {
+    const char *file;
+    bool verbose;
+    int pass;   // 1: 주소 배치, 2: 값 계산 및 출력
+    int line;
+    int errors;
+    uint16_t pc; // 다음 바이트를 쓸 주소 (MEMORY_SIZE면 메모리 끝)
+    bool overflow;
+    int entry;
+    uint8_t memory[MEMORY_SIZE];
+    bool used[MEMORY_SIZE]; // 1패스에서 이미 배치한 바이트 (겹침 검사)
+    uint8_t regs[NUM_REGS];
+    uint32_t lines[MEMORY_SIZE]; // 명령어 시작 주소별 줄 번호 (2패스, 0 = 명령어 아님)
+    Symbol symbols[ASM_HASH_SIZE];
+    int symbolCount;
+} Assembler;
+
+Opcode lookupMnemonic(const char *name, size_t len)
+{
+    switch (len)
+    {
+    case 3:
+        if (memcmp(name, "NOP", 3) == 0)
+            return NOP;
+        if (memcmp(name, "JMP", 3) == 0)
+            return JMP;
+        break;
+    case 4:
+        if (memcmp(name, "HALT", 4) == 0)
+            return HALT;
+        break;
+    case 6:
+        switch (name[0])
+        {
+        case 'A':
+            return memcmp(name, "ADD_RR", 6) == 0 ? ADD_RR : INVALID;
+        case 'S':
+            return memcmp(name, "SUB_RR", 6) == 0 ? SUB_RR : INVALID;
+        case 'M':
+            if (memcmp(name, "MOV_", 4) != 0)
+                break;
+            if (name[4] == 'R' && name[5] == 'R')
+                return MOV_RR;
+            if (name[4] == 'R' && name[5] == 'M')
+                return MOV_RM;
+            if (name[4] == 'M' && name[5] == 'R')
+                return MOV_MR;
+            if (name[4] == 'R' && name[5] == 'F')
+                return MOV_RF;
+            if (name[4] == 'F' && name[5] == 'R')
+                return MOV_FR;
+            break;
+        }
+        break;
+    }
+    return INVALID;
+}
+
+bool isAssemblySource(const char *filename)
+{
+    const char *dot = strrchr(filename, '.');
+    return dot && (strcmp(dot, ".s") == 0 || strcmp(dot, ".asm") == 0);
+}
+
+static void asmError(Assembler *a, const char *fmt, ...)
+{
+    a->errors++;
+    if (!a->verbose || a->errors > ASM_MAX_ERRORS)
+    {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s:%d: error: ", a->file, a->line);
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+}
+
+/*  -------------------------------------
+        기호 테이블 (FNV-1a, 선형 탐색)
+    -------------------------------------
+*/
+
+static Symbol *findSymbol(Assembler *a, const char *name, size_t len, bool create)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        h = (h ^ (uint8_t)name[i]) * 16777619u;
+    }
+    for (uint32_t i = h & (ASM_HASH_SIZE - 1);; i = (i + 1) & (ASM_HASH_SIZE - 1))
+    {
+        Symbol *s = &a->symbols[i];
+        if (s->line == 0)
+        {
+            if (!create || a->symbolCount >= ASM_MAX_SYMBOLS)
+            {
+                return NULL;
+            }
+            a->symbolCount++;
+            memcpy(s->name, name, len);
+            s->name[len] = '\0';
+            return s;
+        }
+        if (strlen(s->name) == len && memcmp(s->name, name, len) == 0)
+        {
+            return s;
+        }
+    }
+}
+
+// 1패스에서만 정의 (2패스는 같은 값인지만 확인)
+static void defineSymbol(Assembler *a, const char *name, size_t len, long value)
+{
+    if (len >= ASM_MAX_NAME)
+    {
+        if (a->pass == 1)
+            asmError(a, "symbol name too long: %.*s", (int)len, name);
+        return;
+    }
+    Symbol *s = findSymbol(a, name, len, a->pass == 1);
+    if (!s)
+    {
+        if (a->pass == 1)
+            asmError(a, "too many symbols");
+        return;
+    }
+    if (a->pass == 1)
+    {
+        if (s->line != 0)
+        {
+            asmError(a, "'%.*s' already defined on line %d", (int)len, name, s->line);
+            return;
+        }
+        s->value = value;
+        s->line = a->line;
+    }
+}
+
+/*  -------------------------------------
+        토큰, 식
+    -------------------------------------
+*/
+
+static void skipSpace(const char **p)
+{
+    while (**p == ' ' || **p == '\t' || **p == '\r')
+    {
+        (*p)++;
+    }
+}
+
+static bool atLineEnd(const char *p)
+{
+    return *p == '\0' || *p == '#' || *p == ';';
+}
+
+static size_t identLength(const char *p)
+{
+    if (!(isalpha((unsigned char)*p) || *p == '_' || *p == '.'))
+    {
+        return 0;
+    }
+    size_t n = 1;
+    while (isalnum((unsigned char)p[n]) || p[n] == '_' || p[n] == '.')
+    {
+        n++;
+    }
+    return n;
+}
+
+// R0~R7 (r0~r7)
+static int registerName(const char *p, size_t len)
+{
+    if (len == 2 && (p[0] == 'R' || p[0] == 'r') && p[1] >= '0' && p[1] < '0' + NUM_REGS)
+    {
+        return p[1] - '0';
+    }
+    return -1;
+}
+
+/**
+ * 숫자/기호/레지스터 이름을 +, - 로 이은 식
+ * known = 모든 기호가 지금 정의되어 있음 (1패스의 앞쪽 참조는 false)
+ */
+static bool parseExpr(Assembler *a, const char **p, long *value, bool *known)
+{
+    long total = 0;
+    int sign = 1;
+    *known = true;
+
+    skipSpace(p);
+    if (**p == '-' || **p == '+')
+    {
+        sign = (**p == '-') ? -1 : 1;
+        (*p)++;
+    }
+
+    for (;;)
+    {
+        skipSpace(p);
+        long term = 0;
+        size_t len = identLength(*p);
+        if (isdigit((unsigned char)**p))
+        {
+            char *end;
+            unsigned long long v = strtoull(*p, &end, 0);
+            if (identLength(end) || isdigit((unsigned char)*end) || v > 0xFFFFFFFFull)
+            {
+                asmError(a, "bad number");
+                return false;
+            }
+            term = (long)v;
+            *p = end;
+        }
+        else if (len)
+        {
+            int reg = registerName(*p, len);
+            if (reg >= 0)
+            {
+                term = reg;
+            }
+            else
+            {
+                Symbol *s = (len < ASM_MAX_NAME) ? findSymbol(a, *p, len, false) : NULL;
+                if (s)
+                {
+                    term = s->value;
+                }
+                else
+                {
+                    *known = false;
+                    if (a->pass == 2)
+                        asmError(a, "undefined symbol '%.*s'", (int)len, *p);
+                }
+            }
+            *p += len;
+        }
+        else
+        {
+            asmError(a, "expected a value");
+            return false;
+        }
+
+        total += sign * term;
+        skipSpace(p);
+        if (**p == '+' || **p == '-')
+        {
+            sign = (**p == '-') ? -1 : 1;
+            (*p)++;
+            continue;
+        }
+        break;
+    }
+    *value = total;
+    return true;
+}
+
+// 쉼표(생략 가능)
+static void skipComma(const char **p)
+{
+    skipSpace(p);
+    if (**p == ',')
+    {
+        (*p)++;
+    }
+}
+
+static bool expectLineEnd(Assembler *a, const char *p)
+{
+    skipSpace(&p);
+    if (!atLineEnd(p))
+    {
+        if (a->pass == 1)
+            asmError(a, "unexpected '%.*s'", (int)strcspn(p, " \t\r#;"), p);
+        return false;
+    }
+    return true;
+}
+
+/*  -------------------------------------
+        출력
+    -------------------------------------
+*/
+
+static uint8_t toByte(Assembler *a, long value)
+{
+    if (a->pass == 2 && (value < -128 || value > 255))
+    {
+        asmError(a, "value %ld does not fit in a byte", value);
+    }
+    return (uint8_t)(value & 0xFF);
+}
+
+static void emitByte(Assembler *a, long value)
+{
+    if (a->pc >= MEMORY_SIZE)
+    {
+        if (a->pass == 1 && !a->overflow)
+            asmError(a, "program does not fit in %d bytes of memory", MEMORY_SIZE);
+        a->overflow = true;
+        return;
+    }
+    if (a->pass == 1)
+    {
+        if (a->used[a->pc])
+            asmError(a, "address %u is already used", a->pc);
+        a->used[a->pc] = true;
+    }
+    else
+    {
+        a->memory[a->pc] = toByte(a, value);
+    }
+    a->pc++;
+}
+
+// MOV_RF/MOV_FR의 32비트 주소 (리틀 엔디언)
+static void emitAddress(Assembler *a, long value)
+{
+    if (a->pass == 2 && (value < 0 || value > 0xFFFFFFFFl))
+    {
+        asmError(a, "address %ld does not fit in 32 bits", value);
+    }
+    for (int b = 0; b < 4; b++)
+    {
+        emitByte(a, (value >> (8 * b)) & 0xFF);
+    }
+}
+
+// 1패스에서 값이 정해져 있어야 하는 식 (.org, .zero, .equ)
+static bool parseLayoutExpr(Assembler *a, const char **p, long *value)
+{
+    bool known;
+    if (!parseExpr(a, p, value, &known))
+    {
+        return false;
+    }
+    if (!known)
+    {
+        if (a->pass == 1)
+            asmError(a, "value must be defined before this line");
+        return false;
+    }
+    return true;
+}
+
+static void assembleDirective(Assembler *a, const char *name, size_t len, const char *p)
+{
+    long value;
+    bool known;
+
+    if (len == 4 && memcmp(name, ".org", 4) == 0)
+    {
+        if (!parseLayoutExpr(a, &p, &value))
+            return;
+        if (value < 0 || value > MEMORY_SIZE)
+        {
+            if (a->pass == 1)
+                asmError(a, ".org %ld is outside memory", value);
+            return;
+        }
+        a->pc = (uint16_t)value;
+        a->overflow = false;
+        expectLineEnd(a, p);
+    }
+    else if (len == 5 && memcmp(name, ".byte", 5) == 0)
+    {
+        do
+        {
+            if (!parseExpr(a, &p, &value, &known))
+                return;
+            emitByte(a, value);
+            skipSpace(&p);
+        } while (*p == ',' && p++);
+        expectLineEnd(a, p);
+    }
+    else if (len == 5 && memcmp(name, ".zero", 5) == 0)
+    {
+        if (!parseLayoutExpr(a, &p, &value))
+            return;
+        if (value < 0 || a->pc + value > MEMORY_SIZE)
+        {
+            if (a->pass == 1)
+                asmError(a, ".zero %ld does not fit in memory", value);
+            return;
+        }
+        a->pc += value; // 메모리는 이미 0
+        expectLineEnd(a, p);
+    }
+    else if (len == 4 && memcmp(name, ".equ", 4) == 0)
+    {
+        skipSpace(&p);
+        size_t n = identLength(p);
+        if (!n || registerName(p, n) >= 0)
+        {
+            if (a->pass == 1)
+                asmError(a, ".equ needs a symbol name");
+            return;
+        }
+        const char *sym = p;
+        p += n;
+        skipComma(&p);
+        if (!parseLayoutExpr(a, &p, &value))
+            return;
+        defineSymbol(a, sym, n, value);
+        expectLineEnd(a, p);
+    }
+    else if (len == 6 && memcmp(name, ".entry", 6) == 0)
+    {
+        if (!parseExpr(a, &p, &value, &known))
+            return;
+        if (a->pass == 2)
+        {
+            if (value < 0 || value >= MEMORY_SIZE)
+                asmError(a, "entry %ld is outside memory", value);
+            a->entry = value;
+        }
+        expectLineEnd(a, p);
+    }
+    else if (a->pass == 1)
+    {
+        asmError(a, "unknown directive %.*s", (int)len, name);
+    }
+}
+
+static void assembleInstruction(Assembler *a, Opcode op, const char *name, size_t len, const char *p)
+{
+    int operands = (op == HALT || op == NOP) ? 0 : (op == JMP) ? 1 : 2;
+    long values[2] = {0, 0};
+    bool known;
+
+    for (int i = 0; i < operands; i++)
+    {
+        if (i > 0)
+            skipComma(&p);
+        skipSpace(&p);
+        if (atLineEnd(p))
+        {
+            if (a->pass == 1)
+                asmError(a, "%.*s needs %d operand%s", (int)len, name, operands, operands > 1 ? "s" : "");
+            return;
+        }
+        if (!parseExpr(a, &p, &values[i], &known))
+            return;
+    }
+    if (!expectLineEnd(a, p))
+        return;
+
+    if (a->pass == 2 && a->pc < MEMORY_SIZE)
+        a->lines[a->pc] = (uint32_t)a->line;
+    emitByte(a, op);
+    int offset = 1;
+    for (int i = 0; i < operands; i++)
+    {
+        if ((op == MOV_RF || op == MOV_FR) && offset == WIDE_ADDR_OFFSET(op))
+        {
+            emitAddress(a, values[i]);
+            offset += 4;
+        }
+        else
+        {
+            emitByte(a, values[i]);
+            offset++;
+        }
+    }
+}
+
+static void assembleLine(Assembler *a, const char *p)
+{
+    for (;;)
+    {
+        skipSpace(&p);
+        if (atLineEnd(p))
+        {
+            return;
+        }
+
+        size_t len = identLength(p);
+        if (!len)
+        {
+            if (a->pass == 1)
+                asmError(a, "unexpected '%c'", *p);
+            return;
+        }
+        const char *name = p;
+        p += len;
+
+        // 레이블 (한 줄에 여러 개, 뒤에 문장이 올 수 있음)
+        if (*p == ':')
+        {
+            if (registerName(name, len) >= 0 || name[0] == '.' || lookupMnemonic(name, len) != INVALID)
+            {
+                if (a->pass == 1)
+                    asmError(a, "'%.*s' cannot be used as a label", (int)len, name);
+            }
+            else
+            {
+                defineSymbol(a, name, len, a->pc);
+            }
+            p++;
+            continue;
+        }
+
+        if (name[0] == '.')
+        {
+            assembleDirective(a, name, len, p);
+            return;
+        }
+
+        // 레지스터 초기값 (R0 5)
+        int reg = registerName(name, len);
+        if (reg >= 0)
+        {
+            long value;
+            bool known;
+            if (parseExpr(a, &p, &value, &known) && expectLineEnd(a, p) && a->pass == 2)
+            {
+                a->regs[reg] = toByte(a, value);
+            }
+            return;
+        }
+
+        Opcode op = lookupMnemonic(name, len);
+        if (op == INVALID)
+        {
+            if (a->pass == 1)
+                asmError(a, "unknown mnemonic '%.*s'", (int)len, name);
+            return;
+        }
+        assembleInstruction(a, op, name, len, p);
+        return;
+    }
+}
+
+// src: 줄 끝을 '\0'으로 바꾼 소스 (size바이트)
+static void runPass(Assembler *a, int pass, const char *src, size_t size)
+{
+    a->pass = pass;
+    a->pc = 0;
+    a->overflow = false;
+    a->line = 0;
+
+    const char *p = src;
+    const char *end = src + size;
+    while (p < end)
+    {
+        a->line++;
+        assembleLine(a, p);
+        p += strlen(p) + 1;
+    }
+}
+
+bool assembleFile(VM *vm, const char *filename, bool verbose, uint32_t *lines)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+    {
+        if (verbose)
+            printf("Failed to open file: %s\n", filename);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    char *src = (fileSize >= 0) ? malloc((size_t)fileSize + 1) : NULL;
+    Assembler *a = calloc(1, sizeof(Assembler));
+    if (!src || !a || fread(src, 1, (size_t)fileSize, fp) != (size_t)fileSize)
+    {
+        if (verbose)
+            printf("Failed to read file: %s\n", filename);
+        fclose(fp);
+        free(src);
+        free(a);
+        return false;
+    }
+    fclose(fp);
+
+    // 줄마다 '\0'으로 끝나게 (두 패스가 같은 버퍼를 그대로 훑음)
+    size_t size = (size_t)fileSize;
+    src[size] = '\0';
+    for (size_t i = 0; i < size; i++)
+    {
+        if (src[i] == '\n')
+            src[i] = '\0';
+        else if (src[i] == '\0')
+            src[i] = ' ';
+    }
+
+    a->file = filename;
+    a->verbose = verbose;
+    memcpy(a->regs, vm->cpu.regs, NUM_REGS);
+
+    runPass(a, 1, src, size);
+    if (a->errors == 0)
+    {
+        runPass(a, 2, src, size);
+    }
+
+    bool ok = (a->errors == 0);
+    if (ok)
+    {
+        memcpy(vm->memory, a->memory, MEMORY_SIZE);
+        memcpy(vm->cpu.regs, a->regs, NUM_REGS);
+        vm->cpu.PC = (uint16_t)a->entry;
+        if (lines)
+            memcpy(lines, a->lines, sizeof(a->lines));
+
+        int bytes = 0;
+        for (int addr = 0; addr < MEMORY_SIZE; addr++)
+            bytes += a->used[addr];
+        if (verbose)
+            printf("Program assembled from %s: %d bytes, %d symbols. PC=%u\n", filename, bytes, a->symbolCount,
+                   vm->cpu.PC);
+    }
+    else if (verbose)
+    {
+        if (a->errors > ASM_MAX_ERRORS)
+            printf("%s: %d more errors\n", filename, a->errors - ASM_MAX_ERRORS);
+        printf("%s: %d error%s, nothing loaded\n", filename, a->errors, a->errors > 1 ? "s" : "");
+    }
+
+    free(src);
+    free(a);
+    return ok;
+}
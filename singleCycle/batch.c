@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+
+/**
+ * SIMD lockstep 배치 엔진
+ * 같은 프로그램을 서로 다른 초기 레지스터로 돌리는 VM들을 BATCH_LANES개씩 묶어
+ * regs[r][lane], memory[addr][lane] 배치로 저장하고, 한 명령어를 모든 lane에 동시에 적용한다.
+ * GCC 벡터 확장을 쓰므로 -mavx2면 32 lane(AVX2), 아니면 16 lane(SSE2)으로 컴파일됨.
+ *
+ * 보통은 모든 lane의 PC가 같다 (조건 분기가 없으므로).
+ * MOV_RM이 lane마다 다른 값을 코드에 써서 PC나 명령어 바이트가 갈라지면
+ * 가장 작은 PC의 명령어를 그 PC에 있고 바이트가 같은 lane에만 적용하고 나머지는 마스킹.
+ * HALT나 오류로 멈춘 lane은 active에서 빠진다.
+ */
+
+typedef int8_t LaneMask __attribute__((vector_size(BATCH_LANES)));
+typedef int16_t LaneMask16 __attribute__((vector_size(BATCH_LANES * 2)));
+typedef int32_t LaneMask32 __attribute__((vector_size(BATCH_LANES * 4)));
+typedef uint64_t LaneWords __attribute__((vector_size(BATCH_LANES)));
+
+// 빠른 경로에서 pc + 1, pc + 2 를 범위 검사 없이 읽기 위한 여유
+#define MAX_OPERAND_BYTES 2
+
+// m이 0xFF인 lane은 a, 아니면 b
+#define SELECT(m, a, b) (((a) & (m)) | ((b) & ~(m)))
+
+// 모든 lane에 같은 바이트
+#define SPLAT(v) ((LaneVec){0} + (uint8_t)(v))
+
+// lane 마스크 -> 비트마스크 (lane이 멈출 때만 사용)
+static uint32_t laneBits(LaneVec m)
+{
+    uint32_t bits = 0;
+    for (int l = 0; l < BATCH_LANES; l++)
+    {
+        if (m[l])
+        {
+            bits |= 1u << l;
+        }
+    }
+    return bits;
+}
+
+static bool sameMask(LaneVec a, LaneVec b)
+{
+    LaneWords x = (LaneWords)(a ^ b);
+    uint64_t any = 0;
+    for (int i = 0; i < BATCH_LANES / 8; i++)
+    {
+        any |= x[i];
+    }
+    return any == 0;
+}
+
+bool initBatch(BatchVM *batch, const VM *image, size_t count)
+{
+    batch->count = count;
+    batch->groupCount = (count + BATCH_LANES - 1) / BATCH_LANES;
+    size_t bytes = batch->groupCount * sizeof(LaneGroup);
+    batch->groups = aligned_alloc(_Alignof(LaneGroup), bytes);
+    if (!batch->groups)
+    {
+        printf("Failed to allocate %zu VMs\n", count);
+        return false;
+    }
+
+    for (size_t gi = 0; gi < batch->groupCount; gi++)
+    {
+        LaneGroup *g = &batch->groups[gi];
+        memset(g, 0, sizeof(*g));
+        for (int r = 0; r < NUM_REGS; r++)
+        {
+            g->regs[r] = SPLAT(image->cpu.regs[r]);
+        }
+        for (int addr = 0; addr < MEMORY_SIZE; addr++)
+        {
+            g->memory[addr] = SPLAT(image->memory[addr]);
+        }
+        g->pc = (LanePC){0} + image->cpu.PC;
+        // 마지막 묶음의 남는 lane은 처음부터 꺼 둠
+        for (int l = 0; l < BATCH_LANES; l++)
+        {
+            g->active[l] = (gi * BATCH_LANES + l < count) ? 0xFF : 0;
+        }
+    }
+    return true;
+}
+
+void freeBatch(BatchVM *batch)
+{
+    free(batch->groups);
+    batch->groups = NULL;
+    batch->count = batch->groupCount = 0;
+}
+
+void setLaneReg(BatchVM *batch, size_t lane, int reg, uint8_t value)
+{
+    batch->groups[lane / BATCH_LANES].regs[reg & (NUM_REGS - 1)][lane % BATCH_LANES] = value;
+}
+
+void getLaneVM(const BatchVM *batch, size_t lane, VM *out)
+{
+    const LaneGroup *g = &batch->groups[lane / BATCH_LANES];
+    int l = lane % BATCH_LANES;
+
+    memset(out, 0, sizeof(*out));
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        out->cpu.regs[r] = g->regs[r][l];
+    }
+    for (int addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        out->memory[addr] = g->memory[addr][l];
+    }
+    out->cpu.PC = g->pc[l];
+    // 명령어 수 제한으로 멈춘 lane은 아직 실행 중
+    out->running = !g->halted[l];
+    // lane별 저장 위치는 따로 추적하지 않으므로 모든 라인을 바뀐 것으로
+    out->dirty = DIRTY_ALL;
+}
+
+// 실행 중인 lane 중 가장 많이 실행한 명령어 수
+static uint32_t maxActiveSteps(const LaneGroup *g)
+{
+    uint32_t max = 0;
+    for (int l = 0; l < BATCH_LANES; l++)
+    {
+        if (g->active[l] && g->steps[l] > max)
+        {
+            max = g->steps[l];
+        }
+    }
+    return max;
+}
+
+// 실행 중인 lane의 PC가 모두 같은지, 다르면 가장 작은 PC의 lane
+static bool findLeader(const LaneGroup *g, int *leader)
+{
+    bool uniform = true;
+    int best = -1;
+    for (int l = 0; l < BATCH_LANES; l++)
+    {
+        if (!g->active[l])
+        {
+            continue;
+        }
+        if (best < 0)
+        {
+            best = l;
+        }
+        else if (g->pc[l] != g->pc[best])
+        {
+            uniform = false;
+            if (g->pc[l] < g->pc[best])
+            {
+                best = l;
+            }
+        }
+    }
+    *leader = best;
+    return uniform;
+}
+
+// 실행 중인 lane이 모두 같은 PC, 같은 명령어 바이트일 때의 빠른 경로
+// PC와 명령어 수는 스칼라로 들고 있다가 나올 때 active lane에만 반영
+// HALT/오류, lane 분기, budget 소진 시 그 명령어를 실행하지 않고 돌아옴
+static uint32_t runUniform(LaneGroup *g, int leader, uint32_t budget)
+{
+    const LaneVec active = g->active;
+    uint16_t pc = g->pc[leader];
+    uint32_t count = 0;
+
+    while (count < budget && pc + MAX_OPERAND_BYTES < MEMORY_SIZE)
+    {
+        uint8_t op = g->memory[pc][leader];
+        uint8_t b1 = g->memory[pc + 1][leader];
+        uint8_t b2 = g->memory[pc + 2][leader];
+        LaneVec same = (LaneVec)(g->memory[pc] == SPLAT(op));
+        uint8_t a = b1 & (NUM_REGS - 1);
+        uint8_t b = b2 & (NUM_REGS - 1);
+
+        switch (op)
+        {
+        case NOP:
+            if (!sameMask(same & active, active))
+                goto out;
+            pc += 1;
+            break;
+        case JMP:
+            same &= (LaneVec)(g->memory[pc + 1] == SPLAT(b1));
+            if (!sameMask(same & active, active))
+                goto out;
+            pc = b1;
+            break;
+        case MOV_RR:
+        case MOV_RM:
+        case MOV_MR:
+        case ADD_RR:
+        case SUB_RR:
+            same &= (LaneVec)(g->memory[pc + 1] == SPLAT(b1));
+            same &= (LaneVec)(g->memory[pc + 2] == SPLAT(b2));
+            if (!sameMask(same & active, active))
+                goto out;
+            if (op == MOV_RR)
+                g->regs[a] = SELECT(active, g->regs[b], g->regs[a]);
+            else if (op == MOV_RM)
+                g->memory[b2] = SELECT(active, g->regs[a], g->memory[b2]);
+            else if (op == MOV_MR)
+                g->regs[b] = SELECT(active, g->memory[b1], g->regs[b]);
+            else if (op == ADD_RR)
+                g->regs[a] = SELECT(active, g->regs[a] + g->regs[b], g->regs[a]);
+            else
+                g->regs[a] = SELECT(active, g->regs[a] - g->regs[b], g->regs[a]);
+            pc += 3;
+            break;
+        default: // HALT, MOV_RF/MOV_FR, INVALID는 일반 경로에서 처리
+            goto out;
+        }
+        count++;
+    }
+
+out:
+    if (count > 0)
+    {
+        LanePC m16 = (LanePC)__builtin_convertvector((LaneMask)active, LaneMask16);
+        LaneSteps m32 = (LaneSteps)__builtin_convertvector((LaneMask)active, LaneMask32);
+        g->pc = SELECT(m16, (LanePC){0} + pc, g->pc);
+        g->steps += m32 & count;
+    }
+    return count;
+}
+
+// 묶음 하나를 모든 lane이 멈출 때까지 실행 (base = 묶음 첫 lane의 전체 번호, 오류 메시지용)
+static uint64_t runGroup(LaneGroup *g, int base, uint32_t limit)
+{
+    uint64_t total = 0;
+    uint32_t activeBits = laneBits(g->active);
+    int activeCount = __builtin_popcount(activeBits);
+    uint32_t maxSteps = maxActiveSteps(g);
+    int leader;
+    bool uniform = findLeader(g, &leader);
+
+    while (activeBits)
+    {
+        // 명령어 수 제한에 닿은 lane은 멈춤 (halted는 아님)
+        if (maxSteps >= limit)
+        {
+            LaneVec done = (LaneVec)__builtin_convertvector(g->steps >= limit, LaneMask);
+            g->active &= ~done;
+            activeBits = laneBits(g->active);
+            activeCount = __builtin_popcount(activeBits);
+            maxSteps = maxActiveSteps(g);
+            uniform = findLeader(g, &leader);
+            continue;
+        }
+
+        if (uniform)
+        {
+            uint32_t count = runUniform(g, leader, limit - maxSteps);
+            total += (uint64_t)count * activeCount;
+            maxSteps += count;
+            if (count > 0)
+            {
+                continue;
+            }
+        }
+
+        uint16_t pc = g->pc[leader];
+        LaneVec m = g->active;
+        if (!uniform)
+        {
+            LaneMask16 samePC = g->pc == (LanePC){0} + pc;
+            m &= (LaneVec)__builtin_convertvector(samePC, LaneMask);
+        }
+
+        if (pc >= MEMORY_SIZE)
+        {
+            printf("Error: PC out of memory range! (lane %d)\n", base + leader);
+            g->halted |= m;
+            g->active &= ~m;
+            goto lanes_changed;
+        }
+
+        // 명령어 바이트가 leader와 같은 lane만 실행 (자기 수정 코드로 갈라질 수 있음)
+        uint8_t op = g->memory[pc][leader];
+        uint8_t b1 = (pc + 1 < MEMORY_SIZE) ? g->memory[pc + 1][leader] : 0;
+        uint8_t b2 = (pc + 2 < MEMORY_SIZE) ? g->memory[pc + 2][leader] : 0;
+        Instruction instr = {.opcode = (op < INVALID) ? (Opcode)op : INVALID};
+        uint16_t size = getInstructionSize(&instr);
+        m &= (LaneVec)(g->memory[pc] == SPLAT(op));
+        if (size > 1 && pc + 1 < MEMORY_SIZE)
+        {
+            m &= (LaneVec)(g->memory[pc + 1] == SPLAT(b1));
+        }
+        if (size > 2 && pc + 2 < MEMORY_SIZE)
+        {
+            m &= (LaneVec)(g->memory[pc + 2] == SPLAT(b2));
+        }
+
+        LanePC m16 = (LanePC)__builtin_convertvector((LaneMask)m, LaneMask16);
+        LanePC nextPC = g->pc + size;
+        uint8_t a = b1 & (NUM_REGS - 1);
+        uint8_t b = b2 & (NUM_REGS - 1);
+        bool stop = false;
+
+        switch (instr.opcode)
+        {
+        case HALT:
+            stop = true;
+            break;
+        case NOP:
+            break;
+        case MOV_RR:
+            g->regs[a] = SELECT(m, g->regs[b], g->regs[a]);
+            break;
+        case MOV_RM: // [b2] <- regA
+            g->memory[b2] = SELECT(m, g->regs[a], g->memory[b2]);
+            break;
+        case MOV_MR: // regB <- [b1]
+            g->regs[b] = SELECT(m, g->memory[b1], g->regs[b]);
+            break;
+        case ADD_RR:
+            g->regs[a] = SELECT(m, g->regs[a] + g->regs[b], g->regs[a]);
+            break;
+        case SUB_RR:
+            g->regs[a] = SELECT(m, g->regs[a] - g->regs[b], g->regs[a]);
+            break;
+        case JMP:
+            nextPC = (LanePC){0} + b1;
+            break;
+        case MOV_RF:
+        case MOV_FR:
+            // lane마다 페이지 메모리를 따로 둘 수 없으므로 넓은 주소는 일반 VM 엔진에서만
+            printf("Error: %s is not supported by the batch engine at PC=%u (lane %d)\n",
+                   instr.opcode == MOV_RF ? "MOV_RF" : "MOV_FR", pc, base + leader);
+            stop = true;
+            break;
+        case INVALID:
+        default:
+            printf("Error: Invalid opcode (0x%X) at PC=%u (lane %d)\n", INVALID, pc, base + leader);
+            stop = true;
+            break;
+        }
+
+        g->pc = SELECT(m16, nextPC, g->pc);
+        g->steps -= (LaneSteps)__builtin_convertvector((LaneMask)m, LaneMask32);
+
+        bool allMatched = sameMask(m, g->active);
+        total += allMatched ? (uint64_t)activeCount : (uint64_t)__builtin_popcount(laneBits(m));
+        if (stop)
+        {
+            g->halted |= m;
+            g->active &= ~m;
+            goto lanes_changed;
+        }
+        if (allMatched && uniform)
+        {
+            maxSteps++;
+            continue;
+        }
+
+    lanes_changed:
+        activeBits = laneBits(g->active);
+        activeCount = __builtin_popcount(activeBits);
+        maxSteps = maxActiveSteps(g);
+        uniform = findLeader(g, &leader);
+    }
+    return total;
+}
+
+uint64_t runBatch(BatchVM *batch, uint64_t maxSteps)
+{
+    uint32_t limit = (maxSteps == 0 || maxSteps > UINT32_MAX) ? UINT32_MAX : (uint32_t)maxSteps;
+    uint64_t total = 0;
+    for (size_t gi = 0; gi < batch->groupCount; gi++)
+    {
+        total += runGroup(&batch->groups[gi], (int)(gi * BATCH_LANES), limit);
+    }
+    return total;
+}
@@ -0,0 +1,53 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include "cpu.h"
+
+// 벡터 하나에 들어가는 VM 수 (8비트 레지스터이므로 벡터 바이트 수 = lane 수)
+// 하드웨어보다 넓은 벡터는 GCC가 바이트 단위 스칼라 코드로 풀어 버리므로 대상에 맞춤
+#ifdef __AVX2__
+#define BATCH_LANES 32 // AVX2 256비트
+#else
+#define BATCH_LANES 16 // SSE2 128비트
+#endif
+
+typedef uint8_t LaneVec __attribute__((vector_size(BATCH_LANES)));
+typedef uint16_t LanePC __attribute__((vector_size(BATCH_LANES * 2)));
+typedef uint32_t LaneSteps __attribute__((vector_size(BATCH_LANES * 4)));
+
+// 같은 프로그램을 lockstep으로 실행하는 VM BATCH_LANES개 (structure-of-arrays)
+typedef struct {
+    LaneVec regs[NUM_REGS];      // regs[r][lane]
+    LaneVec memory[MEMORY_SIZE]; // memory[addr][lane]
+    LanePC pc;                   // lane별 PC
+    LaneSteps steps;             // lane별 실행한 명령어 수
+    LaneVec active;              // 0xFF = 실행 중
+    LaneVec halted;              // 0xFF = HALT 또는 오류로 멈춤
+} LaneGroup;
+
+// N개의 VM 묶음
+typedef struct {
+    size_t count;      // VM 수
+    size_t groupCount; // LaneGroup 수 (count / BATCH_LANES 올림)
+    LaneGroup *groups;
+} BatchVM;
+
+// image를 count개 복제 (실패하면 false)
+bool initBatch(BatchVM *batch, const VM *image, size_t count);
+
+void freeBatch(BatchVM *batch);
+
+// lane의 레지스터 초기값 설정
+void setLaneReg(BatchVM *batch, size_t lane, int reg, uint8_t value);
+
+/**
+ * 모든 lane을 lockstep으로 실행
+ * maxSteps = 0 이면 제한 없음 (lane당 최대 2^32 - 1), 전체 lane의 실행 명령어 합을 반환
+ */
+uint64_t runBatch(BatchVM *batch, uint64_t maxSteps);
+
+// lane 하나의 상태를 일반 VM으로 꺼냄
+void getLaneVM(const BatchVM *batch, size_t lane, VM *out);
+
+#endif
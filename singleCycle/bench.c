@@ -0,0 +1,143 @@
+// bench.c
+// 엔진별 초당 실행 명령어 수(IPS) 비교
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpu.h"
+#include "load.h"
+#include "engine.h"
+#include "threaded.h"
+#include "batch.h"
+
+#define BENCH_REPS 5
+// 스윕 비교에 쓰는 VM 수
+#define SWEEP_LANES 1024
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filename = "bench/loop.txt";
+    uint64_t steps = 50000000;
+    if (argc > 1)
+    {
+        filename = argv[1];
+    }
+    if (argc > 2)
+    {
+        steps = strtoull(argv[2], NULL, 0);
+    }
+
+    VM image;
+    initVM(&image);
+    loadProgramFromFile(&image, filename);
+
+    printf("program: %s, %llu instructions x %d reps, threaded dispatch: %s\n",
+           filename, (unsigned long long)steps, BENCH_REPS, threadedDispatchMode());
+    printf("%-10s %12s %14s %8s\n", "engine", "median(s)", "MIPS", "speedup");
+
+    VM reference;
+    double baseline = 0;
+    for (int e = 0; e < ENGINE_COUNT; e++)
+    {
+        double times[BENCH_REPS];
+        uint64_t executed = 0;
+        VM vm;
+        for (int r = 0; r < BENCH_REPS; r++)
+        {
+            vm = image;
+            double t0 = nowSeconds();
+            executed = runEngine(&vm, (EngineType)e, steps);
+            times[r] = nowSeconds() - t0;
+        }
+        qsort(times, BENCH_REPS, sizeof(double), compareDouble);
+        double median = times[BENCH_REPS / 2];
+        if (e == 0)
+        {
+            baseline = median;
+            reference = vm;
+        }
+
+        // 최종 상태가 기준 엔진과 같은지 확인
+        bool same = memcmp(&vm.cpu, &reference.cpu, sizeof(CPUState)) == 0 &&
+                    memcmp(vm.memory, reference.memory, MEMORY_SIZE) == 0;
+        printf("%-10s %12.4f %14.1f %7.2fx%s\n", engineName((EngineType)e), median,
+               executed / median / 1e6, baseline / median, same ? "" : "  (state mismatch!)");
+    }
+
+    // 파라미터 스윕: 같은 명령어 수를 SWEEP_LANES개 VM에 나눠서
+    // decoded로 하나씩 돌릴 때와 batch로 lockstep 실행할 때 비교
+    uint64_t perLane = steps / SWEEP_LANES;
+    printf("\nsweep: %d VMs x %llu instructions\n", SWEEP_LANES, (unsigned long long)perLane);
+    printf("%-10s %12s %14s %8s\n", "engine", "median(s)", "MIPS", "speedup");
+    double sweepBase = 0;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        double times[BENCH_REPS];
+        uint64_t executed = 0;
+        bool same = true;
+        for (int r = 0; r < BENCH_REPS; r++)
+        {
+            double t0 = nowSeconds();
+            executed = 0;
+            if (mode == 0)
+            {
+                for (int i = 0; i < SWEEP_LANES; i++)
+                {
+                    VM vm = image;
+                    vm.cpu.regs[0] += i;
+                    executed += runEngine(&vm, ENGINE_DECODED, perLane);
+                }
+                times[r] = nowSeconds() - t0;
+            }
+            else
+            {
+                BatchVM batch;
+                if (!initBatch(&batch, &image, SWEEP_LANES))
+                {
+                    return 1;
+                }
+                for (int i = 0; i < SWEEP_LANES; i++)
+                {
+                    setLaneReg(&batch, i, 0, (uint8_t)(image.cpu.regs[0] + i));
+                }
+                executed = runBatch(&batch, perLane);
+                times[r] = nowSeconds() - t0;
+
+                // lane 몇 개를 골라 decoded 결과와 비교
+                for (int i = 0; i < SWEEP_LANES; i += SWEEP_LANES / 8)
+                {
+                    VM lane, vm = image;
+                    vm.cpu.regs[0] += i;
+                    runEngine(&vm, ENGINE_DECODED, perLane);
+                    getLaneVM(&batch, i, &lane);
+                    same = same && memcmp(&lane.cpu, &vm.cpu, sizeof(CPUState)) == 0 &&
+                           memcmp(lane.memory, vm.memory, MEMORY_SIZE) == 0;
+                }
+                freeBatch(&batch);
+            }
+        }
+        qsort(times, BENCH_REPS, sizeof(double), compareDouble);
+        double median = times[BENCH_REPS / 2];
+        if (mode == 0)
+        {
+            sweepBase = median;
+        }
+        printf("%-10s %12.4f %14.1f %7.2fx%s\n", mode ? "batch" : "decoded", median,
+               executed / median / 1e6, sweepBase / median, same ? "" : "  (state mismatch!)");
+    }
+    return 0;
+}
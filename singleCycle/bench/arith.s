@@ -0,0 +1,15 @@
+# 벤치마크 커널: 산술 의존 체인 (앞 결과를 바로 다음 명령어가 씀)
+# HALT 없음, -n 으로 명령어 수 제한
+        R1 1
+        R2 3
+loop:   ADD_RR R0, R1
+        ADD_RR R0, R2
+        SUB_RR R0, R1
+        MOV_RR R3, R0
+        ADD_RR R3, R3
+        SUB_RR R4, R3
+        ADD_RR R1, R4
+        MOV_RR R5, R1
+        SUB_RR R5, R0
+        ADD_RR R2, R5
+        JMP loop
@@ -0,0 +1,22 @@
+# 벤치마크 커널: 메모리 복사 (src 8바이트를 dst로, MOV_MR/MOV_RM 한 쌍씩 풀어 씀)
+# HALT 없음, -n 으로 명령어 수 제한
+loop:   MOV_MR src, R0
+        MOV_RM R0, dst
+        MOV_MR src+1, R1
+        MOV_RM R1, dst+1
+        MOV_MR src+2, R2
+        MOV_RM R2, dst+2
+        MOV_MR src+3, R3
+        MOV_RM R3, dst+3
+        MOV_MR src+4, R4
+        MOV_RM R4, dst+4
+        MOV_MR src+5, R5
+        MOV_RM R5, dst+5
+        MOV_MR src+6, R6
+        MOV_RM R6, dst+6
+        MOV_MR src+7, R7
+        MOV_RM R7, dst+7
+        JMP loop
+
+src:    .byte 1, 2, 3, 4, 5, 6, 7, 8
+dst:    .zero 8
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include "checkpoint.h"
+#include "paged.h"
+
+static uint32_t hashMemory(const uint8_t *memory)
+{
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < MEMORY_SIZE; i++)
+    {
+        h = (h ^ memory[i]) * 16777619u;
+    }
+    return h;
+}
+
+bool openCheckpointLog(CheckpointLog *log, const char *path)
+{
+    memset(log, 0, sizeof(*log));
+    if (!path)
+    {
+        return true;
+    }
+
+    log->fp = fopen(path, "wb");
+    if (!log->fp)
+    {
+        printf("Failed to create checkpoint file: %s\n", path);
+        return false;
+    }
+    CheckpointFileHeader h = {
+        .version = CHECKPOINT_VERSION,
+        .memorySize = MEMORY_SIZE,
+        .lineSize = DIRTY_LINE_SIZE,
+        .cpuStateSize = sizeof(CPUState),
+    };
+    memcpy(h.magic, CHECKPOINT_MAGIC, 4);
+    if (fwrite(&h, sizeof(h), 1, log->fp) != 1)
+    {
+        printf("Failed to write checkpoint file: %s\n", path);
+        fclose(log->fp);
+        log->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+void closeCheckpointLog(CheckpointLog *log)
+{
+    if (log->fp)
+    {
+        fclose(log->fp);
+        log->fp = NULL;
+    }
+}
+
+bool saveCheckpoint(CheckpointLog *log, VM *vm, uint64_t steps)
+{
+    // 페이지 메모리(MEMORY_SIZE 이상 주소)는 기록하지 않으므로 쓴 적이 있으면 거부
+    if (vm->paged && vm->paged->pages > 0)
+    {
+        printf("Checkpoints do not cover paged memory (MOV_RF above address %d)\n", MEMORY_SIZE - 1);
+        return false;
+    }
+    // 첫 체크포인트는 전체, 이후에는 dirty 라인 중 실제로 값이 바뀐 것만
+    uint32_t lines = (log->count == 0) ? DIRTY_ALL : vm->dirty;
+    uint8_t data[MEMORY_SIZE];
+    size_t len = 0;
+    for (uint32_t bits = lines; bits; bits &= bits - 1)
+    {
+        int line = __builtin_ctz(bits);
+        uint8_t *src = &vm->memory[line * DIRTY_LINE_SIZE];
+        uint8_t *dst = &log->base[line * DIRTY_LINE_SIZE];
+        if (log->count > 0 && memcmp(src, dst, DIRTY_LINE_SIZE) == 0)
+        {
+            lines &= ~(1u << line); // 같은 값을 다시 쓴 라인
+            continue;
+        }
+        memcpy(dst, src, DIRTY_LINE_SIZE);
+        memcpy(&data[len], src, DIRTY_LINE_SIZE);
+        len += DIRTY_LINE_SIZE;
+    }
+    log->cpu = vm->cpu;
+    log->running = vm->running;
+    log->steps = steps;
+    log->count++;
+    log->linesWritten += len / DIRTY_LINE_SIZE;
+    vm->dirty = 0;
+
+    if (!log->fp)
+    {
+        return true;
+    }
+    CheckpointRecord r = {
+        .steps = steps,
+        .lines = lines,
+        .memHash = hashMemory(log->base),
+        .running = vm->running,
+    };
+    if (fwrite(&r, sizeof(r), 1, log->fp) != 1 ||
+        fwrite(&vm->cpu, sizeof(CPUState), 1, log->fp) != 1 ||
+        fwrite(data, 1, len, log->fp) != len || fflush(log->fp) != 0)
+    {
+        printf("Failed to write checkpoint %u\n", log->count - 1);
+        return false;
+    }
+    return true;
+}
+
+uint64_t rollbackCheckpoint(const CheckpointLog *log, VM *vm)
+{
+    for (uint32_t bits = vm->dirty; bits; bits &= bits - 1)
+    {
+        int line = __builtin_ctz(bits);
+        memcpy(&vm->memory[line * DIRTY_LINE_SIZE], &log->base[line * DIRTY_LINE_SIZE], DIRTY_LINE_SIZE);
+    }
+    vm->dirty = 0;
+    vm->cpu = log->cpu;
+    vm->running = log->running;
+    return log->steps;
+}
+
+bool resumeCheckpoint(VM *vm, const char *path, long index, uint64_t *steps, bool verbose)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        if (verbose)
+            printf("Failed to open checkpoint file: %s\n", path);
+        return false;
+    }
+
+    CheckpointFileHeader h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, CHECKPOINT_MAGIC, 4) != 0 ||
+        h.version != CHECKPOINT_VERSION || h.memorySize != MEMORY_SIZE || h.lineSize != DIRTY_LINE_SIZE ||
+        h.cpuStateSize != sizeof(CPUState))
+    {
+        if (verbose)
+            printf("%s: not a checkpoint file for this simulator\n", path);
+        fclose(fp);
+        return false;
+    }
+
+    // 레코드를 순서대로 적용 (레코드에 담긴 라인만 복사)
+    CheckpointRecord r = {0};
+    CPUState cpu = {0};
+    long applied = 0;
+    bool truncated = false;
+    for (; index < 0 || applied <= index; applied++)
+    {
+        CheckpointRecord next;
+        CPUState nextCpu;
+        if (fread(&next, sizeof(next), 1, fp) != 1)
+        {
+            break; // 파일 끝
+        }
+        uint8_t data[MEMORY_SIZE];
+        size_t len = (size_t)__builtin_popcount(next.lines) * DIRTY_LINE_SIZE;
+        if (fread(&nextCpu, sizeof(CPUState), 1, fp) != 1 || fread(data, 1, len, fp) != len ||
+            (applied == 0 && next.lines != DIRTY_ALL))
+        {
+            truncated = true;
+            break;
+        }
+        const uint8_t *src = data;
+        for (uint32_t bits = next.lines; bits; bits &= bits - 1)
+        {
+            memcpy(&vm->memory[__builtin_ctz(bits) * DIRTY_LINE_SIZE], src, DIRTY_LINE_SIZE);
+            src += DIRTY_LINE_SIZE;
+        }
+        r = next;
+        cpu = nextCpu;
+    }
+    fclose(fp);
+
+    if (applied == 0 || (index >= 0 && applied <= index))
+    {
+        if (verbose)
+            printf("%s: checkpoint %ld not found (%ld available)\n", path, index < 0 ? 0 : index, applied);
+        return false;
+    }
+    if (hashMemory(vm->memory) != r.memHash)
+    {
+        if (verbose)
+            printf("%s: checkpoint %ld memory checksum mismatch\n", path, applied - 1);
+        return false;
+    }
+    if (truncated && verbose)
+    {
+        printf("%s: last checkpoint is incomplete, using checkpoint %ld\n", path, applied - 1);
+    }
+
+    vm->cpu = cpu;
+    vm->running = r.running;
+    vm->dirty = 0;
+    *steps = r.steps;
+    if (verbose)
+        printf("Resumed from %s: checkpoint %ld, %llu steps. PC=%u\n", path, applied - 1,
+               (unsigned long long)r.steps, vm->cpu.PC);
+    return true;
+}
+
+bool resumeCheckpointSpec(VM *vm, const char *spec, uint64_t *steps)
+{
+    char path[1024];
+    long index = -1;
+    const char *at = strrchr(spec, '@');
+    size_t len = at ? (size_t)(at - spec) : strlen(spec);
+    if (len >= sizeof(path))
+    {
+        printf("Checkpoint path too long: %s\n", spec);
+        return false;
+    }
+    memcpy(path, spec, len);
+    path[len] = '\0';
+    if (at)
+    {
+        char *end;
+        index = strtol(at + 1, &end, 0);
+        if (*end != '\0' || index < 0)
+        {
+            printf("Bad checkpoint index: %s\n", at + 1);
+            return false;
+        }
+    }
+    return resumeCheckpoint(vm, path, index, steps, true);
+}
@@ -0,0 +1,69 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/**
+ * 증분 체크포인트
+ * 첫 체크포인트는 메모리 전체, 그 다음부터는 MOV_RM이 표시한 dirty 라인 중
+ * 실제로 값이 바뀐 라인과 CPUState만 기록한다.
+ *
+ * 파일 형식 (리틀 엔디언, 레코드를 뒤에 계속 붙임)
+ *   헤더 12바이트: "VMCK", 버전, 메모리 크기, 라인 크기, sizeof(CPUState)
+ *   레코드: {steps, 라인 비트맵, 메모리 해시, running} 24바이트 + CPUState + 바뀐 라인들 (주소 순)
+ * CPUState 크기가 다르면 (singleCycle <-> multiCycle) 읽지 않음
+ */
+
+#define CHECKPOINT_MAGIC "VMCK"
+#define CHECKPOINT_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t memorySize;
+    uint16_t lineSize;
+    uint16_t cpuStateSize;
+} CheckpointFileHeader;
+
+typedef struct {
+    uint64_t steps;   // 이 시점까지 실행한 명령어(multiCycle은 클록) 수
+    uint32_t lines;   // 뒤따르는 라인 비트맵
+    uint32_t memHash; // 적용 후 메모리 전체의 FNV-1a
+    uint8_t running;
+    uint8_t reserved[7];
+} CheckpointRecord;
+
+// 체크포인트 기록기 (마지막 체크포인트 시점의 상태를 같이 들고 있음)
+typedef struct {
+    FILE *fp;                  // NULL이면 메모리에만 유지
+    uint8_t base[MEMORY_SIZE]; // 마지막 체크포인트 시점의 메모리
+    CPUState cpu;
+    bool running;
+    uint64_t steps;
+    uint32_t count;            // 저장한 체크포인트 수
+    uint64_t linesWritten;     // 기록한 라인 수 합
+} CheckpointLog;
+
+// path가 NULL이면 파일 없이 메모리에만 (되돌리기용), 파일을 못 만들면 false
+bool openCheckpointLog(CheckpointLog *log, const char *path);
+
+void closeCheckpointLog(CheckpointLog *log);
+
+// 현재 상태를 체크포인트로 저장하고 vm->dirty를 비움 (페이지 메모리를 쓴 VM이면 false)
+bool saveCheckpoint(CheckpointLog *log, VM *vm, uint64_t steps);
+
+// 마지막 체크포인트 상태로 되돌림 (그 뒤에 dirty가 된 라인만 복사), 그 시점의 steps 반환
+uint64_t rollbackCheckpoint(const CheckpointLog *log, VM *vm);
+
+/**
+ * 체크포인트 파일에서 index번째(0부터, 음수면 마지막) 상태를 VM에 복원
+ * 레코드마다 담긴 라인만 복사하므로 바뀐 바이트 수에 비례
+ * 마지막 레코드가 잘려 있으면 (기록 중 종료) 그 앞까지 사용
+ */
+bool resumeCheckpoint(VM *vm, const char *path, long index, uint64_t *steps, bool verbose);
+
+// -R 옵션: "path" 또는 "path@index" (결과를 출력)
+bool resumeCheckpointSpec(VM *vm, const char *spec, uint64_t *steps);
+
+#endif
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 #include "cpu.h"
+#include "paged.h"
+#include "loopdetect.h"
 
 /**
  * VM 초기화
@@ -22,6 +24,7 @@ Instruction decodeInstruction(VM *vm)
 {
     Instruction instr;
     memset(&instr, 0, sizeof(instr));
+    PERF_INC(vm, fetches);
 
     // opcode|operand 순으로 되어있어서, 처음 한 바이트를 opcode로 인식
     uint8_t opcodeByte = vm->memory[vm->cpu.PC];
@@ -41,26 +44,38 @@ Instruction decodeInstruction(VM *vm)
     case ADD_RR:
     case SUB_RR:
         instr.opType = OPERAND_REG_REG;
-        instr.regA = vm->memory[vm->cpu.PC + 1];
-        instr.regB = vm->memory[vm->cpu.PC + 2];
+        instr.regA = vm->memory[vm->cpu.PC + 1] & (NUM_REGS - 1);
+        instr.regB = vm->memory[vm->cpu.PC + 2] & (NUM_REGS - 1);
         break;
     // 레지스터에 있는 값을 imm에 저장된 메모리 주소로 이동
     case MOV_RM:
         instr.opType = OPERAND_REG_MEM;
-        instr.regA = vm->memory[vm->cpu.PC + 1];
+        instr.regA = vm->memory[vm->cpu.PC + 1] & (NUM_REGS - 1);
         instr.imm = vm->memory[vm->cpu.PC + 2];
         break;
     // imm 메모리 주소에 있는 갑을 레지스터로 이동
     case MOV_MR:
         instr.opType = OPERAND_MEM_REG;
         instr.imm = vm->memory[vm->cpu.PC + 1];
-        instr.regB = vm->memory[vm->cpu.PC + 2];
+        instr.regB = vm->memory[vm->cpu.PC + 2] & (NUM_REGS - 1);
         break;
     // 점프할 imm 값을 가져옴
     case JMP:
         instr.opType = OPERAND_IMM;
         instr.imm = vm->memory[vm->cpu.PC + 1];
         break;
+    // MOV_RF reg, addr32 : 레지스터 값을 넓은 주소로
+    case MOV_RF:
+        instr.opType = OPERAND_REG_MEM;
+        instr.regA = wideRegister(vm, vm->cpu.PC);
+        instr.imm = wideOperand(vm, vm->cpu.PC + WIDE_ADDR_OFFSET(MOV_RF));
+        break;
+    // MOV_FR addr32, reg : 넓은 주소의 값을 레지스터로
+    case MOV_FR:
+        instr.opType = OPERAND_MEM_REG;
+        instr.imm = wideOperand(vm, vm->cpu.PC + WIDE_ADDR_OFFSET(MOV_FR));
+        instr.regB = wideRegister(vm, vm->cpu.PC);
+        break;
     default:
         // 알 수 없는 opcode
         instr.opcode = INVALID;
@@ -91,6 +106,9 @@ uint16_t getInstructionSize(const Instruction *instr)
         return 3;
     case JMP:
         return 2;
+    case MOV_RF:
+    case MOV_FR:
+        return WIDE_INSTR_SIZE;
     // INVALID
     default:
         return 1;
@@ -100,6 +118,8 @@ uint16_t getInstructionSize(const Instruction *instr)
 // 실제 명령어를 실행하는 함수
 void executeInstruction(VM *vm, const Instruction *instr)
 {
+    PERF_INC(vm, opcodes[instr->opcode < INVALID ? instr->opcode : INVALID]);
+
     switch (instr->opcode)
     {
     // 프로그램 종료
@@ -116,7 +136,9 @@ void executeInstruction(VM *vm, const Instruction *instr)
     // 레지스터 간 값 이동 regA <- regB
     case MOV_RR:
     {
+        uint8_t old = vm->cpu.regs[instr->regA];
         vm->cpu.regs[instr->regA] = vm->cpu.regs[instr->regB];
+        loopNoteWrite(vm, instr->regA, old, vm->cpu.regs[instr->regA]);
         break;
     }
     // 레지스터에 있는 값을 메모리 주소로 이동 imm <- regA
@@ -124,7 +146,10 @@ void executeInstruction(VM *vm, const Instruction *instr)
     {
         if (instr->imm < MEMORY_SIZE)
         {
+            PERF_INC(vm, memWrites);
+            loopNoteWrite(vm, NUM_REGS + instr->imm, vm->memory[instr->imm], vm->cpu.regs[instr->regA]);
             vm->memory[instr->imm] = vm->cpu.regs[instr->regA];
+            MARK_DIRTY(vm, instr->imm);
         }
         else
         {
@@ -139,6 +164,8 @@ void executeInstruction(VM *vm, const Instruction *instr)
     {
         if (instr->imm < MEMORY_SIZE)
         {
+            PERF_INC(vm, memReads);
+            loopNoteWrite(vm, instr->regB, vm->cpu.regs[instr->regB], vm->memory[instr->imm]);
             vm->cpu.regs[instr->regB] = vm->memory[instr->imm];
         }
         else
@@ -155,6 +182,7 @@ void executeInstruction(VM *vm, const Instruction *instr)
         uint16_t result = (uint16_t)vm->cpu.regs[instr->regA] +
                           (uint16_t)vm->cpu.regs[instr->regB];
         // 오버플로우 된거 마스킹 0000 0000 1111 1111
+        loopNoteWrite(vm, instr->regA, vm->cpu.regs[instr->regA], (uint8_t)(result & 0xFF));
         vm->cpu.regs[instr->regA] = (uint8_t)(result & 0xFF);
         break;
     }
@@ -163,10 +191,46 @@ void executeInstruction(VM *vm, const Instruction *instr)
     {
         uint16_t result = (uint16_t)vm->cpu.regs[instr->regA] -
                           (uint16_t)vm->cpu.regs[instr->regB];
+        loopNoteWrite(vm, instr->regA, vm->cpu.regs[instr->regA], (uint8_t)(result & 0xFF));
         vm->cpu.regs[instr->regA] = (uint8_t)(result & 0xFF);
         break;
     }
 
+    // 넓은 주소 저장/읽기 (MEMORY_SIZE 이상은 페이지 메모리)
+    case MOV_RF:
+    {
+        if (instr->imm < MEMORY_SIZE)
+        {
+            loopNoteWrite(vm, NUM_REGS + instr->imm, vm->memory[instr->imm], vm->cpu.regs[instr->regA]);
+        }
+        if (wideStore(vm, instr->imm, vm->cpu.regs[instr->regA]))
+        {
+            PERF_INC(vm, memWrites);
+        }
+        else
+        {
+            wideAccessError(vm, MOV_RF, instr->imm, vm->cpu.PC);
+            vm->running = false;
+        }
+        break;
+    }
+
+    case MOV_FR:
+    {
+        uint8_t old = vm->cpu.regs[instr->regB];
+        if (wideLoad(vm, instr->imm, &vm->cpu.regs[instr->regB]))
+        {
+            PERF_INC(vm, memReads);
+            loopNoteWrite(vm, instr->regB, old, vm->cpu.regs[instr->regB]);
+        }
+        else
+        {
+            wideAccessError(vm, MOV_FR, instr->imm, vm->cpu.PC);
+            vm->running = false;
+        }
+        break;
+    }
+
     // PC 값을 imm으로 변경
     case JMP:
     {
@@ -204,12 +268,13 @@ void singleCycle(VM *vm)
     executeInstruction(vm, &instr);
 }
 
-// VM 실행 루프
-// running = true인동안 실행
-void runVM(VM *vm)
+// VM 실행 루프 (명령어 수 제한)
+// maxSteps = 0 이면 제한 없음, 실행한 명령어 수를 반환
+uint64_t runVMFor(VM *vm, uint64_t maxSteps)
 {
+    uint64_t steps = 0;
     vm->running = true;
-    while (vm->running)
+    while (vm->running && (maxSteps == 0 || steps < maxSteps))
     {
         if (vm->cpu.PC >= MEMORY_SIZE)
         {
@@ -217,7 +282,26 @@ void runVM(VM *vm)
             vm->running = false;
             break;
         }
+        uint16_t pc = vm->cpu.PC;
         singleCycle(vm);
+        steps++;
+        // PC가 앞으로 가지 않았으면 뒤로 가는 (또는 제자리) JMP
+        if (vm->loop && vm->running && vm->cpu.PC <= pc)
+        {
+            checkLoop(vm, steps);
+        }
     }
+    if (vm->loop)
+    {
+        vm->loop->stepBase += steps;
+    }
+    return steps;
+}
+
+// VM 실행 루프
+// running = true인동안 실행
+void runVM(VM *vm)
+{
+    runVMFor(vm, 0);
     printf("VM stopped.\n");
 }
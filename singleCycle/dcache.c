@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <string.h>
+#include "dcache.h"
+#include "fuse.h"
+#include "paged.h"
+
+/**
+ * 디코드 캐시 (decode-once)
+ * 매 스텝마다 decodeInstruction() + getInstructionSize()를 다시 하는 대신
+ * PC별로 한 번만 디코딩해서 저장해 두고 재사용한다.
+ * MOV_RM이 이미 디코딩된 코드 바이트에 쓸 때만 해당 슬롯을 무효화.
+ */
+
+void initDecodeCache(DecodeCache *dc)
+{
+    for (int pc = 0; pc < DCACHE_SLOTS; pc++)
+    {
+        memset(&dc->code[pc], 0, sizeof(DecodedInstr));
+        // 메모리 밖은 항상 PC 범위 오류
+        dc->code[pc].op = (pc < MEMORY_SIZE) ? DOP_UNDECODED : DOP_PC_FAULT;
+    }
+    memset(dc->codeMap, 0, sizeof(dc->codeMap));
+    memset(dc->nopTarget, 0, sizeof(dc->nopTarget));
+}
+
+const DecodedInstr *decodeIntoCache(DecodeCache *dc, const VM *vm, uint16_t pc)
+{
+    DecodedInstr *d = &dc->code[pc];
+
+    // decodeInstruction()과 같은 해석
+    // 레지스터 번호는 regs 배열 밖을 쓰지 않도록 마스킹
+    memset(d, 0, sizeof(*d));
+    d->op = vm->memory[pc];
+    switch (d->op)
+    {
+    case HALT:
+    case NOP:
+        d->len = 1;
+        break;
+    case MOV_RR:
+    case ADD_RR:
+    case SUB_RR:
+        d->regA = operandByte(vm, pc + 1) & (NUM_REGS - 1);
+        d->regB = operandByte(vm, pc + 2) & (NUM_REGS - 1);
+        d->len = 3;
+        break;
+    case MOV_RM:
+        d->regA = operandByte(vm, pc + 1) & (NUM_REGS - 1);
+        d->imm = operandByte(vm, pc + 2);
+        d->len = 3;
+        break;
+    case MOV_MR:
+        d->imm = operandByte(vm, pc + 1);
+        d->regB = operandByte(vm, pc + 2) & (NUM_REGS - 1);
+        d->len = 3;
+        break;
+    case JMP:
+        d->imm = operandByte(vm, pc + 1);
+        d->len = 2;
+        break;
+    case MOV_RF:
+        d->regA = operandByte(vm, pc + WIDE_REG_OFFSET(MOV_RF)) & (NUM_REGS - 1);
+        d->len = WIDE_INSTR_SIZE;
+        break;
+    case MOV_FR:
+        d->regB = operandByte(vm, pc + WIDE_REG_OFFSET(MOV_FR)) & (NUM_REGS - 1);
+        d->len = WIDE_INSTR_SIZE;
+        break;
+    default:
+        d->op = INVALID;
+        d->len = 1;
+        break;
+    }
+    d->nextPC = pc + d->len;
+
+    // 이 슬롯이 덮는 바이트 표시
+    for (uint16_t a = pc; a < pc + d->len && a < MEMORY_SIZE; a++)
+    {
+        dc->codeMap[a]++;
+    }
+    return d;
+}
+
+void dropSlot(DecodeCache *dc, uint16_t pc)
+{
+    DecodedInstr *d = &dc->code[pc];
+    for (uint16_t a = pc; a < pc + d->len && a < MEMORY_SIZE; a++)
+    {
+        dc->codeMap[a]--;
+    }
+    d->op = DOP_UNDECODED;
+}
+
+void invalidateDecodeCache(DecodeCache *dc, uint16_t addr)
+{
+    // addr를 덮을 수 있는 슬롯은 addr - (MAX_SLOT_SPAN - 1) ~ addr 에서 시작
+    int first = (int)addr - (MAX_SLOT_SPAN - 1);
+    if (first < 0)
+    {
+        first = 0;
+    }
+    for (int pc = first; pc <= (int)addr; pc++)
+    {
+        DecodedInstr *d = &dc->code[pc];
+        if (d->op != DOP_UNDECODED && pc + d->len > (int)addr)
+        {
+            dropSlot(dc, (uint16_t)pc);
+        }
+    }
+
+    // 이 NOP으로 뛰어드는 JMP+NOP 슈퍼명령어도 무효화
+    if (dc->nopTarget[addr])
+    {
+        dc->nopTarget[addr] = 0;
+        for (int pc = 0; pc < MEMORY_SIZE; pc++)
+        {
+            if (dc->code[pc].op == DOP_FUSED_BASE + FUSE_JMP_NOP && dc->code[pc].imm == addr)
+            {
+                dropSlot(dc, (uint16_t)pc);
+            }
+        }
+    }
+}
+
+// 디코드 캐시 실행 루프 본체, 동작은 runVM()/executeInstruction()과 동일
+// fused = false로 인라인되면 슈퍼명령어 처리가 빠진 루프가 만들어짐
+static inline __attribute__((always_inline)) uint64_t decodedLoop(VM *vm, DecodeCache *dc, uint64_t maxSteps,
+                                                                  FusionStats *stats, bool fused)
+{
+    uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+    uint64_t steps = 0;
+    uint8_t *regs = vm->cpu.regs;
+    uint16_t pc = vm->cpu.PC;
+    DecodedInstr single; // 남은 스텝이 모자라 슈퍼명령어를 쪼갤 때 사용
+
+    vm->running = true;
+    if (pc >= MEMORY_SIZE)
+    {
+        printf("Error: PC out of memory range!\n");
+        vm->running = false;
+        return 0;
+    }
+
+    while (vm->running && steps < limit)
+    {
+        const DecodedInstr *d = &dc->code[pc];
+    dispatch:
+        switch (d->op)
+        {
+        case DOP_UNDECODED:
+            decodeIntoCache(dc, vm, pc);
+            continue; // 스텝으로 치지 않음
+
+        case DOP_PC_FAULT:
+            printf("Error: PC out of memory range!\n");
+            vm->running = false;
+            continue;
+
+        case HALT:
+            vm->running = false;
+            break;
+
+        case NOP:
+            break;
+
+        case MOV_RR:
+            regs[d->regA] = regs[d->regB];
+            break;
+
+        case MOV_RM:
+            vm->memory[d->imm] = regs[d->regA];
+            MARK_DIRTY(vm, d->imm);
+            noteStore(dc, d->imm);
+            break;
+
+        case MOV_MR:
+            regs[d->regB] = vm->memory[d->imm];
+            break;
+
+        case ADD_RR:
+            regs[d->regA] = (uint8_t)(regs[d->regA] + regs[d->regB]);
+            break;
+
+        case SUB_RR:
+            regs[d->regA] = (uint8_t)(regs[d->regA] - regs[d->regB]);
+            break;
+
+        case JMP:
+            pc = d->imm;
+            steps++;
+            continue;
+
+        // 넓은 주소는 드물어서 공용 경로로 (주소는 슬롯이 덮고 있는 명령어 바이트에서)
+        case MOV_RF:
+        {
+            uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF));
+            if (!wideStore(vm, addr, regs[d->regA]))
+            {
+                wideAccessError(vm, MOV_RF, addr, pc);
+                vm->running = false;
+            }
+            else if (addr < MEMORY_SIZE)
+            {
+                noteStore(dc, (uint8_t)addr);
+            }
+            break;
+        }
+
+        case MOV_FR:
+        {
+            uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_FR));
+            if (!wideLoad(vm, addr, &regs[d->regB]))
+            {
+                wideAccessError(vm, MOV_FR, addr, pc);
+                vm->running = false;
+            }
+            break;
+        }
+
+        // 슈퍼명령어: 뒤따르는 명령어는 pc + 3, pc + 6 슬롯에서 읽음
+        case DOP_FUSED_BASE + FUSE_MR_ADD_RM:
+        case DOP_FUSED_BASE + FUSE_MR_SUB_RM:
+        {
+            if (!fused)
+            {
+                goto invalid;
+            }
+            if (limit - steps < 3)
+            {
+                goto split;
+            }
+            const DecodedInstr *alu = &dc->code[pc + 3];
+            const DecodedInstr *st = &dc->code[pc + 6];
+            regs[d->regB] = vm->memory[d->imm];
+            if (d->op == DOP_FUSED_BASE + FUSE_MR_ADD_RM)
+            {
+                regs[alu->regA] = (uint8_t)(regs[alu->regA] + regs[alu->regB]);
+            }
+            else
+            {
+                regs[alu->regA] = (uint8_t)(regs[alu->regA] - regs[alu->regB]);
+            }
+            vm->memory[st->imm] = regs[st->regA];
+            MARK_DIRTY(vm, st->imm);
+            if (stats)
+            {
+                stats->fired[d->op - DOP_FUSED_BASE]++;
+                stats->dispatchSaved += 2;
+            }
+            pc = d->nextPC;
+            steps += 3;
+            noteStore(dc, st->imm);
+            continue;
+        }
+
+        case DOP_FUSED_BASE + FUSE_MR_ADD:
+        case DOP_FUSED_BASE + FUSE_MR_SUB:
+        {
+            if (!fused)
+            {
+                goto invalid;
+            }
+            if (limit - steps < 2)
+            {
+                goto split;
+            }
+            const DecodedInstr *alu = &dc->code[pc + 3];
+            regs[d->regB] = vm->memory[d->imm];
+            if (d->op == DOP_FUSED_BASE + FUSE_MR_ADD)
+            {
+                regs[alu->regA] = (uint8_t)(regs[alu->regA] + regs[alu->regB]);
+            }
+            else
+            {
+                regs[alu->regA] = (uint8_t)(regs[alu->regA] - regs[alu->regB]);
+            }
+            if (stats)
+            {
+                stats->fired[d->op - DOP_FUSED_BASE]++;
+                stats->dispatchSaved++;
+            }
+            pc = d->nextPC;
+            steps += 2;
+            continue;
+        }
+
+        case DOP_FUSED_BASE + FUSE_ADD_RM:
+        case DOP_FUSED_BASE + FUSE_SUB_RM:
+        {
+            if (!fused)
+            {
+                goto invalid;
+            }
+            if (limit - steps < 2)
+            {
+                goto split;
+            }
+            const DecodedInstr *st = &dc->code[pc + 3];
+            if (d->op == DOP_FUSED_BASE + FUSE_ADD_RM)
+            {
+                regs[d->regA] = (uint8_t)(regs[d->regA] + regs[d->regB]);
+            }
+            else
+            {
+                regs[d->regA] = (uint8_t)(regs[d->regA] - regs[d->regB]);
+            }
+            vm->memory[st->imm] = regs[st->regA];
+            MARK_DIRTY(vm, st->imm);
+            if (stats)
+            {
+                stats->fired[d->op - DOP_FUSED_BASE]++;
+                stats->dispatchSaved++;
+            }
+            pc = d->nextPC;
+            steps += 2;
+            noteStore(dc, st->imm);
+            continue;
+        }
+
+        // JMP 대상의 NOP까지 실행 (nextPC = 대상 + 1)
+        case DOP_FUSED_BASE + FUSE_JMP_NOP:
+            if (!fused)
+            {
+                goto invalid;
+            }
+            if (limit - steps < 2)
+            {
+                goto split;
+            }
+            if (stats)
+            {
+                stats->fired[FUSE_JMP_NOP]++;
+                stats->dispatchSaved++;
+            }
+            pc = d->nextPC;
+            steps += 2;
+            continue;
+
+        split:
+            // 슈퍼명령어의 첫 명령어만 실행
+            single = *d;
+            single.op = d->first;
+            single.nextPC = pc + FUSED_INSTR_SPAN; // JMP는 nextPC를 쓰지 않음
+            d = &single;
+            goto dispatch;
+
+        case INVALID:
+        default:
+        invalid:
+            printf("Error: Invalid opcode (0x%X) at PC=%u\n", INVALID, pc);
+            vm->running = false;
+            break;
+        }
+        pc = d->nextPC;
+        steps++;
+    }
+
+    vm->cpu.PC = pc;
+    return steps;
+}
+
+uint64_t runDecodedLoop(VM *vm, DecodeCache *dc, uint64_t maxSteps, FusionStats *stats)
+{
+    return decodedLoop(vm, dc, maxSteps, stats, true);
+}
+
+uint64_t runVMDecoded(VM *vm, uint64_t maxSteps)
+{
+    DecodeCache dc;
+    initDecodeCache(&dc);
+    return decodedLoop(vm, &dc, maxSteps, NULL, false);
+}
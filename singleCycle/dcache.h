@@ -0,0 +1,79 @@
+#ifndef DCACHE_H
+#define DCACHE_H
+
+#include "cpu.h"
+
+// 미리 디코딩된 명령어의 핸들러 번호 (HALT ~ INVALID 는 Opcode 값 그대로 사용)
+#define DOP_UNDECODED 0xFE // 아직 디코딩 안 된 슬롯 (처음 실행될 때 디코딩)
+#define DOP_PC_FAULT  0xFF // 메모리 범위를 벗어난 PC
+// 슈퍼명령어 (DOP_FUSED_BASE + FusionKind, fuse.h 참고)
+#define DOP_FUSED_BASE 0x10
+
+// 한 명령어가 차지할 수 있는 최대 바이트 수 (MOV_RF/MOV_FR)
+#define MAX_INSTR_SPAN WIDE_INSTR_SIZE
+// 슈퍼명령어로 합치는 명령어의 바이트 수 (MOV_MR/ALU/MOV_RM)
+#define FUSED_INSTR_SPAN 3
+// 슬롯 하나가 덮을 수 있는 최대 바이트 수 (슈퍼명령어는 명령어 3개)
+#define MAX_SLOT_SPAN (3 * FUSED_INSTR_SPAN)
+
+// 메모리 끝에서 명령어가 넘어갈 수 있는 최대 PC (255 + 6)
+#define DCACHE_SLOTS (MEMORY_SIZE + MAX_INSTR_SPAN)
+
+// 미리 디코딩된 명령어 (8바이트, 캐시 라인 하나에 8개)
+typedef struct {
+    uint8_t  op;     // Opcode 또는 DOP_*
+    uint8_t  regA;
+    uint8_t  regB;
+    uint8_t  imm;    // MOV_RF/MOV_FR의 32비트 주소는 실행할 때 명령어 바이트에서 읽음
+    uint16_t nextPC; // PC + 명령어 크기 (미리 계산)
+    uint8_t  len;    // 명령어가 덮고 있는 바이트 수
+    uint8_t  first;  // 슈퍼명령어일 때 첫 명령어의 Opcode
+} DecodedInstr;
+
+// PC(바이트 주소)마다 슬롯 하나씩 두는 디코드 캐시
+// JMP가 아무 바이트로나 뛸 수 있으므로 주소 단위로 둔다
+typedef struct {
+    DecodedInstr code[DCACHE_SLOTS] __attribute__((aligned(64)));
+    // codeMap[addr] = addr 바이트를 덮고 있는 디코딩된 슬롯 수
+    // MOV_RM이 0이 아닌 곳에 쓸 때만 무효화를 수행
+    uint8_t codeMap[MEMORY_SIZE];
+    // JMP+NOP 슈퍼명령어가 건너뛰는 NOP 위치 (떨어진 바이트라 따로 표시)
+    uint8_t nopTarget[MEMORY_SIZE];
+} DecodeCache;
+
+// 모든 슬롯을 미디코딩 상태로 초기화
+void initDecodeCache(DecodeCache *dc);
+
+// pc 위치의 명령어를 디코딩해서 슬롯에 채움
+const DecodedInstr *decodeIntoCache(DecodeCache *dc, const VM *vm, uint16_t pc);
+
+// addr 바이트가 바뀌었을 때 그 바이트를 덮는 슬롯들을 무효화
+void invalidateDecodeCache(DecodeCache *dc, uint16_t addr);
+
+// MOV_RM 저장 후 호출 (코드 바이트일 때만 무효화)
+static inline void noteStore(DecodeCache *dc, uint8_t addr)
+{
+    if (dc->codeMap[addr])
+    {
+        invalidateDecodeCache(dc, addr);
+    }
+}
+
+// 슬롯 하나를 미디코딩 상태로 되돌림
+void dropSlot(DecodeCache *dc, uint16_t pc);
+
+/**
+ * 디코드 캐시를 사용하는 실행 루프
+ * maxSteps = 0 이면 제한 없음, 실행한 명령어 수를 반환
+ */
+uint64_t runVMDecoded(VM *vm, uint64_t maxSteps);
+
+struct FusionStatsTag;
+
+/**
+ * 이미 준비된 디코드 캐시로 실행 (슈퍼명령어 슬롯 포함)
+ * stats가 NULL이 아니면 슈퍼명령어 실행 횟수를 기록
+ */
+uint64_t runDecodedLoop(VM *vm, DecodeCache *dc, uint64_t maxSteps, struct FusionStatsTag *stats);
+
+#endif
@@ -0,0 +1,698 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "debug.h"
+#include "paged.h"
+
+// 명령어 하나가 덮어쓰는 곳 (명령어마다 최대 한 곳 + PC)
+enum {
+    WRITE_NONE,
+    WRITE_REG,
+    WRITE_MEM,
+    WRITE_PAGED // MEMORY_SIZE 이상 주소 (저널에 담을 수 없어 실행하기 전에 멈춤)
+};
+
+// 저널 기록 하나 (6바이트, 명령어 하나에 하나)
+typedef struct {
+    uint16_t pc;   // 실행 전 PC
+    uint8_t kind;  // WRITE_*
+    uint8_t index; // 레지스터 번호 또는 메모리 주소
+    uint8_t old;   // 덮어쓰기 전 값
+    uint8_t value; // 쓴 값 ("누가 썼나" 질의용)
+} JournalEntry;
+
+typedef struct {
+    uint64_t step; // 이 스냅샷을 찍은 스텝 (UINT64_MAX = 빈 슬롯)
+    CPUState cpu;
+    uint8_t memory[MEMORY_SIZE];
+} Snapshot;
+
+typedef struct {
+    VM *vm;
+    uint64_t step;         // 지금까지 실행한 명령어 수 (= 현재 위치)
+    uint64_t journalStart; // 저널로 되돌릴 수 있는 가장 오래된 스텝
+    uint64_t maxSteps;     // continue 한 번의 최대 명령어 수 (0 = 제한 없음)
+    JournalEntry journal[JOURNAL_CAPACITY]; // [step % JOURNAL_CAPACITY]
+    Snapshot snapshots[SNAPSHOT_COUNT];     // [(step / SNAPSHOT_INTERVAL) % SNAPSHOT_COUNT]
+} Debugger;
+
+// continue / reverse-continue / who 조건
+typedef enum {
+    FIND_NONE,  // 조건 없음 (멈출 때까지)
+    FIND_PC,    // PC == addr 인 지점
+    FIND_WRITE  // memory[addr]에 쓰는 명령어
+} FindKind;
+
+typedef struct {
+    FindKind kind;
+    uint16_t addr;
+} FindCond;
+
+static const char *const opcodeNames[] = {
+    "HALT", "NOP", "MOV_RR", "MOV_RM", "MOV_MR", "ADD_RR", "SUB_RR", "JMP", "MOV_RF", "MOV_FR"};
+
+/*  -------------------------------------
+        엔진마다 다른 부분 (singleCycle)
+    -------------------------------------
+*/
+
+// 이번 명령어가 덮어쓸 곳 (MOV_RM reg, addr / MOV_MR addr, reg)
+static void predictWrite(const VM *vm, JournalEntry *e)
+{
+    uint16_t pc = vm->cpu.PC;
+    e->pc = pc;
+    e->kind = WRITE_NONE;
+    e->index = e->old = e->value = 0;
+    if (pc >= MEMORY_SIZE)
+    {
+        return;
+    }
+
+    // 넓은 주소는 오퍼랜드가 메모리 끝을 넘어도 0으로 읽고 실행함 (cpu.c와 같음)
+    uint8_t op = vm->memory[pc];
+    if (op == MOV_RF)
+    {
+        uint32_t addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(op));
+        // 주소 공간 밖이면 아무것도 쓰지 않고 엔진이 오류로 멈춤
+        e->kind = (addr < MEMORY_SIZE) ? WRITE_MEM : (addr > wideAddressLimit(vm)) ? WRITE_NONE : WRITE_PAGED;
+        e->index = (uint8_t)addr;
+        return;
+    }
+    if (op == MOV_FR)
+    {
+        e->index = wideRegister(vm, pc);
+        e->kind = WRITE_REG;
+        return;
+    }
+    if (pc + 2 >= MEMORY_SIZE)
+    {
+        return; // 메모리 끝에 걸친 명령어는 쓰기 전에 멈춤
+    }
+
+    uint8_t op1 = vm->memory[pc + 1];
+    uint8_t op2 = vm->memory[pc + 2];
+    switch (vm->memory[pc])
+    {
+    case MOV_RR:
+    case ADD_RR:
+    case SUB_RR:
+        e->kind = WRITE_REG;
+        e->index = op1;
+        break;
+    case MOV_MR:
+        e->kind = WRITE_REG;
+        e->index = op2;
+        break;
+    case MOV_RM:
+        e->kind = WRITE_MEM;
+        e->index = op2;
+        break;
+    default:
+        break;
+    }
+    if (e->kind == WRITE_REG)
+    {
+        e->index &= NUM_REGS - 1; // 엔진과 같이 레지스터 번호 마스킹
+    }
+}
+
+// 명령어 하나 실행 (runVMFor와 같은 PC 검사)
+static void executeOne(VM *vm)
+{
+    if (vm->cpu.PC >= MEMORY_SIZE)
+    {
+        printf("Error: PC out of memory range!\n");
+        vm->running = false;
+        return;
+    }
+    singleCycle(vm);
+}
+
+// 되돌린 뒤 명령어 경계의 내부 상태 정리 (singleCycle은 없음)
+static void resetMicroState(VM *vm)
+{
+    (void)vm;
+}
+
+/*  -------------------------------------
+        저널, 스냅샷
+    -------------------------------------
+*/
+
+// 덮어쓸 곳의 이전 값을 기록하고 실행
+static void executeTracked(VM *vm, JournalEntry *e)
+{
+    predictWrite(vm, e);
+    if (e->kind == WRITE_REG)
+    {
+        e->old = vm->cpu.regs[e->index];
+    }
+    else if (e->kind == WRITE_MEM)
+    {
+        e->old = vm->memory[e->index];
+    }
+
+    executeOne(vm);
+
+    if (e->kind == WRITE_REG)
+    {
+        e->value = vm->cpu.regs[e->index];
+    }
+    else if (e->kind == WRITE_MEM)
+    {
+        e->value = vm->memory[e->index];
+    }
+}
+
+// 되돌릴 수 없는 명령어 (페이지 메모리에 쓰기)면 실행하지 않고 멈춤
+static bool refuseUntracked(VM *vm)
+{
+    JournalEntry e;
+    predictWrite(vm, &e);
+    if (e.kind != WRITE_PAGED)
+    {
+        return false;
+    }
+    printf("PC=%u: stores above address %d cannot be undone, stopping before it\n", vm->cpu.PC,
+           MEMORY_SIZE - 1);
+    vm->running = false;
+    return true;
+}
+
+// 한 명령어 실행 (스냅샷 간격이면 먼저 스냅샷), 실행하지 못하면 NULL
+static const JournalEntry *stepForward(Debugger *d)
+{
+    VM *vm = d->vm;
+    if (refuseUntracked(vm))
+    {
+        return NULL;
+    }
+    if (d->step % SNAPSHOT_INTERVAL == 0)
+    {
+        Snapshot *s = &d->snapshots[(d->step / SNAPSHOT_INTERVAL) % SNAPSHOT_COUNT];
+        // 다시 실행하는 중이면 같은 스냅샷이 이미 있음 (실행은 결정적)
+        if (s->step != d->step)
+        {
+            s->step = d->step;
+            s->cpu = vm->cpu;
+            memcpy(s->memory, vm->memory, MEMORY_SIZE);
+        }
+    }
+
+    JournalEntry *e = &d->journal[d->step % JOURNAL_CAPACITY];
+    executeTracked(vm, e);
+    d->step++;
+    if (d->step - d->journalStart > JOURNAL_CAPACITY)
+    {
+        d->journalStart = d->step - JOURNAL_CAPACITY;
+    }
+    return e;
+}
+
+static void undoOne(Debugger *d)
+{
+    VM *vm = d->vm;
+    d->step--;
+    const JournalEntry *e = &d->journal[d->step % JOURNAL_CAPACITY];
+    if (e->kind == WRITE_REG)
+    {
+        vm->cpu.regs[e->index] = e->old;
+    }
+    else if (e->kind == WRITE_MEM)
+    {
+        vm->memory[e->index] = e->old;
+        MARK_DIRTY(vm, e->index);
+    }
+    vm->cpu.PC = e->pc;
+    vm->running = true;
+    resetMicroState(vm);
+}
+
+// step 이하에서 가장 가까운 스냅샷 (링에서 밀려났으면 NULL)
+static const Snapshot *findSnapshot(const Debugger *d, uint64_t step)
+{
+    uint64_t k = step / SNAPSHOT_INTERVAL;
+    const Snapshot *s = &d->snapshots[k % SNAPSHOT_COUNT];
+    return (s->step == k * SNAPSHOT_INTERVAL) ? s : NULL;
+}
+
+static void loadSnapshot(VM *vm, const Snapshot *s)
+{
+    vm->cpu = s->cpu;
+    memcpy(vm->memory, s->memory, MEMORY_SIZE);
+    vm->running = true;
+    vm->dirty = DIRTY_ALL;
+}
+
+// target 스텝으로 이동 (저널 안이면 되돌리기, 더 오래되면 스냅샷에서 다시 실행)
+static bool gotoStep(Debugger *d, uint64_t target)
+{
+    if (target < d->journalStart)
+    {
+        const Snapshot *s = findSnapshot(d, target);
+        if (!s)
+        {
+            printf("step %llu is older than the oldest snapshot\n", (unsigned long long)target);
+            return false;
+        }
+        loadSnapshot(d->vm, s);
+        d->step = d->journalStart = s->step;
+    }
+    while (d->step > target)
+    {
+        undoOne(d);
+    }
+    while (d->step < target)
+    {
+        if (!d->vm->running)
+        {
+            printf("VM stops at step %llu\n", (unsigned long long)d->step);
+            return false;
+        }
+        stepForward(d);
+    }
+    return true;
+}
+
+static bool matches(const FindCond *c, const JournalEntry *e)
+{
+    switch (c->kind)
+    {
+    case FIND_PC:
+        return e->pc == c->addr;
+    case FIND_WRITE:
+        return e->kind == WRITE_MEM && e->index == c->addr;
+    default:
+        return false;
+    }
+}
+
+/**
+ * 현재 위치보다 앞에서 조건에 맞는 마지막 스텝 찾기 (VM과 저널은 그대로)
+ * 저널을 뒤에서부터 훑고, 저널보다 오래된 구간은 스냅샷을 임시 VM에 올려 다시 실행
+ */
+static bool findBackward(const Debugger *d, const FindCond *c, uint64_t *found, JournalEntry *hit)
+{
+    for (uint64_t s = d->step; s-- > d->journalStart;)
+    {
+        const JournalEntry *e = &d->journal[s % JOURNAL_CAPACITY];
+        if (matches(c, e))
+        {
+            *found = s;
+            *hit = *e;
+            return true;
+        }
+    }
+
+    uint64_t horizon = d->journalStart;
+    while (horizon > 0)
+    {
+        const Snapshot *snap = findSnapshot(d, horizon - 1);
+        if (!snap)
+        {
+            return false;
+        }
+        VM scratch = *d->vm;
+        loadSnapshot(&scratch, snap);
+        bool ok = false;
+        for (uint64_t s = snap->step; s < horizon; s++)
+        {
+            JournalEntry e;
+            executeTracked(&scratch, &e);
+            if (matches(c, &e))
+            {
+                *found = s;
+                *hit = e;
+                ok = true;
+            }
+        }
+        if (ok)
+        {
+            return true;
+        }
+        horizon = snap->step;
+    }
+    return false;
+}
+
+// 되돌릴 수 있는 가장 오래된 스텝
+static uint64_t oldestStep(const Debugger *d)
+{
+    uint64_t oldest = d->journalStart;
+    while (oldest > 0)
+    {
+        const Snapshot *s = findSnapshot(d, oldest - 1);
+        if (!s)
+        {
+            break;
+        }
+        oldest = s->step;
+    }
+    return oldest;
+}
+
+/*  -------------------------------------
+        출력
+    -------------------------------------
+*/
+
+static void printInstruction(const VM *vm, uint16_t pc)
+{
+    if (pc >= MEMORY_SIZE)
+    {
+        printf("(PC out of memory)");
+        return;
+    }
+    uint8_t op = vm->memory[pc];
+    if (op >= INVALID)
+    {
+        printf("INVALID (0x%X)", op);
+        return;
+    }
+    Instruction instr = {.opcode = (Opcode)op};
+    uint16_t size = getInstructionSize(&instr);
+    printf("%s", opcodeNames[op]);
+    for (uint16_t i = 1; i < size && pc + i < MEMORY_SIZE; i++)
+    {
+        // 넓은 주소는 4바이트를 한 값으로
+        if ((op == MOV_RF || op == MOV_FR) && i == WIDE_ADDR_OFFSET(op))
+        {
+            printf(" 0x%X", wideOperand(vm, pc + i));
+            i += 3;
+            continue;
+        }
+        printf(" %u", vm->memory[pc + i]);
+    }
+}
+
+static void printLocation(const Debugger *d)
+{
+    const VM *vm = d->vm;
+    printf("step %llu  PC=%u  ", (unsigned long long)d->step, vm->cpu.PC);
+    printInstruction(vm, vm->cpu.PC);
+    printf("%s\n", vm->running ? "" : "  (stopped)");
+}
+
+static void printWrite(uint64_t step, const JournalEntry *e)
+{
+    printf("memory[%u]: %u -> %u at step %llu by PC=%u\n", e->index, e->old, e->value,
+           (unsigned long long)step, e->pc);
+}
+
+static void printRegisters(const VM *vm)
+{
+    for (int i = 0; i < NUM_REGS; i++)
+    {
+        printf("R%d=%u%s", i, vm->cpu.regs[i], i + 1 < NUM_REGS ? " " : "\n");
+    }
+}
+
+static void printMemory(const VM *vm, unsigned addr, unsigned len)
+{
+    for (unsigned i = 0; i < len && addr + i < MEMORY_SIZE; i++)
+    {
+        if (i % 16 == 0)
+        {
+            printf("%s%3u: ", i ? "\n" : "", addr + i);
+        }
+        printf("%3u ", vm->memory[addr + i]);
+    }
+    printf("\n");
+}
+
+static void printInfo(const Debugger *d)
+{
+    int snapshots = 0;
+    for (int i = 0; i < SNAPSHOT_COUNT; i++)
+    {
+        snapshots += (d->snapshots[i].step != UINT64_MAX);
+    }
+    printf("journal: steps %llu..%llu (%llu of %d entries, %zu bytes each)\n",
+           (unsigned long long)d->journalStart, (unsigned long long)d->step,
+           (unsigned long long)(d->step - d->journalStart), JOURNAL_CAPACITY, sizeof(JournalEntry));
+    printf("snapshots: %d of %d, every %d steps, oldest reachable step %llu\n", snapshots, SNAPSHOT_COUNT,
+           SNAPSHOT_INTERVAL, (unsigned long long)oldestStep(d));
+    printf("memory: %zu bytes\n", sizeof(Debugger));
+}
+
+static void printHelp(void)
+{
+    printf("  s|step [n]                  n개 명령어 실행 (기본 1)\n");
+    printf("  b|back [n]                  n개 명령어 되돌리기 (기본 1)\n");
+    printf("  c|continue [n]              멈출 때까지 (또는 n개) 실행\n");
+    printf("  c pc ADDR | c write ADDR    PC가 ADDR이 되거나 memory[ADDR]에 쓸 때까지 실행\n");
+    printf("  rc pc ADDR | rc write ADDR  거꾸로 실행: PC가 ADDR이던 / memory[ADDR]에 쓰기 직전 지점\n");
+    printf("  who ADDR                    memory[ADDR]를 마지막으로 쓴 명령어\n");
+    printf("  goto STEP                   STEP번째 명령어 실행 전 상태로 이동\n");
+    printf("  regs | mem [ADDR [LEN]] | where | info | q\n");
+}
+
+/*  -------------------------------------
+        명령어 처리
+    -------------------------------------
+*/
+
+static bool parseNumber(const char *s, uint64_t *out)
+{
+    if (!s)
+    {
+        return false;
+    }
+    char *end;
+    *out = strtoull(s, &end, 0);
+    return *end == '\0';
+}
+
+// "pc ADDR" / "write ADDR" / 숫자(명령어 수)
+static bool parseCond(char **save, FindCond *c, uint64_t *count)
+{
+    char *arg = strtok_r(NULL, " \t\r\n", save);
+    c->kind = FIND_NONE;
+    *count = 0;
+    if (!arg)
+    {
+        return true;
+    }
+    uint64_t v;
+    if (strcmp(arg, "pc") == 0 || strcmp(arg, "write") == 0)
+    {
+        c->kind = (arg[0] == 'p') ? FIND_PC : FIND_WRITE;
+        if (!parseNumber(strtok_r(NULL, " \t\r\n", save), &v) || v >= MEMORY_SIZE)
+        {
+            printf("expected an address below %d\n", MEMORY_SIZE);
+            return false;
+        }
+        c->addr = (uint16_t)v;
+        return true;
+    }
+    if (!parseNumber(arg, count))
+    {
+        printf("expected a count, 'pc ADDR' or 'write ADDR'\n");
+        return false;
+    }
+    return true;
+}
+
+static void continueForward(Debugger *d, const FindCond *c, uint64_t limit)
+{
+    VM *vm = d->vm;
+    if (!vm->running)
+    {
+        printf("VM is stopped (use back / rc)\n");
+        return;
+    }
+    for (uint64_t n = 0; vm->running && (limit == 0 || n < limit); n++)
+    {
+        uint64_t step = d->step;
+        const JournalEntry *e = stepForward(d);
+        if (!e)
+        {
+            break;
+        }
+        if (c->kind == FIND_WRITE && matches(c, e))
+        {
+            printWrite(step, e);
+            break;
+        }
+        if (c->kind == FIND_PC && vm->running && vm->cpu.PC == c->addr)
+        {
+            break;
+        }
+    }
+    printLocation(d);
+}
+
+static void reverseContinue(Debugger *d, const FindCond *c)
+{
+    if (c->kind == FIND_NONE)
+    {
+        printf("usage: rc pc ADDR | rc write ADDR\n");
+        return;
+    }
+    uint64_t found;
+    JournalEntry hit;
+    if (!findBackward(d, c, &found, &hit))
+    {
+        printf("not found since step %llu\n", (unsigned long long)oldestStep(d));
+        return;
+    }
+    if (gotoStep(d, found) && c->kind == FIND_WRITE)
+    {
+        printWrite(found, &hit);
+    }
+    printLocation(d);
+}
+
+static void whoWrote(Debugger *d, char **save)
+{
+    uint64_t addr;
+    if (!parseNumber(strtok_r(NULL, " \t\r\n", save), &addr) || addr >= MEMORY_SIZE)
+    {
+        printf("usage: who ADDR\n");
+        return;
+    }
+    FindCond c = {.kind = FIND_WRITE, .addr = (uint16_t)addr};
+    uint64_t found;
+    JournalEntry hit;
+    if (findBackward(d, &c, &found, &hit))
+    {
+        printWrite(found, &hit);
+    }
+    else
+    {
+        printf("memory[%llu] = %u, not written since step %llu\n", (unsigned long long)addr,
+               d->vm->memory[addr], (unsigned long long)oldestStep(d));
+    }
+}
+
+int runDebugger(VM *vm, uint64_t maxSteps)
+{
+    Debugger *d = malloc(sizeof(Debugger));
+    if (!d)
+    {
+        printf("Failed to allocate the debugger journal\n");
+        return 1;
+    }
+    d->vm = vm;
+    d->step = d->journalStart = 0;
+    d->maxSteps = maxSteps;
+    for (int i = 0; i < SNAPSHOT_COUNT; i++)
+    {
+        d->snapshots[i].step = UINT64_MAX;
+    }
+    vm->running = true;
+
+    bool prompt = isatty(STDIN_FILENO);
+    char line[256];
+    printLocation(d);
+    for (;;)
+    {
+        if (prompt)
+        {
+            printf("(vmdb) ");
+            fflush(stdout);
+        }
+        if (!fgets(line, sizeof(line), stdin))
+        {
+            break;
+        }
+
+        char *save;
+        char *cmd = strtok_r(line, " \t\r\n", &save);
+        if (!cmd || cmd[0] == '#')
+        {
+            continue;
+        }
+
+        FindCond cond;
+        uint64_t n;
+        if (strcmp(cmd, "q") == 0 || strcmp(cmd, "quit") == 0)
+        {
+            break;
+        }
+        else if (strcmp(cmd, "s") == 0 || strcmp(cmd, "step") == 0)
+        {
+            char *arg = strtok_r(NULL, " \t\r\n", &save);
+            if (arg && !parseNumber(arg, &n))
+            {
+                printf("usage: step [n]\n");
+                continue;
+            }
+            FindCond none = {.kind = FIND_NONE};
+            continueForward(d, &none, arg ? n : 1);
+        }
+        else if (strcmp(cmd, "b") == 0 || strcmp(cmd, "back") == 0)
+        {
+            char *arg = strtok_r(NULL, " \t\r\n", &save);
+            if (arg && !parseNumber(arg, &n))
+            {
+                printf("usage: back [n]\n");
+                continue;
+            }
+            n = arg ? n : 1;
+            uint64_t target = (n > d->step) ? 0 : d->step - n;
+            gotoStep(d, target);
+            printLocation(d);
+        }
+        else if (strcmp(cmd, "c") == 0 || strcmp(cmd, "continue") == 0)
+        {
+            if (parseCond(&save, &cond, &n))
+            {
+                continueForward(d, &cond, n ? n : d->maxSteps);
+            }
+        }
+        else if (strcmp(cmd, "rc") == 0)
+        {
+            if (parseCond(&save, &cond, &n))
+            {
+                reverseContinue(d, &cond);
+            }
+        }
+        else if (strcmp(cmd, "who") == 0)
+        {
+            whoWrote(d, &save);
+        }
+        else if (strcmp(cmd, "goto") == 0)
+        {
+            if (!parseNumber(strtok_r(NULL, " \t\r\n", &save), &n))
+            {
+                printf("usage: goto STEP\n");
+                continue;
+            }
+            gotoStep(d, n);
+            printLocation(d);
+        }
+        else if (strcmp(cmd, "regs") == 0)
+        {
+            printRegisters(vm);
+        }
+        else if (strcmp(cmd, "mem") == 0)
+        {
+            uint64_t addr = 0, len = MEMORY_SIZE;
+            char *a = strtok_r(NULL, " \t\r\n", &save);
+            char *l = strtok_r(NULL, " \t\r\n", &save);
+            if ((a && !parseNumber(a, &addr)) || (l && !parseNumber(l, &len)) || addr >= MEMORY_SIZE)
+            {
+                printf("usage: mem [ADDR [LEN]]\n");
+                continue;
+            }
+            printMemory(vm, (unsigned)addr, (unsigned)(l ? len : (a ? 16 : MEMORY_SIZE)));
+        }
+        else if (strcmp(cmd, "where") == 0)
+        {
+            printLocation(d);
+        }
+        else if (strcmp(cmd, "info") == 0)
+        {
+            printInfo(d);
+        }
+        else
+        {
+            printHelp();
+        }
+    }
+
+    free(d);
+    return 0;
+}
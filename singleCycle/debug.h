@@ -0,0 +1,26 @@
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include "cpu.h"
+
+/**
+ * 역실행 디버거 (-d)
+ * 스텝 단위는 명령어 (multiCycle은 명령어 하나 = IF~WB 클록들)
+ * 명령어마다 덮어쓴 레지스터/메모리 바이트 하나의 이전 값과 PC만 저널(링 버퍼)에 남기고,
+ * SNAPSHOT_INTERVAL 명령어마다 전체 스냅샷(링 버퍼)을 찍는다.
+ *   저널 안쪽으로 되돌리기: 기록을 하나씩 되돌림 (명령어당 O(1))
+ *   저널보다 오래된 지점: 가장 가까운 앞쪽 스냅샷을 복원하고 다시 실행 (실행은 결정적)
+ * 메모리 사용량은 JOURNAL_CAPACITY * 6바이트 + SNAPSHOT_COUNT개 스냅샷으로 고정
+ */
+
+#define JOURNAL_CAPACITY (1 << 16) // 저널 기록 수 (명령어 하나에 하나)
+#define SNAPSHOT_INTERVAL 4096     // 전체 스냅샷 간격 (명령어 수)
+#define SNAPSHOT_COUNT 64          // 보관할 스냅샷 수
+
+/**
+ * 로드된 VM으로 명령어를 읽어 실행 (표준 입력, EOF면 종료)
+ * maxSteps가 0이 아니면 continue 한 번에 실행할 최대 명령어 수
+ */
+int runDebugger(VM *vm, uint64_t maxSteps);
+
+#endif
@@ -0,0 +1,64 @@
+#include <string.h>
+#include "engine.h"
+#include "dcache.h"
+#include "threaded.h"
+#include "jit.h"
+#include "fuse.h"
+
+static const char *const engineNames[ENGINE_COUNT] = {
+    [ENGINE_SWITCH] = "switch",
+    [ENGINE_DECODED] = "decoded",
+    [ENGINE_THREADED] = "threaded",
+    [ENGINE_JIT] = "jit",
+    [ENGINE_FUSED] = "fused",
+};
+
+const char *engineName(EngineType engine)
+{
+    if (engine >= ENGINE_COUNT)
+    {
+        return "?";
+    }
+    return engineNames[engine];
+}
+
+bool parseEngine(const char *name, EngineType *out)
+{
+    for (int i = 0; i < ENGINE_COUNT; i++)
+    {
+        if (strcmp(name, engineNames[i]) == 0)
+        {
+            *out = (EngineType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t runEngine(VM *vm, EngineType engine, uint64_t maxSteps)
+{
+    uint64_t steps;
+    switch (engine)
+    {
+    case ENGINE_DECODED:
+        steps = runVMDecoded(vm, maxSteps);
+        break;
+    case ENGINE_THREADED:
+        steps = runVMThreaded(vm, maxSteps);
+        break;
+    case ENGINE_JIT:
+        steps = runVMJit(vm, maxSteps);
+        break;
+    case ENGINE_FUSED:
+        steps = runVMFused(vm, maxSteps, NULL, NULL);
+        break;
+    case ENGINE_SWITCH:
+    default:
+        steps = runVMFor(vm, maxSteps);
+        break;
+    }
+    // 단일 사이클: 명령어 하나 = 클록 하나
+    PERF_ADD(vm, retired, steps);
+    PERF_ADD(vm, cycles, steps);
+    return steps;
+}
@@ -0,0 +1,26 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "cpu.h"
+
+// 실행 엔진 종류 (-e 옵션으로 선택)
+typedef enum {
+    ENGINE_SWITCH,   // 기존 runVM() 루프 (기준 엔진)
+    ENGINE_DECODED,  // 디코드 캐시
+    ENGINE_THREADED, // direct-threaded 디스패치
+    ENGINE_JIT,      // x86-64 기본 블록 JIT
+    ENGINE_FUSED,    // 디코드 캐시 + 슈퍼명령어
+    ENGINE_COUNT
+} EngineType;
+
+// 엔진 이름 ("switch", "decoded", ...)
+const char *engineName(EngineType engine);
+
+// 이름으로 엔진 찾기, 없으면 false
+bool parseEngine(const char *name, EngineType *out);
+
+// 선택한 엔진으로 실행 (maxSteps = 0 이면 제한 없음), 실행한 명령어 수 반환
+// 성능 카운터의 retired/cycles는 여기서 더함 (opcode별, 메모리 접근 카운터는 switch 엔진만)
+uint64_t runEngine(VM *vm, EngineType engine, uint64_t maxSteps);
+
+#endif
@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "fleet.h"
+#include "load.h"
+#include "paged.h"
+
+/**
+ * fleet 모드: 여러 프로그램을 한 프로세스에서 실행
+ * 작업 스레드마다 job 번호 구간 [head, tail)을 deque로 나눠 주고,
+ * 주인은 tail 쪽에서 하나씩 꺼내고 일이 떨어진 스레드는 다른 스레드의 head 쪽에서 절반을 훔쳐 온다.
+ * (job이 새로 생기지 않으므로 훔쳐 온 것도 연속 구간이라 배열 없이 번호 두 개로 충분)
+ * 결과는 job마다 버퍼에 써 두고 모두 끝난 뒤 manifest 순서대로 출력.
+ */
+
+#define FLEET_MAX_THREADS 256
+#define FLEET_RESULT_LEN 128
+
+typedef struct {
+    char *path;
+    char result[FLEET_RESULT_LEN]; // 작업 스레드가 채우는 요약 (경로 제외)
+    uint64_t steps;
+    bool failed;
+} FleetJob;
+
+// 작업 스레드별 deque (false sharing을 막기 위해 캐시 라인 정렬)
+typedef struct {
+    pthread_mutex_t lock;
+    size_t head; // 훔쳐 가는 쪽
+    size_t tail; // 주인이 꺼내는 쪽
+    uint64_t stolen; // 훔쳐 온 job 수
+} __attribute__((aligned(64))) WorkQueue;
+
+typedef struct {
+    FleetJob *jobs;
+    WorkQueue *queues;
+    int threadCount;
+    const FleetOptions *opts;
+} Fleet;
+
+typedef struct {
+    Fleet *fleet;
+    int id;
+} Worker;
+
+// 메모리 덤프 대신 FNV-1a 해시로 요약
+static uint32_t hashMemory(const VM *vm)
+{
+    uint32_t h = 2166136261u;
+    for (int addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        h = (h ^ vm->memory[addr]) * 16777619u;
+    }
+    return h;
+}
+
+// job 하나 실행 (VM은 스레드 스택에 둠)
+static void runJob(FleetJob *job, const FleetOptions *opts)
+{
+    VM vm;
+    initVM(&vm);
+    vm.addrBits = opts->addrBits;
+    if (!loadProgramQuiet(&vm, job->path))
+    {
+        snprintf(job->result, sizeof(job->result), "load failed");
+        job->failed = true;
+        return;
+    }
+
+    job->steps = runEngine(&vm, opts->engine, opts->maxSteps);
+
+    const uint8_t *r = vm.cpu.regs;
+    snprintf(job->result, sizeof(job->result),
+             "%s steps=%llu PC=%u regs=%u,%u,%u,%u,%u,%u,%u,%u mem=%08x",
+             vm.running ? "paused" : "stopped", (unsigned long long)job->steps, vm.cpu.PC,
+             r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7], hashMemory(&vm));
+    freePagedMemory(&vm);
+}
+
+// 자기 deque의 tail에서 하나 꺼냄
+static bool popLocal(WorkQueue *q, size_t *job)
+{
+    bool found = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail)
+    {
+        *job = --q->tail;
+        found = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return found;
+}
+
+// 다른 스레드의 head 쪽 절반을 훔쳐서 자기 deque로 옮김
+static bool steal(Fleet *fleet, int self)
+{
+    WorkQueue *mine = &fleet->queues[self];
+    for (int i = 1; i < fleet->threadCount; i++)
+    {
+        WorkQueue *victim = &fleet->queues[(self + i) % fleet->threadCount];
+        size_t from = 0, to = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        size_t left = victim->tail - victim->head;
+        if (left > 0)
+        {
+            size_t take = (left + 1) / 2;
+            from = victim->head;
+            to = from + take;
+            victim->head = to;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (to > from)
+        {
+            pthread_mutex_lock(&mine->lock);
+            mine->head = from;
+            mine->tail = to;
+            mine->stolen += to - from;
+            pthread_mutex_unlock(&mine->lock);
+            return true;
+        }
+    }
+    // job이 새로 생기지 않으므로 모든 deque가 비었으면 끝
+    return false;
+}
+
+static void *workerMain(void *arg)
+{
+    Worker *w = arg;
+    Fleet *fleet = w->fleet;
+    WorkQueue *q = &fleet->queues[w->id];
+    size_t job;
+
+    for (;;)
+    {
+        while (popLocal(q, &job))
+        {
+            runJob(&fleet->jobs[job], fleet->opts);
+        }
+        if (!steal(fleet, w->id))
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static int comparePath(const void *a, const void *b)
+{
+    return strcmp(((const FleetJob *)a)->path, ((const FleetJob *)b)->path);
+}
+
+static bool addJob(FleetJob **jobs, size_t *count, size_t *cap, const char *dir, const char *name)
+{
+    if (*count == *cap)
+    {
+        *cap = *cap ? *cap * 2 : 64;
+        FleetJob *grown = realloc(*jobs, *cap * sizeof(FleetJob));
+        if (!grown)
+        {
+            return false;
+        }
+        *jobs = grown;
+    }
+    FleetJob *job = &(*jobs)[(*count)++];
+    memset(job, 0, sizeof(*job));
+    size_t len = (dir ? strlen(dir) + 1 : 0) + strlen(name) + 1;
+    job->path = malloc(len);
+    if (!job->path)
+    {
+        return false;
+    }
+    if (dir)
+    {
+        snprintf(job->path, len, "%s/%s", dir, name);
+    }
+    else
+    {
+        snprintf(job->path, len, "%s", name);
+    }
+    return true;
+}
+
+// 디렉터리의 일반 파일을 이름 순으로
+static bool listDirectory(const char *dirname, FleetJob **jobs, size_t *count)
+{
+    DIR *dir = opendir(dirname);
+    if (!dir)
+    {
+        printf("Failed to open directory: %s\n", dirname);
+        return false;
+    }
+    size_t cap = 0;
+    bool ok = true;
+    struct dirent *ent;
+    while (ok && (ent = readdir(dir)) != NULL)
+    {
+        if (ent->d_name[0] == '.')
+        {
+            continue;
+        }
+        ok = addJob(jobs, count, &cap, dirname, ent->d_name);
+        struct stat st;
+        if (ok && (stat((*jobs)[*count - 1].path, &st) != 0 || !S_ISREG(st.st_mode)))
+        {
+            free((*jobs)[--(*count)].path);
+        }
+    }
+    closedir(dir);
+    if (ok && *count > 1)
+    {
+        qsort(*jobs, *count, sizeof(FleetJob), comparePath);
+    }
+    return ok;
+}
+
+// 매니페스트: 한 줄에 경로 하나, 빈 줄과 '#' 주석은 무시
+// 상대 경로는 매니페스트가 있는 디렉터리 기준
+static bool listManifest(const char *manifest, FleetJob **jobs, size_t *count)
+{
+    FILE *fp = fopen(manifest, "r");
+    if (!fp)
+    {
+        printf("Failed to open manifest: %s\n", manifest);
+        return false;
+    }
+
+    char base[1024] = "";
+    const char *slash = strrchr(manifest, '/');
+    if (slash && (size_t)(slash - manifest) < sizeof(base))
+    {
+        memcpy(base, manifest, slash - manifest);
+        base[slash - manifest] = '\0';
+    }
+
+    size_t cap = 0;
+    bool ok = true;
+    char line[1024];
+    while (ok && fgets(line, sizeof(line), fp))
+    {
+        char *path = line;
+        while (*path == ' ' || *path == '\t')
+        {
+            path++;
+        }
+        path[strcspn(path, "\r\n")] = '\0';
+        if (path[0] == '\0' || path[0] == '#')
+        {
+            continue;
+        }
+        ok = addJob(jobs, count, &cap, (path[0] != '/' && base[0]) ? base : NULL, path);
+    }
+    fclose(fp);
+    return ok;
+}
+
+static void freeJobs(FleetJob *jobs, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        free(jobs[i].path);
+    }
+    free(jobs);
+}
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int runFleet(const char *source, const FleetOptions *opts)
+{
+    FleetJob *jobs = NULL;
+    size_t count = 0;
+    struct stat st;
+    bool ok;
+
+    if (stat(source, &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        ok = listDirectory(source, &jobs, &count);
+    }
+    else
+    {
+        ok = listManifest(source, &jobs, &count);
+    }
+    if (!ok || count == 0)
+    {
+        if (ok)
+        {
+            printf("No programs in %s\n", source);
+        }
+        freeJobs(jobs, count);
+        return 1;
+    }
+
+    // 스레드 수: 기본은 코어 수, job 수보다 많을 필요 없음
+    long threads = opts->threads > 0 ? opts->threads : sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1)
+        threads = 1;
+    if (threads > FLEET_MAX_THREADS)
+        threads = FLEET_MAX_THREADS;
+    if ((size_t)threads > count)
+        threads = (long)count;
+
+    Fleet fleet = {.jobs = jobs, .threadCount = (int)threads, .opts = opts};
+    fleet.queues = aligned_alloc(_Alignof(WorkQueue), threads * sizeof(WorkQueue));
+    Worker workers[FLEET_MAX_THREADS];
+    pthread_t tids[FLEET_MAX_THREADS];
+    if (!fleet.queues)
+    {
+        printf("Failed to allocate work queues\n");
+        freeJobs(jobs, count);
+        return 1;
+    }
+
+    // job을 연속 구간으로 고르게 나눠 줌
+    for (long t = 0; t < threads; t++)
+    {
+        WorkQueue *q = &fleet.queues[t];
+        pthread_mutex_init(&q->lock, NULL);
+        q->head = count * t / threads;
+        q->tail = count * (t + 1) / threads;
+        q->stolen = 0;
+        workers[t] = (Worker){.fleet = &fleet, .id = (int)t};
+    }
+
+    double t0 = nowSeconds();
+    int started = 0;
+    for (long t = 1; t < threads; t++)
+    {
+        if (pthread_create(&tids[t], NULL, workerMain, &workers[t]) != 0)
+        {
+            break; // 못 만든 스레드의 몫은 다른 스레드가 훔쳐 감
+        }
+        started++;
+    }
+    workerMain(&workers[0]); // 메인 스레드도 작업 스레드 0으로 참여
+    for (int t = 1; t <= started; t++)
+    {
+        pthread_join(tids[t], NULL);
+    }
+    double elapsed = nowSeconds() - t0;
+
+    // 결과 출력 (job 순서대로)
+    uint64_t totalSteps = 0, stolen = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        printf("%s: %s\n", jobs[i].path, jobs[i].result);
+        totalSteps += jobs[i].steps;
+        failed += jobs[i].failed;
+    }
+    for (long t = 0; t < threads; t++)
+    {
+        stolen += fleet.queues[t].stolen;
+        pthread_mutex_destroy(&fleet.queues[t].lock);
+    }
+    printf("fleet: %zu programs (%zu failed), %ld threads, %llu instructions, %.3f s, %.1f MIPS, %llu stolen\n",
+           count, failed, threads, (unsigned long long)totalSteps, elapsed,
+           elapsed > 0 ? totalSteps / elapsed / 1e6 : 0.0, (unsigned long long)stolen);
+
+    freeJobs(jobs, count);
+    free(fleet.queues);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,21 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "engine.h"
+
+// fleet 모드 설정
+typedef struct {
+    EngineType engine; // 실행 엔진
+    uint64_t maxSteps; // 프로그램당 최대 실행 명령어 수 (0 = 제한 없음)
+    int threads;       // 작업 스레드 수 (0 = 코어 수)
+    uint8_t addrBits;  // MOV_RF/MOV_FR 주소 폭 (-A, 0 = 기본값)
+} FleetOptions;
+
+/**
+ * 매니페스트(한 줄에 프로그램 경로 하나) 또는 디렉터리 안의 프로그램들을
+ * 한 프로세스에서 work-stealing 스레드 풀로 실행하고 프로그램별 요약을 한 줄씩 출력
+ * 목록을 만들 수 없거나 로드에 실패한 프로그램이 있으면 0이 아닌 값을 반환
+ */
+int runFleet(const char *source, const FleetOptions *opts);
+
+#endif
@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <string.h>
+#include "fuse.h"
+
+/**
+ * 슈퍼명령어(superinstruction) 융합
+ * 로드된 이미지에서 도달 가능한 명령어를 따라가며 기본 블록을 나누고,
+ * 블록 안에서 자주 붙어 나오는 명령어 2~3개를 디코드 캐시 슬롯 하나로 합친다.
+ * 합쳐진 명령어 중간으로 뛰어드는 JMP가 없으므로 블록 경계의 상태는 그대로.
+ * (PC별 슬롯이라 중간 주소의 일반 슬롯도 그대로 남아 있음)
+ */
+
+static const char *const fusionNames[FUSE_KINDS] = {
+    [FUSE_NONE] = "-",
+    [FUSE_MR_ADD_RM] = "MOV_MR+ADD_RR+MOV_RM",
+    [FUSE_MR_SUB_RM] = "MOV_MR+SUB_RR+MOV_RM",
+    [FUSE_MR_ADD] = "MOV_MR+ADD_RR",
+    [FUSE_MR_SUB] = "MOV_MR+SUB_RR",
+    [FUSE_ADD_RM] = "ADD_RR+MOV_RM",
+    [FUSE_SUB_RM] = "SUB_RR+MOV_RM",
+    [FUSE_JMP_NOP] = "JMP->NOP",
+};
+
+static const char *const opNames[INVALID + 1] = {
+    "HALT", "NOP", "MOV_RR", "MOV_RM", "MOV_MR", "ADD_RR", "SUB_RR", "JMP", "MOV_RF", "MOV_FR", "INVALID"};
+
+int fusionLength(FusionKind kind)
+{
+    switch (kind)
+    {
+    case FUSE_MR_ADD_RM:
+    case FUSE_MR_SUB_RM:
+        return 3;
+    case FUSE_NONE:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+const char *fusionName(FusionKind kind)
+{
+    return (kind < FUSE_KINDS) ? fusionNames[kind] : "?";
+}
+
+// opcode 바이트의 명령어 크기
+static uint16_t opSize(uint8_t op)
+{
+    Instruction instr = {.opcode = (op < INVALID) ? (Opcode)op : INVALID};
+    return getInstructionSize(&instr);
+}
+
+void analyzeFusion(const VM *vm, FusionPlan *plan)
+{
+    bool reach[MEMORY_SIZE] = {false};  // 명령어 시작 주소
+    bool leader[MEMORY_SIZE] = {false}; // 기본 블록 시작 (진입점, JMP 대상)
+    bool queued[MEMORY_SIZE] = {false};
+    uint16_t work[MEMORY_SIZE];
+    int top = 0;
+
+    memset(plan, 0, sizeof(*plan));
+    if (vm->cpu.PC >= MEMORY_SIZE)
+    {
+        return;
+    }
+    leader[vm->cpu.PC] = true;
+    queued[vm->cpu.PC] = true;
+    work[top++] = vm->cpu.PC;
+
+    // 1) 진입점부터 fall-through와 JMP를 따라가며 도달 가능한 명령어 표시
+    while (top > 0)
+    {
+        uint16_t pc = work[--top];
+        while (pc < MEMORY_SIZE && !reach[pc])
+        {
+            uint8_t op = vm->memory[pc];
+            uint16_t size = opSize(op);
+            if (op >= INVALID || pc + size > MEMORY_SIZE)
+            {
+                break;
+            }
+            reach[pc] = true;
+            plan->instrCount++;
+            if (op == HALT)
+            {
+                break;
+            }
+            if (op == JMP)
+            {
+                uint8_t target = vm->memory[pc + 1];
+                leader[target] = true;
+                if (!queued[target])
+                {
+                    queued[target] = true;
+                    work[top++] = target;
+                }
+                break;
+            }
+            pc += size;
+        }
+    }
+
+    // 2) 인접 명령어 쌍 빈도
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        uint8_t op = vm->memory[pc];
+        if (!reach[pc] || op == HALT || op == JMP)
+        {
+            continue;
+        }
+        int next = pc + opSize(op);
+        if (next < MEMORY_SIZE && reach[next])
+        {
+            uint8_t nextOp = vm->memory[next];
+            plan->pairs[op][nextOp < INVALID ? nextOp : INVALID]++;
+        }
+    }
+
+    // 3) 블록 안에서만 융합 (뒤따르는 명령어가 JMP 대상이면 안 됨)
+    bool consumed[MEMORY_SIZE] = {false};
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        if (!reach[pc] || consumed[pc])
+        {
+            continue;
+        }
+        uint8_t op1 = vm->memory[pc];
+        uint8_t op2 = (pc + 3 < MEMORY_SIZE && reach[pc + 3] && !leader[pc + 3]) ? vm->memory[pc + 3] : INVALID;
+        uint8_t op3 = (op2 != INVALID && pc + 6 < MEMORY_SIZE && reach[pc + 6] && !leader[pc + 6]) ? vm->memory[pc + 6] : INVALID;
+        FusionKind kind = FUSE_NONE;
+
+        if (op1 == MOV_MR && op2 == ADD_RR && op3 == MOV_RM)
+            kind = FUSE_MR_ADD_RM;
+        else if (op1 == MOV_MR && op2 == SUB_RR && op3 == MOV_RM)
+            kind = FUSE_MR_SUB_RM;
+        else if (op1 == MOV_MR && op2 == ADD_RR)
+            kind = FUSE_MR_ADD;
+        else if (op1 == MOV_MR && op2 == SUB_RR)
+            kind = FUSE_MR_SUB;
+        else if (op1 == ADD_RR && op2 == MOV_RM)
+            kind = FUSE_ADD_RM;
+        else if (op1 == SUB_RR && op2 == MOV_RM)
+            kind = FUSE_SUB_RM;
+        else if (op1 == JMP && vm->memory[vm->memory[pc + 1]] == NOP)
+            kind = FUSE_JMP_NOP;
+
+        if (kind == FUSE_NONE)
+        {
+            continue;
+        }
+        plan->kind[pc] = kind;
+        plan->sites[kind]++;
+        if (kind != FUSE_JMP_NOP)
+        {
+            for (int i = 1; i < fusionLength(kind); i++)
+            {
+                consumed[pc + 3 * i] = true;
+            }
+        }
+    }
+}
+
+// 슬롯이 비어 있으면 디코딩
+static const DecodedInstr *slotAt(DecodeCache *dc, const VM *vm, uint16_t pc)
+{
+    if (dc->code[pc].op == DOP_UNDECODED)
+    {
+        return decodeIntoCache(dc, vm, pc);
+    }
+    return &dc->code[pc];
+}
+
+// pc 슬롯을 슈퍼명령어로 바꿈 (구성 명령어 슬롯도 디코딩해 둠)
+static void fuseSlot(DecodeCache *dc, const VM *vm, uint16_t pc, FusionKind kind)
+{
+    DecodedInstr first = *slotAt(dc, vm, pc);
+    if (kind == FUSE_JMP_NOP)
+    {
+        slotAt(dc, vm, first.imm);
+    }
+    else
+    {
+        for (int i = 1; i < fusionLength(kind); i++)
+        {
+            slotAt(dc, vm, pc + 3 * i);
+        }
+    }
+
+    dropSlot(dc, pc);
+    DecodedInstr *d = &dc->code[pc];
+    *d = first;
+    d->first = first.op;
+    d->op = DOP_FUSED_BASE + kind;
+    if (kind == FUSE_JMP_NOP)
+    {
+        d->len = first.len;
+        d->nextPC = first.imm + 1;
+        dc->nopTarget[first.imm] = 1;
+    }
+    else
+    {
+        d->len = (uint8_t)(3 * fusionLength(kind));
+        d->nextPC = pc + d->len;
+    }
+    for (uint16_t a = pc; a < pc + d->len && a < MEMORY_SIZE; a++)
+    {
+        dc->codeMap[a]++;
+    }
+}
+
+void applyFusion(DecodeCache *dc, const VM *vm, const FusionPlan *plan)
+{
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        if (plan->kind[pc] != FUSE_NONE)
+        {
+            fuseSlot(dc, vm, (uint16_t)pc, (FusionKind)plan->kind[pc]);
+        }
+    }
+}
+
+uint64_t runVMFused(VM *vm, uint64_t maxSteps, const FusionPlan *plan, FusionStats *stats)
+{
+    DecodeCache dc;
+    FusionPlan localPlan;
+
+    if (!plan)
+    {
+        analyzeFusion(vm, &localPlan);
+        plan = &localPlan;
+    }
+    initDecodeCache(&dc);
+    applyFusion(&dc, vm, plan);
+    return runDecodedLoop(vm, &dc, maxSteps, stats);
+}
+
+void printFusionReport(const FusionPlan *plan, const FusionStats *stats)
+{
+    printf("----- Superinstruction Fusion -----\n");
+    printf("reachable instructions: %u\n", plan->instrCount);
+
+    // 가장 많이 붙어 나오는 쌍 (최대 5개)
+    uint32_t pairs[INVALID + 1][INVALID + 1];
+    memcpy(pairs, plan->pairs, sizeof(pairs));
+    printf("hot adjacent pairs:\n");
+    for (int i = 0; i < 5; i++)
+    {
+        uint32_t best = 0;
+        int bestA = 0, bestB = 0;
+        for (int a = 0; a <= INVALID; a++)
+        {
+            for (int b = 0; b <= INVALID; b++)
+            {
+                if (pairs[a][b] > best)
+                {
+                    best = pairs[a][b], bestA = a, bestB = b;
+                }
+            }
+        }
+        if (best == 0)
+        {
+            break;
+        }
+        printf("  %-7s -> %-7s %u\n", opNames[bestA], opNames[bestB], best);
+        pairs[bestA][bestB] = 0;
+    }
+
+    printf("%-22s %6s %14s\n", "fusion", "sites", "executed");
+    for (int k = FUSE_NONE + 1; k < FUSE_KINDS; k++)
+    {
+        if (plan->sites[k] == 0)
+        {
+            continue;
+        }
+        printf("%-22s %6u %14llu\n", fusionName((FusionKind)k), plan->sites[k],
+               stats ? (unsigned long long)stats->fired[k] : 0ULL);
+    }
+    if (stats)
+    {
+        printf("dispatches saved: %llu\n", (unsigned long long)stats->dispatchSaved);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef FUSE_H
+#define FUSE_H
+
+#include "cpu.h"
+#include "dcache.h"
+
+// 슈퍼명령어 종류 (자주 붙어 나오는 명령어 2~3개를 핸들러 하나로 실행)
+typedef enum {
+    FUSE_NONE,
+    FUSE_MR_ADD_RM, // MOV_MR -> ADD_RR -> MOV_RM
+    FUSE_MR_SUB_RM, // MOV_MR -> SUB_RR -> MOV_RM
+    FUSE_MR_ADD,    // MOV_MR -> ADD_RR
+    FUSE_MR_SUB,    // MOV_MR -> SUB_RR
+    FUSE_ADD_RM,    // ADD_RR -> MOV_RM
+    FUSE_SUB_RM,    // SUB_RR -> MOV_RM
+    FUSE_JMP_NOP,   // JMP 대상이 NOP이면 NOP까지 한 번에
+    FUSE_KINDS
+} FusionKind;
+
+// 로드 직후 분석 결과
+typedef struct {
+    uint8_t kind[MEMORY_SIZE];         // PC -> 적용할 FusionKind
+    uint32_t sites[FUSE_KINDS];        // 종류별 적용 위치 수
+    uint32_t pairs[INVALID + 1][INVALID + 1]; // 도달 가능한 코드의 인접 명령어 쌍 빈도
+    uint32_t instrCount;               // 도달 가능한 명령어 수
+} FusionPlan;
+
+// 실행 중 통계
+typedef struct FusionStatsTag {
+    uint64_t fired[FUSE_KINDS]; // 종류별 실행 횟수
+    uint64_t dispatchSaved;     // 줄어든 디스패치 수
+} FusionStats;
+
+// 슈퍼명령어가 대신하는 명령어 수
+int fusionLength(FusionKind kind);
+
+// 종류 이름 ("MOV_MR+ADD_RR+MOV_RM" 등)
+const char *fusionName(FusionKind kind);
+
+/**
+ * 로드된 프로그램 분석 (loadProgramFromFile() 다음에 호출)
+ * 현재 PC에서 도달 가능한 명령어와 기본 블록 경계를 찾고,
+ * 블록 안에서만 슈퍼명령어를 고른다 (블록 중간으로 뛰어드는 JMP가 없게)
+ */
+void analyzeFusion(const VM *vm, FusionPlan *plan);
+
+// 분석 결과를 디코드 캐시에 미리 채움
+void applyFusion(DecodeCache *dc, const VM *vm, const FusionPlan *plan);
+
+/**
+ * 슈퍼명령어를 쓰는 디코드 캐시 실행 루프
+ * plan이 NULL이면 내부에서 분석, stats가 NULL이면 통계 생략
+ */
+uint64_t runVMFused(VM *vm, uint64_t maxSteps, const FusionPlan *plan, FusionStats *stats);
+
+// 분석/실행 결과 출력
+void printFusionReport(const FusionPlan *plan, const FusionStats *stats);
+
+#endif
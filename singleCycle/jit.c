@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "jit.h"
+#include "paged.h"
+
+/**
+ * 기본 블록(basic block) JIT: 게스트 명령어를 x86-64 기계어로 번역해서 실행
+ *
+ * 호스트 레지스터 배치
+ *   r8b ~ r15b : 게스트 R0 ~ R7
+ *   rbp        : VM *
+ *   rdi        : JitState * (codeMap, 남은 명령어 수, 종료 정보)
+ *   rbx        : 남은 명령어 수 (블록 시작마다 블록 길이만큼 차감)
+ *
+ * 블록은 JMP(또는 최대 길이)에서 끝나고, 다음 블록으로 가는 jmp는
+ * 처음엔 종료 스텁을 가리키다가 대상 블록이 번역되면 직접 연결(chaining)된다.
+ * MOV_RM이 번역된 코드 바이트에 쓰면 블록을 빠져나와 번역 캐시 전체를 비운다.
+ * 번역할 수 없는 명령어(INVALID, MOV_RF/MOV_FR, 메모리 끝에 걸친 명령어)는 기준 엔진이 한 스텝 실행.
+ */
+
+#if defined(__x86_64__) && defined(__unix__)
+
+#include <sys/mman.h>
+
+#define JIT_BUFFER_SIZE (1 << 20)
+// 블록 하나를 번역하기 전에 남아 있어야 할 버퍼 크기
+#define JIT_BLOCK_RESERVE 4096
+// 블록당 최대 명령어 수
+#define JIT_MAX_BLOCK 32
+
+// 블록에서 빠져나온 이유 (exitInfo 상위 16비트)
+enum {
+    EXIT_HALT = 1,   // HALT 실행 (PC는 HALT 다음)
+    EXIT_CHAIN = 2,  // 아직 연결되지 않은 다음 블록으로 이동
+    EXIT_SMC = 3,    // 번역된 코드 바이트에 저장
+    EXIT_BUDGET = 4, // 남은 명령어 수가 블록 길이보다 적음
+    EXIT_INTERP = 5  // 번역할 수 없는 명령어
+};
+
+#define NO_SITE 0xFFFFFFFFu
+
+// 번역 코드와 주고받는 상태 (오프셋은 offsetof로 기계어에 박힘)
+typedef struct {
+    uint8_t codeMap[MEMORY_SIZE]; // 번역된 블록이 덮고 있는 바이트
+    int64_t budget;               // 남은 명령어 수
+    uint32_t exitInfo;            // (이유 << 16) | PC
+    uint32_t exitSite;            // 연결할 jmp rel32 위치 (버퍼 오프셋)
+} JitState;
+
+typedef void (*JitEntry)(JitState *state, VM *vm, const uint8_t *block);
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t used;
+    uint32_t stubEnd;            // 진입/종료 코드 끝 (flush 후 여기서부터 다시 사용)
+    uint32_t exitCode;           // 공통 종료 코드 위치
+    uint32_t generation;         // flush 횟수 (연결 위치가 아직 유효한지 확인용)
+    int32_t blockAt[MEMORY_SIZE]; // PC -> 블록 오프셋 (-1 = 없음)
+    JitState state;
+} Jit;
+
+/*  -------------------------------------
+        기계어 출력 도우미
+    -------------------------------------
+*/
+
+static void emit8(Jit *j, uint8_t b)
+{
+    j->buf[j->used++] = b;
+}
+
+static void emit32(Jit *j, uint32_t v)
+{
+    memcpy(&j->buf[j->used], &v, 4);
+    j->used += 4;
+}
+
+static void patch32(Jit *j, uint32_t at, uint32_t v)
+{
+    memcpy(&j->buf[at], &v, 4);
+}
+
+// rel32 필드(at)가 target을 가리키도록 설정
+static void patchRel32(Jit *j, uint32_t at, uint32_t target)
+{
+    patch32(j, at, (uint32_t)((int32_t)target - (int32_t)(at + 4)));
+}
+
+// 종료 스텁: [add rbx, refund] / mov eax, info / mov ecx, site / jmp exit
+static void emitExit(Jit *j, uint32_t reason, uint16_t pc, uint32_t site, uint32_t refund)
+{
+    if (refund)
+    {
+        emit8(j, 0x48), emit8(j, 0x81), emit8(j, 0xC3), emit32(j, refund);
+    }
+    emit8(j, 0xB8), emit32(j, (reason << 16) | pc);
+    emit8(j, 0xB9), emit32(j, site);
+    emit8(j, 0xE9), emit32(j, 0);
+    patchRel32(j, j->used - 4, j->exitCode);
+}
+
+// 진입 코드와 공통 종료 코드
+static void emitTrampolines(Jit *j)
+{
+    uint32_t budgetOff = offsetof(JitState, budget);
+
+    // 진입: 콜리 저장 레지스터 보관, rbp = vm, rbx = budget, 게스트 레지스터 로드
+    emit8(j, 0x53);                               // push rbx
+    emit8(j, 0x55);                               // push rbp
+    emit8(j, 0x41), emit8(j, 0x54);               // push r12
+    emit8(j, 0x41), emit8(j, 0x55);               // push r13
+    emit8(j, 0x41), emit8(j, 0x56);               // push r14
+    emit8(j, 0x41), emit8(j, 0x57);               // push r15
+    emit8(j, 0x48), emit8(j, 0x89), emit8(j, 0xF5); // mov rbp, rsi
+    emit8(j, 0x48), emit8(j, 0x8B), emit8(j, 0x9F), emit32(j, budgetOff); // mov rbx, [rdi+budget]
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        // movzx r(8+r)d, byte [rbp + regs[r]]
+        emit8(j, 0x44), emit8(j, 0x0F), emit8(j, 0xB6), emit8(j, 0x80 | (r << 3) | 5);
+        emit32(j, (uint32_t)(offsetof(VM, cpu.regs) + r));
+    }
+    emit8(j, 0xFF), emit8(j, 0xE2); // jmp rdx
+
+    // 종료: 게스트 레지스터 저장, budget/종료 정보 기록, 복귀
+    j->exitCode = j->used;
+    for (int r = 0; r < NUM_REGS; r++)
+    {
+        // mov byte [rbp + regs[r]], r(8+r)b
+        emit8(j, 0x44), emit8(j, 0x88), emit8(j, 0x80 | (r << 3) | 5);
+        emit32(j, (uint32_t)(offsetof(VM, cpu.regs) + r));
+    }
+    emit8(j, 0x48), emit8(j, 0x89), emit8(j, 0x9F), emit32(j, budgetOff); // mov [rdi+budget], rbx
+    emit8(j, 0x89), emit8(j, 0x87), emit32(j, offsetof(JitState, exitInfo)); // mov [rdi+exitInfo], eax
+    emit8(j, 0x89), emit8(j, 0x8F), emit32(j, offsetof(JitState, exitSite)); // mov [rdi+exitSite], ecx
+    emit8(j, 0x41), emit8(j, 0x5F); // pop r15
+    emit8(j, 0x41), emit8(j, 0x5E); // pop r14
+    emit8(j, 0x41), emit8(j, 0x5D); // pop r13
+    emit8(j, 0x41), emit8(j, 0x5C); // pop r12
+    emit8(j, 0x5D);                 // pop rbp
+    emit8(j, 0x5B);                 // pop rbx
+    emit8(j, 0xC3);                 // ret
+
+    j->stubEnd = j->used;
+}
+
+// 번역된 블록을 모두 버림
+static void flushJit(Jit *j)
+{
+    j->used = j->stubEnd;
+    j->generation++;
+    for (int pc = 0; pc < MEMORY_SIZE; pc++)
+    {
+        j->blockAt[pc] = -1;
+    }
+    memset(j->state.codeMap, 0, sizeof(j->state.codeMap));
+}
+
+/*  -------------------------------------
+        블록 번역
+    -------------------------------------
+*/
+
+// pc에서 시작하는 블록을 번역, 첫 명령어부터 번역할 수 없으면 -1
+static int32_t translateBlock(Jit *j, const VM *vm, uint16_t startPC)
+{
+    if (JIT_BUFFER_SIZE - j->used < JIT_BLOCK_RESERVE)
+    {
+        flushJit(j);
+    }
+
+    uint32_t start = j->used;
+    uint32_t smcSite[JIT_MAX_BLOCK];   // jne rel32 위치
+    uint16_t smcPC[JIT_MAX_BLOCK];     // 저장 후 이어서 실행할 PC
+    uint32_t smcRefund[JIT_MAX_BLOCK]; // 실행하지 않은 명령어 수 (돌려줄 budget)
+    int smcCount = 0;
+
+    // cmp rbx, N / jl budgetStub / sub rbx, N  (N은 끝에서 채움)
+    emit8(j, 0x48), emit8(j, 0x81), emit8(j, 0xFB);
+    uint32_t cmpImm = j->used;
+    emit32(j, 0);
+    emit8(j, 0x0F), emit8(j, 0x8C);
+    uint32_t budgetSite = j->used;
+    emit32(j, 0);
+    emit8(j, 0x48), emit8(j, 0x81), emit8(j, 0xEB);
+    uint32_t subImm = j->used;
+    emit32(j, 0);
+
+    uint16_t pc = startPC;
+    uint32_t count = 0;
+    bool ended = false;
+    while (!ended && count < JIT_MAX_BLOCK)
+    {
+        if (pc >= MEMORY_SIZE)
+        {
+            break;
+        }
+        Instruction instr = {.opcode = (Opcode)vm->memory[pc]};
+        if (instr.opcode >= INVALID || instr.opcode == MOV_RF || instr.opcode == MOV_FR)
+        {
+            break;
+        }
+        uint16_t size = getInstructionSize(&instr);
+        if (pc + size > MEMORY_SIZE)
+        {
+            break;
+        }
+        uint8_t a = (size > 1) ? (vm->memory[pc + 1] & (NUM_REGS - 1)) : 0;
+        uint8_t b = (size > 2) ? (vm->memory[pc + 2] & (NUM_REGS - 1)) : 0;
+        uint8_t immJ = (size > 1) ? vm->memory[pc + 1] : 0; // JMP / MOV_MR 주소
+        uint8_t immR = (size > 2) ? vm->memory[pc + 2] : 0; // MOV_RM 주소
+        uint32_t memOff = offsetof(VM, memory);
+
+        count++;
+        switch (instr.opcode)
+        {
+        case HALT:
+            emitExit(j, EXIT_HALT, pc + 1, NO_SITE, 0);
+            ended = true;
+            break;
+
+        case NOP:
+            break;
+
+        case MOV_RR: // mov r(8+a)b, r(8+b)b
+            emit8(j, 0x45), emit8(j, 0x88), emit8(j, 0xC0 | (b << 3) | a);
+            break;
+
+        case ADD_RR: // add r(8+a)b, r(8+b)b
+            emit8(j, 0x45), emit8(j, 0x00), emit8(j, 0xC0 | (b << 3) | a);
+            break;
+
+        case SUB_RR: // sub r(8+a)b, r(8+b)b
+            emit8(j, 0x45), emit8(j, 0x28), emit8(j, 0xC0 | (b << 3) | a);
+            break;
+
+        case MOV_RM: // mov [rbp + memory + imm], r(8+a)b
+            emit8(j, 0x44), emit8(j, 0x88), emit8(j, 0x80 | (a << 3) | 5);
+            emit32(j, memOff + immR);
+            // or dword [rbp + dirty], 라인 비트 (주소가 번역 시점에 정해져 있으므로 상수)
+            emit8(j, 0x81), emit8(j, 0x8D);
+            emit32(j, (uint32_t)offsetof(VM, dirty));
+            emit32(j, 1u << (immR >> DIRTY_LINE_SHIFT));
+            // cmp byte [rdi + codeMap + imm], 0 / jne smcStub
+            emit8(j, 0x80), emit8(j, 0xBF);
+            emit32(j, (uint32_t)offsetof(JitState, codeMap) + immR);
+            emit8(j, 0x00);
+            emit8(j, 0x0F), emit8(j, 0x85);
+            smcSite[smcCount] = j->used;
+            smcPC[smcCount] = pc + size;
+            smcRefund[smcCount] = count; // 끝에서 (N - count)로 바꿈
+            smcCount++;
+            emit32(j, 0);
+            break;
+
+        case MOV_MR: // mov r(8+b)b, [rbp + memory + imm]  (imm = 첫 오퍼랜드)
+            emit8(j, 0x44), emit8(j, 0x8A), emit8(j, 0x80 | (b << 3) | 5);
+            emit32(j, memOff + immJ);
+            break;
+
+        case JMP: // jmp rel32 (처음엔 바로 뒤 스텁)
+        {
+            emit8(j, 0xE9);
+            uint32_t site = j->used;
+            emit32(j, 0);
+            emitExit(j, EXIT_CHAIN, immJ, site, 0);
+            ended = true;
+            break;
+        }
+
+        default:
+            break;
+        }
+        pc += size;
+    }
+
+    if (count == 0)
+    {
+        j->used = start;
+        return -1;
+    }
+
+    if (!ended)
+    {
+        // 최대 길이 또는 번역할 수 없는 명령어: 다음 PC로 이어지는 연결 지점
+        if (pc < MEMORY_SIZE && count == JIT_MAX_BLOCK)
+        {
+            emit8(j, 0xE9);
+            uint32_t site = j->used;
+            emit32(j, 0);
+            emitExit(j, EXIT_CHAIN, pc, site, 0);
+        }
+        else
+        {
+            emitExit(j, EXIT_INTERP, pc, NO_SITE, 0);
+        }
+    }
+
+    // 블록 길이 채우기
+    patch32(j, cmpImm, count);
+    patch32(j, subImm, count);
+
+    // budget 부족 스텁
+    patchRel32(j, budgetSite, j->used);
+    emitExit(j, EXIT_BUDGET, startPC, NO_SITE, 0);
+
+    // 자기 수정 코드 스텁
+    for (int i = 0; i < smcCount; i++)
+    {
+        patchRel32(j, smcSite[i], j->used);
+        emitExit(j, EXIT_SMC, smcPC[i], NO_SITE, count - smcRefund[i]);
+    }
+
+    // 블록이 덮는 바이트 표시
+    for (uint16_t addr = startPC; addr < pc && addr < MEMORY_SIZE; addr++)
+    {
+        j->state.codeMap[addr] = 1;
+    }
+    j->blockAt[startPC] = (int32_t)start;
+    return (int32_t)start;
+}
+
+// pc의 블록 오프셋 (없으면 번역)
+static int32_t lookupBlock(Jit *j, const VM *vm, uint16_t pc)
+{
+    if (j->blockAt[pc] >= 0)
+    {
+        return j->blockAt[pc];
+    }
+    return translateBlock(j, vm, pc);
+}
+
+/*  -------------------------------------
+        실행 루프
+    -------------------------------------
+*/
+
+uint64_t runVMJit(VM *vm, uint64_t maxSteps)
+{
+    Jit jit;
+    Jit *j = &jit;
+
+    void *p = mmap(NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        // 실행 가능한 메모리를 못 받으면 기준 엔진으로 실행
+        return runVMFor(vm, maxSteps);
+    }
+    memset(j, 0, sizeof(*j));
+    j->buf = p;
+    emitTrampolines(j);
+    flushJit(j);
+
+    JitEntry enter = (JitEntry)(void *)j->buf;
+    int64_t total = maxSteps ? (int64_t)maxSteps : INT64_MAX;
+    j->state.budget = total;
+    vm->running = true;
+
+    while (vm->running && j->state.budget > 0)
+    {
+        uint16_t pc = vm->cpu.PC;
+        if (pc >= MEMORY_SIZE)
+        {
+            printf("Error: PC out of memory range!\n");
+            vm->running = false;
+            break;
+        }
+
+        int32_t block = lookupBlock(j, vm, pc);
+        if (block < 0)
+        {
+            // 번역할 수 없는 명령어는 기준 엔진으로 한 스텝
+            // (MOV_RF가 번역된 코드 바이트에 쓰면 EXIT_SMC처럼 번역 캐시를 비움)
+            uint32_t addr = (vm->memory[pc] == MOV_RF) ? wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF)) : MEMORY_SIZE;
+            j->state.budget -= (int64_t)runVMFor(vm, 1);
+            if (addr < MEMORY_SIZE && j->state.codeMap[addr])
+            {
+                flushJit(j);
+            }
+            continue;
+        }
+
+        enter(&j->state, vm, j->buf + block);
+
+        uint32_t reason = j->state.exitInfo >> 16;
+        vm->cpu.PC = (uint16_t)(j->state.exitInfo & 0xFFFF);
+        switch (reason)
+        {
+        case EXIT_HALT:
+            vm->running = false;
+            break;
+
+        case EXIT_CHAIN:
+        {
+            // 대상 블록을 번역해서 jmp를 직접 연결
+            uint32_t site = j->state.exitSite;
+            uint32_t generation = j->generation;
+            int32_t target = lookupBlock(j, vm, vm->cpu.PC);
+            if (target >= 0 && generation == j->generation)
+            {
+                patchRel32(j, site, (uint32_t)target);
+            }
+            break;
+        }
+
+        case EXIT_SMC:
+            flushJit(j);
+            break;
+
+        case EXIT_BUDGET:
+            // 블록 하나보다 적게 남음: 나머지는 기준 엔진으로
+            if (j->state.budget > 0)
+            {
+                j->state.budget -= (int64_t)runVMFor(vm, (uint64_t)j->state.budget);
+            }
+            break;
+
+        case EXIT_INTERP:
+        default:
+            // 다음 반복에서 번역에 실패하고 기준 엔진이 한 스텝 실행
+            break;
+        }
+    }
+
+    munmap(j->buf, JIT_BUFFER_SIZE);
+    return (uint64_t)(total - j->state.budget);
+}
+
+bool jitAvailable(void)
+{
+    return true;
+}
+
+#else
+
+// x86-64가 아닌 호스트: 기준 엔진으로 실행
+uint64_t runVMJit(VM *vm, uint64_t maxSteps)
+{
+    return runVMFor(vm, maxSteps);
+}
+
+bool jitAvailable(void)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "cpu.h"
+
+/**
+ * 기본 블록 JIT 실행 루프 (x86-64)
+ * 다른 호스트이거나 실행 가능한 메모리를 못 받으면 runVMFor()로 실행
+ * maxSteps = 0 이면 제한 없음, 실행한 명령어 수를 반환
+ */
+uint64_t runVMJit(VM *vm, uint64_t maxSteps);
+
+// 이 빌드에서 JIT가 동작하는지 여부
+bool jitAvailable(void);
+
+#endif
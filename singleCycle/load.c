@@ -2,49 +2,48 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include "cpu.h"
+#include "load.h"
+#include "image.h"
+#include "asm.h"
 
 #define MAX_LINE 128
 
-// txt파일의 문자열을 받아 Opcode를 결정하는 함수.
-static Opcode stringToOpcode(const char *str)
-{
-    if (strcmp(str, "HALT") == 0)
-        return HALT;
-    if (strcmp(str, "NOP") == 0)
-        return NOP;
-    if (strcmp(str, "MOV_RR") == 0)
-        return MOV_RR;
-    if (strcmp(str, "MOV_RM") == 0)
-        return MOV_RM;
-    if (strcmp(str, "MOV_MR") == 0)
-        return MOV_MR;
-    if (strcmp(str, "ADD_RR") == 0)
-        return ADD_RR;
-    if (strcmp(str, "SUB_RR") == 0)
-        return SUB_RR;
-    if (strcmp(str, "JMP") == 0)
-        return JMP;
-
-    return INVALID; // 알 수 없는 문자열
-}
-
 // program.txt를 열어서 한 줄씩 읽는다:
-void loadProgramFromFile(VM *vm, const char *filename)
+// verbose가 false면 아무것도 출력하지 않음 (fleet 모드에서 여러 스레드가 동시에 호출)
+// lines가 NULL이 아니면 명령어 시작 주소마다 줄 번호를 기록 (loadSourceLines)
+static bool loadProgram(VM *vm, const char *filename, bool verbose, uint32_t *lines)
 {
+    // 바이너리 이미지면 파싱 없이 바로 로드
+    ImageStatus image = loadProgramImage(vm, filename, verbose);
+    if (image != IMAGE_NOT_IMAGE)
+    {
+        return image == IMAGE_OK;
+    }
+
+    // .s/.asm은 어셈블러로 (레이블, 지시어, 줄 번호가 붙은 오류)
+    if (isAssemblySource(filename))
+    {
+        return assembleFile(vm, filename, verbose, lines);
+    }
+
     FILE *fp = fopen(filename, "r");
     if (!fp)
     {
-        printf("Failed to open file: %s\n", filename);
-        return;
+        if (verbose)
+            printf("Failed to open file: %s\n", filename);
+        return false;
     }
 
     // PC(메모리에 명령어를 쓸 위치)
     uint16_t pc = 0;
     char line[MAX_LINE];
+    char *save; // strtok 대신 strtok_r (스레드 안전)
+    uint32_t lineNo = 0;
 
     while (fgets(line, sizeof(line), fp))
     {
+        lineNo++;
+
         // 주석이나 빈 줄 처리
         if (line[0] == '\n' || line[0] == '\r' || line[0] == '#')
         {
@@ -52,7 +51,7 @@ void loadProgramFromFile(VM *vm, const char *filename)
         }
 
         // 공백 기준으로 첫 토큰 추출
-        char *token = strtok(line, " \t\r\n");
+        char *token = strtok_r(line, " \t\r\n", &save);
         if (!token)
             continue;
 
@@ -66,7 +65,7 @@ void loadProgramFromFile(VM *vm, const char *filename)
             {
                 int regIndex = regChar - '0';
                 // 레지스터에 들어갈 값을 레지스터에 저장
-                char *valStr = strtok(NULL, " \t\r\n");
+                char *valStr = strtok_r(NULL, " \t\r\n", &save);
                 if (valStr)
                 {
                     int val = (int)strtol(valStr, NULL, 0);
@@ -75,7 +74,7 @@ void loadProgramFromFile(VM *vm, const char *filename)
                         // 해당 register에 값을 저장
                         vm->cpu.regs[regIndex] = (uint8_t)(val & 0xFF);
                     }
-                    else
+                    else if (verbose)
                     {
                         printf("Register R%d out of range!\n", regIndex);
                     }
@@ -85,14 +84,17 @@ void loadProgramFromFile(VM *vm, const char *filename)
         }
 
         // 명령어 처리
-        Opcode op = stringToOpcode(token);
+        Opcode op = lookupMnemonic(token, strlen(token));
         if (op == INVALID)
         {
-            printf("Unknown opcode: %s\n", token);
+            if (verbose)
+                printf("Unknown opcode: %s\n", token);
             continue;
         }
 
         // opcode 저장
+        if (lines && pc < MEMORY_SIZE)
+            lines[pc] = lineNo;
         vm->memory[pc] = (uint8_t)op;
         pc++;
 
@@ -109,8 +111,8 @@ void loadProgramFromFile(VM *vm, const char *filename)
         case ADD_RR:
         case SUB_RR:
         {
-            char *aStr = strtok(NULL, " \t\r\n");
-            char *bStr = strtok(NULL, " \t\r\n");
+            char *aStr = strtok_r(NULL, " \t\r\n", &save);
+            char *bStr = strtok_r(NULL, " \t\r\n", &save);
             if (aStr && bStr)
             {
                 int a = (int)strtol(aStr, NULL, 0);
@@ -126,8 +128,8 @@ void loadProgramFromFile(VM *vm, const char *filename)
         case MOV_MR:
         {
             // reg + imm (2바이트)
-            char *rStr = strtok(NULL, " \t\r\n");
-            char *iStr = strtok(NULL, " \t\r\n");
+            char *rStr = strtok_r(NULL, " \t\r\n", &save);
+            char *iStr = strtok_r(NULL, " \t\r\n", &save);
             if (rStr && iStr)
             {
                 int r = (int)strtol(rStr, NULL, 0);
@@ -142,7 +144,7 @@ void loadProgramFromFile(VM *vm, const char *filename)
         case JMP:
         {
             // imm (1바이트)
-            char *immStr = strtok(NULL, " \t\r\n");
+            char *immStr = strtok_r(NULL, " \t\r\n", &save);
             if (immStr)
             {
                 int imm = (int)strtol(immStr, NULL, 0);
@@ -152,6 +154,29 @@ void loadProgramFromFile(VM *vm, const char *filename)
             break;
         }
 
+        case MOV_RF:
+        case MOV_FR:
+        {
+            // 레지스터 1바이트 + 32비트 주소 4바이트 (리틀 엔디언, 순서는 WIDE_ADDR_OFFSET)
+            char *aStr = strtok_r(NULL, " \t\r\n", &save);
+            char *bStr = strtok_r(NULL, " \t\r\n", &save);
+            if (aStr && bStr)
+            {
+                uint32_t values[2] = {(uint32_t)strtoul(aStr, NULL, 0), (uint32_t)strtoul(bStr, NULL, 0)};
+                uint16_t start = pc - 1;
+                for (int i = 0; i < 2; i++)
+                {
+                    int bytes = (pc - start == WIDE_ADDR_OFFSET(op)) ? 4 : 1;
+                    for (int b = 0; b < bytes; b++, pc++)
+                    {
+                        if (pc < MEMORY_SIZE)
+                            vm->memory[pc] = (uint8_t)(values[i] >> (8 * b));
+                    }
+                }
+            }
+            break;
+        }
+
         default:
             // INVALID 등은 위에서 이미 거르지만
             break;
@@ -162,5 +187,25 @@ void loadProgramFromFile(VM *vm, const char *filename)
 
     // PC 초기값 0으로 설정
     vm->cpu.PC = 0;
-    printf("Program loaded from %s. PC=0\n", filename);
+    if (verbose)
+        printf("Program loaded from %s. PC=0\n", filename);
+    return true;
+}
+
+bool loadProgramFromFile(VM *vm, const char *filename)
+{
+    return loadProgram(vm, filename, true, NULL);
+}
+
+bool loadProgramQuiet(VM *vm, const char *filename)
+{
+    return loadProgram(vm, filename, false, NULL);
+}
+
+bool loadSourceLines(const char *filename, uint32_t lines[MEMORY_SIZE])
+{
+    memset(lines, 0, MEMORY_SIZE * sizeof(lines[0]));
+    VM scratch;
+    initVM(&scratch);
+    return loadProgram(&scratch, filename, false, lines);
 }
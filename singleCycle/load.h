@@ -0,0 +1,18 @@
+#ifndef LOAD_H
+#define LOAD_H
+
+#include "cpu.h"
+
+// 프로그램 파일을 VM 메모리에 로드 (결과를 출력)
+// 바이너리 이미지(image.h)면 그대로, .s/.asm이면 어셈블러(asm.h)로, 아니면 텍스트로 읽음
+// 파일을 열 수 없거나 이미지/어셈블리에 오류가 있으면 false
+bool loadProgramFromFile(VM *vm, const char *filename);
+
+// 출력 없이 로드, 파일을 열 수 없으면 false (여러 스레드에서 동시에 호출 가능)
+bool loadProgramQuiet(VM *vm, const char *filename);
+
+// 명령어 시작 주소별 소스 줄 번호 (프로파일러 주석 목록용, 0 = 없음, 이미지는 모두 0)
+// 파일을 다시 읽어서 채움, 읽을 수 없거나 어셈블 오류가 있으면 false
+bool loadSourceLines(const char *filename, uint32_t lines[MEMORY_SIZE]);
+
+#endif
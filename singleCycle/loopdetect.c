@@ -0,0 +1,62 @@
+#include <string.h>
+#include "loopdetect.h"
+
+void attachLoopDetector(VM *vm, LoopDetector *lp)
+{
+    memset(lp, 0, sizeof(*lp));
+    for (uint16_t r = 0; r < NUM_REGS; r++)
+    {
+        lp->hash += loopMix(r, vm->cpu.regs[r]);
+    }
+    for (uint16_t addr = 0; addr < MEMORY_SIZE; addr++)
+    {
+        lp->hash += loopMix(NUM_REGS + addr, vm->memory[addr]);
+    }
+    lp->power = 1;
+    vm->loop = lp;
+}
+
+static bool sameState(const LoopDetector *lp, const VM *vm)
+{
+    return lp->savedCPU.PC == vm->cpu.PC && memcmp(lp->savedCPU.regs, vm->cpu.regs, NUM_REGS) == 0 &&
+           memcmp(lp->savedMemory, vm->memory, MEMORY_SIZE) == 0;
+}
+
+bool checkLoop(VM *vm, uint64_t steps)
+{
+    LoopDetector *lp = vm->loop;
+    lp->disabled |= (vm->paged != NULL);
+    if (lp->disabled)
+    {
+        return false;
+    }
+
+    uint64_t now = lp->stepBase + steps;
+    uint64_t hash = lp->hash + loopMix(LOOP_PC_SLOT, (uint8_t)vm->cpu.PC);
+    lp->checks++;
+    lp->visits++;
+    if (lp->saved && hash == lp->savedHash)
+    {
+        lp->compares++;
+        if (sameState(lp, vm))
+        {
+            lp->found = true;
+            lp->cycleLength = now - lp->savedStep;
+            lp->detectedAt = now;
+            vm->running = false;
+            return true;
+        }
+    }
+
+    if (!lp->saved || lp->visits >= lp->power)
+    {
+        lp->saved = true;
+        lp->savedHash = hash;
+        lp->savedCPU = vm->cpu;
+        memcpy(lp->savedMemory, vm->memory, MEMORY_SIZE);
+        lp->savedStep = now;
+        lp->power *= 2;
+        lp->visits = 0;
+    }
+    return false;
+}
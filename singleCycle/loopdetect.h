@@ -0,0 +1,64 @@
+#ifndef LOOPDETECT_H
+#define LOOPDETECT_H
+
+#include <stdint.h>
+#include "cpu.h"
+
+/**
+ * 무한 루프 검사 (switch 엔진, 기본으로 켜짐, -L로 끔)
+ * 레지스터와 메모리 바이트마다 (위치, 값)을 섞은 64비트 값을 모두 더한 해시를 쓰기마다 증분 갱신하고,
+ * 뒤로 가는 JMP(대상 <= 지금 PC)마다 해시 + PC를 Brent 방식으로 저장해 둔 상태 하나와 비교한다.
+ * 해시가 같으면 레지스터/PC/메모리를 전부 비교해서 같을 때만 멈추므로 충돌로 잘못 멈추지 않는다.
+ * (JMP 뒤 상태가 같으면 그 뒤 실행도 같으므로 영원히 반복)
+ * 저장한 상태는 방문 1, 2, 4, 8, ...번째마다 바뀌어서 메모리는 상태 하나뿐이고,
+ * 순환에 들어간 뒤 순환 길이의 몇 배 안에 찾는다 (처음 반복한 곳보다 늦게 찾을 수 있음)
+ * 넓은 주소 페이지(MEMORY_SIZE 이상)를 쓰면 상태가 커지므로 그때부터 검사하지 않음
+ */
+
+#define LOOP_PC_SLOT (NUM_REGS + MEMORY_SIZE) // 해시에서 PC 자리
+
+typedef struct LoopDetector {
+    uint64_t hash;      // 레지스터 + 메모리 (PC 제외)
+    uint64_t stepBase;  // 이전 runVMFor() 호출들에서 실행한 명령어 수
+    bool disabled;      // 페이지 메모리를 써서 검사 중단
+
+    // Brent: 저장한 상태, power번 방문하면 지금 상태로 바꾸고 power를 두 배로
+    bool saved;
+    uint64_t savedHash;
+    CPUState savedCPU;
+    uint8_t savedMemory[MEMORY_SIZE];
+    uint64_t savedStep;
+    uint64_t power;
+    uint64_t visits;
+
+    uint64_t checks;    // 뒤로 가는 JMP 수
+    uint64_t compares;  // 해시가 같아서 전부 비교한 수
+    bool found;
+    uint64_t cycleLength; // 순환 한 바퀴의 명령어 수 (L)
+    uint64_t detectedAt;  // 찾을 때까지 실행한 명령어 수
+} LoopDetector;
+
+// (위치, 값) 섞기: slot은 레지스터 번호, NUM_REGS + 주소, LOOP_PC_SLOT
+static inline uint64_t loopMix(uint16_t slot, uint8_t value)
+{
+    uint64_t x = (((uint64_t)slot << 8) | value) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 31);
+}
+
+// 레지스터/메모리 쓰기마다 호출 (검사기가 없으면 아무것도 안 함)
+static inline void loopNoteWrite(VM *vm, uint16_t slot, uint8_t old, uint8_t value)
+{
+    if (vm->loop)
+    {
+        vm->loop->hash += loopMix(slot, value) - loopMix(slot, old);
+    }
+}
+
+// 지금 VM 상태로 해시를 계산하고 vm->loop에 붙임
+void attachLoopDetector(VM *vm, LoopDetector *lp);
+
+// 뒤로 가는 JMP를 실행한 직후 호출, 같은 상태가 다시 나왔으면 running = false로 멈추고 true
+// steps = 이번 runVMFor() 호출에서 실행한 명령어 수
+bool checkLoop(VM *vm, uint64_t steps);
+
+#endif
@@ -1,10 +1,21 @@
 // main.c
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "cpu.h"
-
-// load.c에 있는 함수 선언
-void loadProgramFromFile(VM *vm, const char *filename);
+#include "load.h"
+#include "image.h"
+#include "engine.h"
+#include "fuse.h"
+#include "batch.h"
+#include "fleet.h"
+#include "checkpoint.h"
+#include "debug.h"
+#include "paged.h"
+#include "profile.h"
+#include "trace.h"
+#include "loopdetect.h"
 
 // VM 상태(모든 레지스터, 메모리)를 출력하는 함수
 
@@ -33,27 +44,407 @@ static void printVMState(const VM *vm)
     printf("\n\n");
 }
 
+// 성능 카운터 내보내기 (-p 텍스트, -J JSON 파일, "-" = 표준 출력)
+static int exportPerf(const VM *vm, bool text, const char *jsonPath)
+{
+#ifdef PERF_COUNTERS
+    if (text)
+    {
+        printPerfText(stdout, &vm->perf);
+    }
+    if (jsonPath)
+    {
+        FILE *fp = (strcmp(jsonPath, "-") == 0) ? stdout : fopen(jsonPath, "w");
+        if (!fp)
+        {
+            printf("Failed to open %s\n", jsonPath);
+            return 1;
+        }
+        writePerfJson(fp, &vm->perf);
+        if (fp != stdout)
+        {
+            fclose(fp);
+        }
+    }
+#else
+    (void)vm;
+    if (text || jsonPath)
+    {
+        printf("Performance counters are compiled out (rebuild with make PERF=1)\n");
+    }
+#endif
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [-e engine] [-n maxSteps] [-L] [-A bits] [-p] [-J counters.json] [-s lanes] [program.txt|program.s|program.vmi]\n", prog);
+    printf("       %s -o program.vmi [program.txt|program.s]\n", prog);
+    printf("       %s -d [-n maxSteps] [program]\n", prog);
+    printf("       %s -P exact|every:N|timer:US [-G stacks.folded] [-n maxSteps] [program]\n", prog);
+    printf("       %s -T trace.bin [-n maxSteps] [program] | -X trace.bin [-n maxRecords]\n", prog);
+    printf("       %s [-C checkpoints] [-k interval] [-R checkpoints[@index]] [-e engine] [-n maxSteps] [program]\n", prog);
+    printf("       %s -f manifest|dir [-j threads] [-e engine] [-n maxSteps]\n", prog);
+    printf("  -e  실행 엔진: ");
+    for (int i = 0; i < ENGINE_COUNT; i++)
+    {
+        printf("%s%s", i ? ", " : "", engineName((EngineType)i));
+    }
+    printf(" (기본 switch)\n");
+    printf("  -n  최대 실행 명령어 수 (0 = 제한 없음)\n");
+    printf("  -L  무한 루프 검사 끄기 (switch 엔진은 뒤로 가는 JMP마다 같은 상태가 다시 나왔는지 검사해서 멈춤)\n");
+    printf("  -A  MOV_RF/MOV_FR 주소 폭: 16 또는 32 (기본 %d, %d 이상 주소는 4KiB 페이지를 처음 쓸 때 할당)\n",
+           WIDE_ADDR_BITS, MEMORY_SIZE);
+    printf("  -p  종료 시 성능 카운터 출력\n");
+    printf("  -J  종료 시 성능 카운터를 JSON으로 저장 (- = 표준 출력)\n");
+    printf("  -f  fleet 모드: 매니페스트(한 줄에 경로 하나) 또는 디렉터리의 프로그램을 모두 실행\n");
+    printf("  -j  fleet 작업 스레드 수 (기본 코어 수)\n");
+    printf("  -o  실행하지 않고 바이너리 이미지로 변환해서 저장 (미리 디코딩한 명령어 목록 포함)\n");
+    printf("  -d  역실행 디버거: 표준 입력으로 step/back/continue/rc/who/goto 명령 (기준 엔진, help로 목록)\n");
+    printf("  -C  실행하면서 증분 체크포인트를 파일에 기록 (시작, -k 명령어마다, 끝)\n");
+    printf("  -k  체크포인트 간격 (명령어 수, 0 = 시작과 끝만)\n");
+    printf("  -R  프로그램 대신 체크포인트 파일에서 이어서 실행 (@index로 중간 체크포인트 선택, 기본 마지막)\n");
+    printf("  -P  PC별 프로파일: exact (명령어마다), every:N (평균 N 명령어마다 샘플), timer:US (CPU 시간 US마다 샘플)\n");
+    printf("  -G  프로파일을 flamegraph용 collapsed stack으로 저장 (- = 표준 출력, -P 없으면 exact)\n");
+    printf("  -T  명령어마다 PC, opcode, 쓴 레지스터, 메모리 주소/값을 압축 트레이스로 기록 (백그라운드 스레드가 저장)\n");
+    printf("  -X  실행하지 않고 -T로 기록한 트레이스를 텍스트로 출력 (-n = 최대 레코드 수)\n");
+    printf("  -s  파라미터 스윕: lane i는 R0 += i %% 256, R1 += i / 256 으로 lanes개 VM을 배치 실행\n");
+}
+
+// 엔진 한 번 실행 (fused는 지금 메모리로 슈퍼명령어를 다시 분석하고 통계를 모음)
+static uint64_t runChunk(VM *vm, EngineType engine, uint64_t maxSteps, FusionPlan *plan, FusionStats *fusionStats)
+{
+    if (engine != ENGINE_FUSED)
+    {
+        return runEngine(vm, engine, maxSteps);
+    }
+    analyzeFusion(vm, plan);
+    uint64_t steps = runVMFused(vm, maxSteps, plan, fusionStats);
+    PERF_ADD(vm, retired, steps);
+    PERF_ADD(vm, cycles, steps);
+    return steps;
+}
+
+// 체크포인트를 찍으면서 실행: 시작 상태, every 명령어마다, 마지막 상태
+static bool runCheckpointed(VM *vm, EngineType engine, uint64_t maxSteps, const char *path, uint64_t every,
+                            uint64_t startSteps, uint64_t *steps, FusionPlan *plan, FusionStats *fusionStats)
+{
+    CheckpointLog log;
+    if (!openCheckpointLog(&log, path) || !saveCheckpoint(&log, vm, startSteps))
+    {
+        closeCheckpointLog(&log);
+        return false;
+    }
+    bool ok = true;
+    *steps = 0;
+    do
+    {
+        uint64_t chunk = every;
+        if (maxSteps && (chunk == 0 || maxSteps - *steps < chunk))
+        {
+            chunk = maxSteps - *steps;
+        }
+        *steps += runChunk(vm, engine, chunk, plan, fusionStats);
+        ok = saveCheckpoint(&log, vm, startSteps + *steps);
+    } while (ok && vm->running && (maxSteps == 0 || *steps < maxSteps));
+
+    printf("%u checkpoints written to %s (%llu lines of %d bytes)\n", log.count, path,
+           (unsigned long long)log.linesWritten, DIRTY_LINE_SIZE);
+    closeCheckpointLog(&log);
+    return ok;
+}
+
+// 파라미터 스윕: 같은 프로그램을 lanes개의 VM으로 배치 실행하고 lane별 결과 요약
+static int runSweep(const VM *image, size_t lanes, uint64_t maxSteps)
+{
+    BatchVM batch;
+    if (!initBatch(&batch, image, lanes))
+    {
+        return 1;
+    }
+    for (size_t i = 0; i < lanes; i++)
+    {
+        setLaneReg(&batch, i, 0, (uint8_t)(image->cpu.regs[0] + i));
+        setLaneReg(&batch, i, 1, (uint8_t)(image->cpu.regs[1] + i / 256));
+    }
+
+    uint64_t total = runBatch(&batch, maxSteps);
+
+    size_t halted = 0;
+    printf("lane   R0  R1  R2  R3  R4  R5  R6  R7   PC  state\n");
+    for (size_t i = 0; i < lanes; i++)
+    {
+        VM vm;
+        getLaneVM(&batch, i, &vm);
+        printf("%4zu ", i);
+        for (int r = 0; r < NUM_REGS; r++)
+        {
+            printf("%4u", vm.cpu.regs[r]);
+        }
+        printf(" %4u  %s\n", vm.cpu.PC, vm.running ? "paused" : "stopped");
+        halted += !vm.running;
+    }
+    printf("%zu lanes, %zu stopped, %zu paused (step limit), %llu instructions total\n",
+           lanes, halted, lanes - halted, (unsigned long long)total);
+
+    freeBatch(&batch);
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    EngineType engine = ENGINE_SWITCH;
+    uint64_t maxSteps = 0;
+    size_t sweepLanes = 0;
+    const char *fleetSource = NULL;
+    int threads = 0;
+    bool perfText = false;
+    const char *perfJson = NULL;
+    const char *imageOut = NULL;
+    const char *checkpointOut = NULL;
+    uint64_t checkpointEvery = 0;
+    const char *resumeFrom = NULL;
+    bool debug = false;
+    int addrBits = 0;
+    Profile profile = {.mode = PROFILE_EXACT};
+    bool profiling = false;
+    const char *stacksOut = NULL;
+    const char *traceOut = NULL;
+    const char *traceIn = NULL;
+    bool loopCheck = true;
+
+    // 옵션 파싱
+    int opt;
+    while ((opt = getopt(argc, argv, "e:n:LA:s:f:j:pJ:o:C:k:R:P:G:T:X:dh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'e':
+            if (!parseEngine(optarg, &engine))
+            {
+                printf("Unknown engine: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'n':
+            maxSteps = strtoull(optarg, NULL, 0);
+            break;
+        case 'L':
+            loopCheck = false;
+            break;
+        case 'A':
+            addrBits = atoi(optarg);
+            if (addrBits != 16 && addrBits != 32)
+            {
+                printf("Address width must be 16 or 32: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            sweepLanes = strtoull(optarg, NULL, 0);
+            break;
+        case 'f':
+            fleetSource = optarg;
+            break;
+        case 'j':
+            threads = atoi(optarg);
+            break;
+        case 'p':
+            perfText = true;
+            break;
+        case 'J':
+            perfJson = optarg;
+            break;
+        case 'o':
+            imageOut = optarg;
+            break;
+        case 'C':
+            checkpointOut = optarg;
+            break;
+        case 'k':
+            checkpointEvery = strtoull(optarg, NULL, 0);
+            break;
+        case 'R':
+            resumeFrom = optarg;
+            break;
+        case 'd':
+            debug = true;
+            break;
+        case 'P':
+            if (!parseProfileSpec(&profile, optarg))
+            {
+                printf("Unknown profile mode: %s\n", optarg);
+                usage(argv[0]);
+                return 1;
+            }
+            profiling = true;
+            break;
+        case 'G':
+            stacksOut = optarg;
+            profiling = true;
+            break;
+        case 'T':
+            traceOut = optarg;
+            break;
+        case 'X':
+            traceIn = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (traceIn)
+    {
+        return dumpTrace(traceIn, stdout, maxSteps) ? 0 : 1;
+    }
+
+    if (fleetSource)
+    {
+        FleetOptions fleet = {.engine = engine, .maxSteps = maxSteps, .threads = threads, .addrBits = addrBits};
+        return runFleet(fleetSource, &fleet);
+    }
+
+    // 프로파일러는 runVMFor() 위에서 PC를 셈
+    if (profiling && (engine != ENGINE_SWITCH || checkpointOut))
+    {
+        printf("The profiler needs -e switch without -C\n");
+        return 1;
+    }
+    // 트레이스도 runVMFor()와 같은 루프에서 명령어마다 기록
+    if (traceOut && (engine != ENGINE_SWITCH || checkpointOut || profiling))
+    {
+        printf("The tracer needs -e switch without -C or -P\n");
+        return 1;
+    }
+
     // 인자로부터 파일 이름 결정
     const char *filename = "program.txt";
-    if (argc > 1)
+    if (optind < argc)
     {
-        filename = argv[1];
+        filename = argv[optind];
     }
 
     // VM 초기화
     VM vm;
     initVM(&vm);
+    vm.addrBits = (uint8_t)addrBits;
+
+    // 프로그램 로드(텍스트 파일 -> vm.memory), -R이면 체크포인트에서 복원
+    uint64_t startSteps = 0;
+    if (resumeFrom ? !resumeCheckpointSpec(&vm, resumeFrom, &startSteps) : !loadProgramFromFile(&vm, filename))
+    {
+        return 1;
+    }
+
+    if (imageOut)
+    {
+        if (!writeProgramImage(&vm, imageOut, true))
+        {
+            return 1;
+        }
+        printf("Program image written to %s\n", imageOut);
+        return 0;
+    }
+
+    // HALT나 오류 뒤에 찍은 체크포인트는 실행하지 않고 마지막 상태만 출력
+    if (resumeFrom && !vm.running)
+    {
+        printf("VM stopped.\n");
+        printVMState(&vm);
+        freePagedMemory(&vm);
+        return 0;
+    }
 
-    // 프로그램 로드(텍스트 파일 -> vm.memory)
-    loadProgramFromFile(&vm, filename);
+    if (debug)
+    {
+        return runDebugger(&vm, maxSteps);
+    }
+
+    if (sweepLanes > 0)
+    {
+        return runSweep(&vm, sweepLanes, maxSteps);
+    }
+
+    // 무한 루프 검사: 해시는 executeInstruction()이, 검사는 runVMFor()가 하므로 switch 엔진에서만
+    LoopDetector loop;
+    if (loopCheck && engine == ENGINE_SWITCH && !profiling && !traceOut)
+    {
+        attachLoopDetector(&vm, &loop);
+    }
 
     // VM 실행
-    runVM(&vm);
+    uint64_t steps;
+    bool traceOk = true;
+    FusionPlan plan;
+    FusionStats fusionStats = {0};
+    if (checkpointOut)
+    {
+        if (!runCheckpointed(&vm, engine, maxSteps, checkpointOut, checkpointEvery, startSteps, &steps, &plan,
+                             &fusionStats))
+        {
+            return 1;
+        }
+    }
+    else if (profiling)
+    {
+        steps = runProfiled(&vm, maxSteps, &profile);
+    }
+    else if (traceOut)
+    {
+        TraceWriter *trace = openTrace(traceOut, startSteps);
+        if (!trace)
+        {
+            return 1;
+        }
+        steps = runTraced(&vm, maxSteps, trace);
+        traceOk = closeTrace(trace);
+    }
+    else
+    {
+        steps = runChunk(&vm, engine, maxSteps, &plan, &fusionStats);
+    }
+    if (vm.running)
+    {
+        printf("VM paused after %llu instructions (step limit).\n",
+               (unsigned long long)(startSteps + steps));
+    }
+    else if (vm.loop && loop.found)
+    {
+        printf("VM stopped: non-terminating, cycle length L=%llu instructions "
+               "(detected after %llu instructions, %llu backward JMPs, %llu full compares).\n",
+               (unsigned long long)loop.cycleLength, (unsigned long long)(startSteps + loop.detectedAt),
+               (unsigned long long)loop.checks, (unsigned long long)loop.compares);
+    }
+    else
+    {
+        printf("VM stopped.\n");
+    }
 
     // 전체 상태(모든 레지스터, 메모리) 출력
     printVMState(&vm);
 
-    return 0;
+    if (engine == ENGINE_FUSED)
+    {
+        printFusionReport(&plan, &fusionStats);
+    }
+    printPagedStats(&vm);
+
+    int status = traceOk ? 0 : 1;
+    if (profiling)
+    {
+        // -R이면 소스 파일이 없으므로 PC별 목록만
+        const char *source = resumeFrom ? NULL : filename;
+        printProfileReport(&profile, &vm, source);
+        if (stacksOut && !writeCollapsedStacks(&profile, &vm, source, stacksOut))
+        {
+            status = 1;
+        }
+    }
+
+    status |= exportPerf(&vm, perfText, perfJson);
+    freePagedMemory(&vm);
+    return status;
 }
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "paged.h"
+
+uint32_t wideAddressLimit(const VM *vm)
+{
+    int bits = vm->addrBits ? vm->addrBits : WIDE_ADDR_BITS;
+    return (bits >= 32) ? 0xFFFFFFFFu : (1u << bits) - 1;
+}
+
+uint32_t wideOperand(const VM *vm, uint32_t at)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--)
+    {
+        value = (value << 8) | operandByte(vm, at + i);
+    }
+    return value;
+}
+
+// addr가 있는 페이지 (없으면 alloc일 때만 할당, 실패하거나 없으면 NULL)
+static uint8_t *findPage(VM *vm, uint32_t addr, bool alloc)
+{
+    PagedMemory *pm = vm->paged;
+    if (!pm)
+    {
+        if (!alloc)
+        {
+            return NULL;
+        }
+        pm = vm->paged = calloc(1, sizeof(PagedMemory));
+        if (!pm)
+        {
+            return NULL;
+        }
+        pm->tlbPage = NO_PAGE;
+    }
+    pm->tlbMisses++;
+
+    uint32_t page = addr >> PAGE_SHIFT;
+    uint8_t ***slot = &pm->table[page >> PAGE_TABLE_BITS];
+    if (!*slot)
+    {
+        if (!alloc || !(*slot = calloc(PAGE_TABLE_SIZE, sizeof(uint8_t *))))
+        {
+            return NULL;
+        }
+    }
+    uint8_t **data = &(*slot)[page & (PAGE_TABLE_SIZE - 1)];
+    if (!*data)
+    {
+        if (!alloc || !(*data = calloc(1, PAGE_SIZE)))
+        {
+            return NULL;
+        }
+        pm->pages++;
+    }
+    pm->tlbPage = page;
+    pm->tlbData = *data;
+    return *data;
+}
+
+bool pagedLoadSlow(VM *vm, uint32_t addr, uint8_t *value)
+{
+    if (addr > wideAddressLimit(vm))
+    {
+        return false;
+    }
+    if (vm->paged)
+    {
+        vm->paged->accesses++;
+    }
+    // 쓴 적 없는 페이지는 할당하지 않고 0
+    uint8_t *data = findPage(vm, addr, false);
+    *value = data ? data[addr & PAGE_MASK] : 0;
+    return true;
+}
+
+bool pagedStoreSlow(VM *vm, uint32_t addr, uint8_t value)
+{
+    if (addr > wideAddressLimit(vm))
+    {
+        return false;
+    }
+    uint8_t *data = findPage(vm, addr, true);
+    if (!data)
+    {
+        return false;
+    }
+    vm->paged->accesses++;
+    data[addr & PAGE_MASK] = value;
+    return true;
+}
+
+void wideAccessError(const VM *vm, Opcode op, uint32_t addr, uint16_t pc)
+{
+    const char *name = (op == MOV_RF) ? "MOV_RF" : "MOV_FR";
+    if (addr > wideAddressLimit(vm))
+    {
+        printf("Error: %s address 0x%X outside the %d-bit address space at PC=%u\n", name, addr,
+               vm->addrBits ? vm->addrBits : WIDE_ADDR_BITS, pc);
+    }
+    else
+    {
+        printf("Error: %s failed to allocate a page for 0x%X at PC=%u\n", name, addr, pc);
+    }
+}
+
+void freePagedMemory(VM *vm)
+{
+    PagedMemory *pm = vm->paged;
+    if (!pm)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < PAGE_TABLE_SIZE; i++)
+    {
+        if (!pm->table[i])
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < PAGE_TABLE_SIZE; j++)
+        {
+            free(pm->table[i][j]);
+        }
+        free(pm->table[i]);
+    }
+    free(pm);
+    vm->paged = NULL;
+}
+
+void printPagedStats(const VM *vm)
+{
+    const PagedMemory *pm = vm->paged;
+    if (!pm)
+    {
+        return;
+    }
+    printf("----- Paged Memory (%d-bit) -----\n", vm->addrBits ? vm->addrBits : WIDE_ADDR_BITS);
+    printf("pages           = %u (%u KiB)\n", pm->pages, pm->pages * (PAGE_SIZE / 1024));
+    printf("accesses        = %llu\n", (unsigned long long)pm->accesses);
+    printf("lookaside hits  = %.2f%% (%llu walks)\n",
+           pm->accesses ? 100.0 * (pm->accesses - pm->tlbMisses) / pm->accesses : 0.0,
+           (unsigned long long)pm->tlbMisses);
+}
@@ -0,0 +1,107 @@
+#ifndef PAGED_H
+#define PAGED_H
+
+#include "cpu.h"
+
+/**
+ * 넓은 주소 공간 (MOV_RF / MOV_FR)
+ * 주소 0 ~ MEMORY_SIZE-1 은 기존 vm->memory (코드, MOV_RM/MOV_MR과 같은 바이트),
+ * 그 위는 4KiB 페이지를 처음 쓸 때 할당하는 희소 메모리 (2단계 테이블, 10비트 + 10비트).
+ * 쓴 적 없는 페이지는 0으로 읽고 할당하지 않으므로 넓은 주소를 안 쓰는 프로그램은 비용이 없다.
+ * 접근 경로에는 마지막으로 찾은 페이지 하나를 기억하는 lookaside가 있어
+ * 같은 페이지를 연속으로 쓰면 테이블을 따라가지 않음.
+ */
+
+// 기본 주소 폭 (-A 옵션이 없을 때, make ADDR_BITS=32 로 변경)
+#ifndef WIDE_ADDR_BITS
+#define WIDE_ADDR_BITS 16
+#endif
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1u << PAGE_SHIFT)
+#define PAGE_MASK (PAGE_SIZE - 1)
+#define PAGE_TABLE_BITS 10 // 테이블 한 단계의 인덱스 비트 (32 - 12 = 20 = 10 + 10)
+#define PAGE_TABLE_SIZE (1u << PAGE_TABLE_BITS)
+#define NO_PAGE 0xFFFFFFFFu // 빈 lookaside (페이지 번호는 20비트)
+
+typedef struct PagedMemory {
+    uint32_t tlbPage; // lookaside: 마지막으로 찾은 페이지 번호
+    uint8_t *tlbData; //            그 페이지
+    uint32_t pages;   // 할당한 페이지 수
+    uint64_t accesses;   // MEMORY_SIZE 이상 주소 접근 수
+    uint64_t tlbMisses;  // lookaside 미스 (테이블을 따라간 횟수)
+    uint8_t **table[PAGE_TABLE_SIZE]; // table[page >> 10][page & 1023], 둘 다 처음 쓸 때 할당
+} PagedMemory;
+
+// 마지막으로 쓸 수 있는 주소 (2^bits - 1)
+uint32_t wideAddressLimit(const VM *vm);
+
+// 명령어 바이트 하나 (메모리 밖 바이트는 0, 모든 엔진의 디코더가 같이 씀)
+static inline uint8_t operandByte(const VM *vm, uint32_t at)
+{
+    return (at < MEMORY_SIZE) ? vm->memory[at] : 0;
+}
+
+// 명령어 바이트 at부터 32비트 주소 (메모리 밖 바이트는 0)
+uint32_t wideOperand(const VM *vm, uint32_t at);
+
+// MOV_RF/MOV_FR의 레지스터 번호 (pc는 메모리 안, 메모리 밖 바이트는 0, 다른 명령어처럼 NUM_REGS로 마스킹)
+static inline uint8_t wideRegister(const VM *vm, uint16_t pc)
+{
+    return operandByte(vm, (uint32_t)pc + WIDE_REG_OFFSET(vm->memory[pc])) & (NUM_REGS - 1);
+}
+
+// lookaside 미스 경로 (paged.c)
+bool pagedLoadSlow(VM *vm, uint32_t addr, uint8_t *value);
+bool pagedStoreSlow(VM *vm, uint32_t addr, uint8_t value);
+
+/**
+ * addr 바이트 읽기/쓰기 (MOV_FR / MOV_RF)
+ * MEMORY_SIZE 미만은 vm->memory (쓰기면 MARK_DIRTY, 디코드 캐시 무효화는 호출한 엔진이)
+ * 주소 공간 밖이거나 페이지를 할당할 수 없으면 false (메시지는 wideAccessError)
+ */
+static inline bool wideLoad(VM *vm, uint32_t addr, uint8_t *value)
+{
+    if (addr < MEMORY_SIZE)
+    {
+        *value = vm->memory[addr];
+        return true;
+    }
+    PagedMemory *pm = vm->paged;
+    if (pm && (addr >> PAGE_SHIFT) == pm->tlbPage)
+    {
+        pm->accesses++;
+        *value = pm->tlbData[addr & PAGE_MASK];
+        return true;
+    }
+    return pagedLoadSlow(vm, addr, value);
+}
+
+static inline bool wideStore(VM *vm, uint32_t addr, uint8_t value)
+{
+    if (addr < MEMORY_SIZE)
+    {
+        vm->memory[addr] = value;
+        MARK_DIRTY(vm, addr);
+        return true;
+    }
+    PagedMemory *pm = vm->paged;
+    if (pm && (addr >> PAGE_SHIFT) == pm->tlbPage)
+    {
+        pm->accesses++;
+        pm->tlbData[addr & PAGE_MASK] = value;
+        return true;
+    }
+    return pagedStoreSlow(vm, addr, value);
+}
+
+// wideLoad/wideStore가 false일 때 오류 메시지
+void wideAccessError(const VM *vm, Opcode op, uint32_t addr, uint16_t pc);
+
+// 할당한 페이지를 모두 해제 (vm->paged = NULL)
+void freePagedMemory(VM *vm);
+
+// 페이지 수, lookaside 적중률 출력 (넓은 주소를 쓴 적 없으면 출력하지 않음)
+void printPagedStats(const VM *vm);
+
+#endif
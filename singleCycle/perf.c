@@ -0,0 +1,39 @@
+#include "perf.h"
+
+static const char *const opcodeNames[PERF_OPCODES] = {
+    "HALT", "NOP", "MOV_RR", "MOV_RM", "MOV_MR", "ADD_RR", "SUB_RR", "JMP", "MOV_RF", "MOV_FR", "INVALID",
+};
+
+void printPerfText(FILE *fp, const PerfCounters *pc)
+{
+    fprintf(fp, "----- Performance Counters -----\n");
+    fprintf(fp, "cycles          = %llu\n", (unsigned long long)pc->cycles);
+    fprintf(fp, "retired         = %llu\n", (unsigned long long)pc->retired);
+    fprintf(fp, "CPI             = %.3f\n", pc->retired ? (double)pc->cycles / pc->retired : 0.0);
+    fprintf(fp, "fetches         = %llu\n", (unsigned long long)pc->fetches);
+    fprintf(fp, "memory reads    = %llu\n", (unsigned long long)pc->memReads);
+    fprintf(fp, "memory writes   = %llu\n", (unsigned long long)pc->memWrites);
+    for (int op = 0; op < PERF_OPCODES; op++)
+    {
+        fprintf(fp, "  %-13s = %llu\n", opcodeNames[op], (unsigned long long)pc->opcodes[op]);
+    }
+}
+
+void writePerfJson(FILE *fp, const PerfCounters *pc)
+{
+    fprintf(fp, "{\"cycles\": %llu, \"retired\": %llu, \"cpi\": %.6f, \"fetches\": %llu, "
+                "\"memReads\": %llu, \"memWrites\": %llu, \"opcodes\": {",
+            (unsigned long long)pc->cycles, (unsigned long long)pc->retired,
+            pc->retired ? (double)pc->cycles / pc->retired : 0.0, (unsigned long long)pc->fetches,
+            (unsigned long long)pc->memReads, (unsigned long long)pc->memWrites);
+    for (int op = 0; op < PERF_OPCODES; op++)
+    {
+        fprintf(fp, "%s\"%s\": %llu", op ? ", " : "", opcodeNames[op], (unsigned long long)pc->opcodes[op]);
+    }
+    fprintf(fp, "}}\n");
+}
+
+const char *opcodeName(int op)
+{
+    return (op >= 0 && op < PERF_OPCODES) ? opcodeNames[op] : opcodeNames[PERF_OPCODES - 1];
+}
@@ -0,0 +1,40 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * 성능 카운터
+ * VM마다 하나씩 (VM 구조체 끝, 캐시 라인 정렬이라 다른 VM이나 VM의 다른 상태와 라인을 같이 쓰지 않음)
+ * make PERF=0 으로 빌드하면 PERF_COUNTERS가 정의되지 않아 카운터 필드와 갱신 코드가 모두 빠짐
+ */
+
+#define PERF_OPCODES 11 // HALT ~ INVALID
+
+typedef struct {
+    uint64_t cycles;    // 단일 사이클이라 retired와 같음
+    uint64_t retired;   // 실행한 명령어 수 (모든 엔진)
+    uint64_t fetches;   // 명령어 fetch/decode 횟수 (switch 엔진)
+    uint64_t memReads;  // MOV_MR, MOV_FR (switch 엔진)
+    uint64_t memWrites; // MOV_RM, MOV_RF (switch 엔진)
+    uint64_t opcodes[PERF_OPCODES]; // opcode별 실행 횟수 (switch 엔진)
+} __attribute__((aligned(64))) PerfCounters;
+
+#ifdef PERF_COUNTERS
+#define PERF_ADD(vm, field, n) ((vm)->perf.field += (n))
+#else
+#define PERF_ADD(vm, field, n) ((void)(vm)) // vm만 쓰는 함수가 PERF=0에서 경고 나지 않게
+#endif
+#define PERF_INC(vm, field) PERF_ADD(vm, field, 1)
+
+// 사람이 읽는 형식
+void printPerfText(FILE *fp, const PerfCounters *pc);
+
+// JSON 한 개체
+void writePerfJson(FILE *fp, const PerfCounters *pc);
+
+// opcode 이름 (범위 밖이면 "INVALID")
+const char *opcodeName(int op);
+
+#endif
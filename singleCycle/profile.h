@@ -0,0 +1,45 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "cpu.h"
+
+/**
+ * PC별 프로파일러 (-P, 기준(switch) 엔진)
+ *   exact    : 명령어마다 PC별 실행 횟수 (runVMFor()와 같은 루프에 카운터 하나)
+ *   every:N  : 평균 N 명령어마다 다음에 실행할 PC 하나를 기록
+ *              runVMFor()를 조각으로 나눠 부르므로 명령어마다 드는 비용은 없음
+ *              (조각 길이를 N/2 ~ 3N/2로 흔들어서 루프 길이와 맞물려 같은 PC만 잡히지 않게)
+ *   timer:US : CPU 시간 US 마이크로초마다 SIGPROF 핸들러가 VM의 PC를 기록 (실행 루프는 그대로)
+ * 결과는 PC별 핫스팟, 소스 줄에 횟수를 붙인 주석 목록, flamegraph용 collapsed stack
+ */
+
+#define PROFILE_TOP 10 // 핫스팟 목록에 보일 PC 수
+
+typedef enum {
+    PROFILE_EXACT,
+    PROFILE_SAMPLED, // every:N
+    PROFILE_TIMER    // timer:US
+} ProfileMode;
+
+typedef struct {
+    ProfileMode mode;
+    uint32_t period;            // SAMPLED: 평균 명령어 수, TIMER: 마이크로초
+    uint64_t hits[MEMORY_SIZE]; // EXACT: 실행 횟수, 나머지: 샘플 수
+    uint64_t total;             // hits 합
+    uint64_t steps;             // 실행한 명령어 수
+} Profile;
+
+// -P 옵션 해석: "exact", "every:N", "timer:US" (prof를 비우고 모드를 설정, 잘못되면 false)
+bool parseProfileSpec(Profile *prof, const char *spec);
+
+// 프로파일하면서 실행 (maxSteps = 0 이면 제한 없음), 실행한 명령어 수 반환
+// 성능 카운터의 retired/cycles도 runEngine()처럼 더함
+uint64_t runProfiled(VM *vm, uint64_t maxSteps, Profile *prof);
+
+// 핫스팟 목록, source(프로그램 파일)가 있으면 줄마다 횟수를 붙인 소스 목록 (NULL이면 생략)
+void printProfileReport(const Profile *prof, const VM *vm, const char *source);
+
+// collapsed stack ("프로그램;bb@PC;줄 횟수", flamegraph.pl 입력)을 path에 저장 ("-" = 표준 출력)
+bool writeCollapsedStacks(const Profile *prof, const VM *vm, const char *source, const char *path);
+
+#endif
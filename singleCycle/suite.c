@@ -0,0 +1,343 @@
+// suite.c
+// 커널 벤치마크 모음: 커널마다 엔진별로 워밍업 후 반복 실행해서
+// 호스트 MIPS 중앙값/p99와 시뮬레이션 사이클 수를 출력하고, 기준 결과(CSV)와 비교해서 성능 회귀를 잡음
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpu.h"
+#include "load.h"
+#include "engine.h"
+#include "paged.h"
+
+#define SUITE_MAX_REPS 1000
+#define SUITE_MAX_RESULTS 256
+#define SUITE_NAME_LEN 32
+
+// 커널을 지정하지 않으면 bench/ 아래 전부
+static const char *const defaultKernels[] = {
+    "bench/jmp.s", "bench/memcpy.s", "bench/arith.s", "bench/smc.s", "bench/loop.txt",
+};
+
+typedef struct {
+    uint64_t steps;   // 실행 한 번의 명령어 수 (-n)
+    int reps;         // 측정 반복 (-r)
+    int warmup;       // 측정 전에 버리는 실행 (-w)
+    double threshold; // 회귀로 볼 중앙값 MIPS 감소율 (-t, %)
+} SuiteOptions;
+
+typedef struct {
+    char kernel[SUITE_NAME_LEN];
+    char engine[SUITE_NAME_LEN];
+    uint64_t instructions; // 실행 한 번의 명령어 수
+    uint64_t cycles;       // 시뮬레이션 사이클 (singleCycle은 명령어 수와 같음)
+    double medianMips;
+    double p99Mips;        // 느린 쪽 꼬리 (실행 시간의 nearest-rank p99)
+} SuiteResult;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// 정렬된 n개 중 pct 백분위 (nearest-rank)
+static double percentile(const double *sorted, int n, int pct)
+{
+    int rank = (n * pct + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// "bench/memcpy.s" -> "memcpy"
+static void kernelName(const char *path, char *name)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    size_t len = strcspn(base, ".");
+    if (len >= SUITE_NAME_LEN)
+    {
+        len = SUITE_NAME_LEN - 1;
+    }
+    memcpy(name, base, len);
+    name[len] = '\0';
+}
+
+// 워밍업 후 reps번 실행해서 시간 분포를 구함, 마지막 실행의 최종 상태를 last에
+static void measure(const VM *image, EngineType engine, const SuiteOptions *opt, SuiteResult *res, VM *last)
+{
+    double times[SUITE_MAX_REPS];
+    for (int r = -opt->warmup; r < opt->reps; r++)
+    {
+        *last = *image;
+        double t0 = nowSeconds();
+        res->instructions = runEngine(last, engine, opt->steps);
+        double t = nowSeconds() - t0;
+        if (r >= 0)
+        {
+            times[r] = t;
+        }
+        if (r < opt->reps - 1)
+        {
+            freePagedMemory(last);
+        }
+    }
+    res->cycles = res->instructions;
+    qsort(times, opt->reps, sizeof(double), compareDouble);
+    res->medianMips = res->instructions / percentile(times, opt->reps, 50) / 1e6;
+    res->p99Mips = res->instructions / percentile(times, opt->reps, 99) / 1e6;
+}
+
+/*  -------------------------------------
+        기준 결과 (CSV)
+    -------------------------------------
+*/
+
+#define SUITE_CSV_HEADER "kernel,engine,instructions,cycles,median_mips,p99_mips"
+
+static bool writeResults(const char *path, const SuiteResult *results, int count)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        printf("Failed to open file: %s\n", path);
+        return false;
+    }
+    fprintf(fp, "%s\n", SUITE_CSV_HEADER);
+    for (int i = 0; i < count; i++)
+    {
+        const SuiteResult *r = &results[i];
+        fprintf(fp, "%s,%s,%llu,%llu,%.3f,%.3f\n", r->kernel, r->engine, (unsigned long long)r->instructions,
+                (unsigned long long)r->cycles, r->medianMips, r->p99Mips);
+    }
+    return fclose(fp) == 0;
+}
+
+static int readResults(const char *path, SuiteResult *results, int max)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        printf("Failed to open file: %s\n", path);
+        return -1;
+    }
+    char line[256];
+    int count = 0;
+    while (count < max && fgets(line, sizeof(line), fp))
+    {
+        SuiteResult *r = &results[count];
+        unsigned long long instructions, cycles;
+        if (sscanf(line, "%31[^,],%31[^,],%llu,%llu,%lf,%lf", r->kernel, r->engine, &instructions, &cycles,
+                   &r->medianMips, &r->p99Mips) == 6)
+        {
+            r->instructions = instructions;
+            r->cycles = cycles;
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+static const SuiteResult *findResult(const SuiteResult *results, int count, const SuiteResult *key)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(results[i].kernel, key->kernel) == 0 && strcmp(results[i].engine, key->engine) == 0)
+        {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+// 기준과 비교한 칸을 출력, 회귀면 true
+static bool compareBaseline(const SuiteResult *r, const SuiteResult *base, double threshold)
+{
+    if (!base)
+    {
+        printf("  (new)");
+        return false;
+    }
+    // 같은 명령어 수를 실행했는데 사이클이 다르면 시뮬레이션 결과가 바뀐 것
+    if (base->instructions == r->instructions && base->cycles != r->cycles)
+    {
+        printf("  cycles changed (%llu)", (unsigned long long)base->cycles);
+        return true;
+    }
+    double delta = (r->medianMips - base->medianMips) / base->medianMips * 100.0;
+    printf("  %+6.1f%%", delta);
+    if (delta < -threshold)
+    {
+        printf(" REGRESSION");
+        return true;
+    }
+    return false;
+}
+
+static void usage(const char *prog)
+{
+    printf("usage: %s [-n steps] [-r reps] [-w warmup] [-e engine] [-o results.csv] [-b baseline.csv] [-t pct] [kernel...]\n",
+           prog);
+    printf("  -n  실행 한 번의 명령어 수 (기본 5000000)\n");
+    printf("  -r  측정 반복 횟수 (기본 9, 최대 %d)\n", SUITE_MAX_REPS);
+    printf("  -w  측정 전 워밍업 실행 횟수 (기본 1)\n");
+    printf("  -e  이 엔진만 (기본 전부)\n");
+    printf("  -o  결과를 CSV로 저장 (-b 기준 파일로 다시 쓸 수 있음)\n");
+    printf("  -b  기준 CSV와 비교: 중앙값 MIPS가 -t%% 넘게 떨어지거나 사이클 수가 바뀌면 종료 코드 1\n");
+    printf("  -t  회귀 기준 (%%, 기본 10)\n");
+    printf("  커널을 주지 않으면 bench/의 jmp, memcpy, arith, smc, loop\n");
+}
+
+int main(int argc, char *argv[])
+{
+    SuiteOptions opt = {.steps = 5000000, .reps = 9, .warmup = 1, .threshold = 10.0};
+    const char *outPath = NULL;
+    const char *basePath = NULL;
+    int onlyEngine = -1;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:r:w:e:o:b:t:h")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            opt.steps = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            opt.reps = atoi(optarg);
+            break;
+        case 'w':
+            opt.warmup = atoi(optarg);
+            break;
+        case 'e':
+        {
+            EngineType e;
+            if (!parseEngine(optarg, &e))
+            {
+                printf("Unknown engine: %s\n", optarg);
+                return 1;
+            }
+            onlyEngine = e;
+            break;
+        }
+        case 'o':
+            outPath = optarg;
+            break;
+        case 'b':
+            basePath = optarg;
+            break;
+        case 't':
+            opt.threshold = atof(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 1;
+        }
+    }
+    // 커널은 무한 루프라 명령어 수 제한이 꼭 필요
+    if (opt.steps == 0 || opt.reps < 1 || opt.reps > SUITE_MAX_REPS || opt.warmup < 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    static SuiteResult base[SUITE_MAX_RESULTS];
+    int baseCount = 0;
+    if (basePath && (baseCount = readResults(basePath, base, SUITE_MAX_RESULTS)) < 0)
+    {
+        return 1;
+    }
+
+    const char *const *kernels = defaultKernels;
+    int kernelCount = (int)(sizeof(defaultKernels) / sizeof(defaultKernels[0]));
+    if (optind < argc)
+    {
+        kernels = (const char *const *)&argv[optind];
+        kernelCount = argc - optind;
+    }
+
+    printf("%llu instructions x %d reps (+%d warm-up)\n", (unsigned long long)opt.steps, opt.reps, opt.warmup);
+    printf("%-10s %-10s %12s %12s %14s %14s%s\n", "kernel", "engine", "median MIPS", "p99 MIPS", "instructions",
+           "cycles", basePath ? "  vs base" : "");
+
+    static SuiteResult results[SUITE_MAX_RESULTS];
+    int count = 0;
+    int failures = 0;
+    for (int k = 0; k < kernelCount; k++)
+    {
+        VM image;
+        initVM(&image);
+        if (!loadProgramQuiet(&image, kernels[k]))
+        {
+            printf("Failed to load kernel: %s\n", kernels[k]);
+            failures++;
+            continue;
+        }
+
+        VM reference;
+        bool haveReference = false;
+        for (int e = 0; e < ENGINE_COUNT && count < SUITE_MAX_RESULTS; e++)
+        {
+            if (onlyEngine >= 0 && e != onlyEngine)
+            {
+                continue;
+            }
+            SuiteResult *r = &results[count++];
+            kernelName(kernels[k], r->kernel);
+            snprintf(r->engine, sizeof(r->engine), "%s", engineName((EngineType)e));
+            VM vm;
+            measure(&image, (EngineType)e, &opt, r, &vm);
+
+            printf("%-10s %-10s %12.1f %12.1f %14llu %14llu", r->kernel, r->engine, r->medianMips, r->p99Mips,
+                   (unsigned long long)r->instructions, (unsigned long long)r->cycles);
+            // 최종 상태가 앞 엔진과 같은지 확인
+            if (haveReference && (memcmp(&vm.cpu, &reference.cpu, sizeof(CPUState)) != 0 ||
+                                  memcmp(vm.memory, reference.memory, MEMORY_SIZE) != 0))
+            {
+                printf("  (state mismatch!)");
+                failures++;
+            }
+            if (basePath && compareBaseline(r, findResult(base, baseCount, r), opt.threshold))
+            {
+                failures++;
+            }
+            printf("\n");
+            if (haveReference)
+            {
+                freePagedMemory(&vm);
+            }
+            else
+            {
+                reference = vm;
+                haveReference = true;
+            }
+        }
+        if (haveReference)
+        {
+            freePagedMemory(&reference);
+        }
+    }
+
+    if (outPath)
+    {
+        if (!writeResults(outPath, results, count))
+        {
+            return 1;
+        }
+        printf("Results written to %s\n", outPath);
+    }
+    if (failures)
+    {
+        printf("%d problem(s) found\n", failures);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include "threaded.h"
+#include "dcache.h"
+#include "paged.h"
+
+/**
+ * direct-threaded 디스패치 엔진
+ * 디코드 캐시 슬롯마다 핸들러 주소를 같이 들고 있고,
+ * 각 핸들러 끝에서 다음 핸들러로 바로 점프한다 (핸들러별 간접 분기).
+ * 스텝 제한은 JMP(와 시작)에서만 검사한다: JMP 없이는 PC가 앞으로만 가므로
+ * 한 번 검사한 뒤 다음 JMP까지 많아야 MEMORY_SIZE + 1 스텝이고,
+ * 남은 스텝이 그보다 적으면 같은 디코드 캐시로 runDecodedLoop()가 정확히 끝낸다.
+ * GCC labels-as-values가 없으면 switch 루프로 대체.
+ */
+
+#if defined(__GNUC__) && !defined(THREADED_NO_COMPUTED_GOTO)
+#define THREADED_COMPUTED_GOTO 1
+#else
+#define THREADED_COMPUTED_GOTO 0
+#endif
+
+const char *threadedDispatchMode(void)
+{
+    return THREADED_COMPUTED_GOTO ? "computed-goto" : "switch";
+}
+
+#if THREADED_COMPUTED_GOTO
+
+uint64_t runVMThreaded(VM *vm, uint64_t maxSteps)
+{
+    // Opcode(0~10) -> 핸들러 주소
+    static const void *const opLabels[INVALID + 1] = {
+        [HALT] = &&op_halt,
+        [NOP] = &&op_nop,
+        [MOV_RR] = &&op_mov_rr,
+        [MOV_RM] = &&op_mov_rm,
+        [MOV_MR] = &&op_mov_mr,
+        [ADD_RR] = &&op_add_rr,
+        [SUB_RR] = &&op_sub_rr,
+        [JMP] = &&op_jmp,
+        [MOV_RF] = &&op_mov_rf,
+        [MOV_FR] = &&op_mov_fr,
+        [INVALID] = &&op_invalid,
+    };
+
+    DecodeCache dc;
+    // 슬롯별 핸들러 주소 (dc.code와 같은 인덱스)
+    const void *target[DCACHE_SLOTS];
+
+    initDecodeCache(&dc);
+    for (int i = 0; i < DCACHE_SLOTS; i++)
+    {
+        target[i] = (i < MEMORY_SIZE) ? &&op_undecoded : &&op_pc_fault;
+    }
+
+    uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+    uint64_t steps = 0;
+    uint8_t *regs = vm->cpu.regs;
+    uint16_t pc = vm->cpu.PC;
+    const DecodedInstr *d;
+    uint32_t addr; // MOV_RM/MOV_RF가 쓴 주소
+
+    vm->running = true;
+    if (pc >= MEMORY_SIZE)
+    {
+        printf("Error: PC out of memory range!\n");
+        vm->running = false;
+        return 0;
+    }
+
+// 다음 명령어로 바로 점프 (핸들러마다 복제되는 간접 분기, 스텝 검사 없음)
+#define DISPATCH()              \
+    do                          \
+    {                           \
+        d = &dc.code[pc];       \
+        goto *target[pc];       \
+    } while (0)
+
+// 다음 JMP까지 가장 긴 직선 구간(MEMORY_SIZE 명령어 + JMP)을 못 채우면 스텝마다 검사하는 루프로
+#define CHECK_BUDGET()                      \
+    do                                      \
+    {                                       \
+        if (limit - steps <= MEMORY_SIZE)   \
+            goto tail;                      \
+    } while (0)
+
+// 현재 명령어 완료: 스텝 증가, 다음 PC로 이동
+#define NEXT()          \
+    do                  \
+    {                   \
+        steps++;        \
+        pc = d->nextPC; \
+        DISPATCH();     \
+    } while (0)
+
+    CHECK_BUDGET();
+    DISPATCH();
+
+op_undecoded:
+    d = decodeIntoCache(&dc, vm, pc);
+    target[pc] = opLabels[d->op];
+    goto *target[pc];
+
+op_pc_fault:
+    printf("Error: PC out of memory range!\n");
+    vm->running = false;
+    goto done;
+
+op_halt:
+    vm->running = false;
+    steps++;
+    pc = d->nextPC;
+    goto done;
+
+op_nop:
+    NEXT();
+
+op_mov_rr:
+    regs[d->regA] = regs[d->regB];
+    NEXT();
+
+op_mov_rm:
+    addr = d->imm;
+    vm->memory[addr] = regs[d->regA];
+    MARK_DIRTY(vm, addr);
+stored:
+    if (dc.codeMap[addr])
+    {
+        // 코드 바이트에 쓴 경우: 덮고 있던 슬롯의 핸들러도 되돌림
+        invalidateDecodeCache(&dc, addr);
+        for (int p = (int)addr - (MAX_INSTR_SPAN - 1); p <= (int)addr; p++)
+        {
+            if (p >= 0 && dc.code[p].op == DOP_UNDECODED)
+            {
+                target[p] = &&op_undecoded;
+            }
+        }
+    }
+    NEXT();
+
+op_mov_mr:
+    regs[d->regB] = vm->memory[d->imm];
+    NEXT();
+
+op_add_rr:
+    regs[d->regA] = (uint8_t)(regs[d->regA] + regs[d->regB]);
+    NEXT();
+
+op_sub_rr:
+    regs[d->regA] = (uint8_t)(regs[d->regA] - regs[d->regB]);
+    NEXT();
+
+op_jmp:
+    steps++;
+    pc = d->imm;
+    CHECK_BUDGET();
+    DISPATCH();
+
+// 넓은 주소 (주소는 명령어 바이트에서, MEMORY_SIZE 안쪽에 쓰면 MOV_RM과 같은 무효화)
+op_mov_rf:
+    addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_RF));
+    if (!wideStore(vm, addr, regs[d->regA]))
+    {
+        wideAccessError(vm, MOV_RF, addr, pc);
+        vm->running = false;
+        steps++;
+        pc = d->nextPC;
+        goto done;
+    }
+    if (addr < MEMORY_SIZE)
+    {
+        goto stored;
+    }
+    NEXT();
+
+op_mov_fr:
+    addr = wideOperand(vm, pc + WIDE_ADDR_OFFSET(MOV_FR));
+    if (!wideLoad(vm, addr, &regs[d->regB]))
+    {
+        wideAccessError(vm, MOV_FR, addr, pc);
+        vm->running = false;
+        steps++;
+        pc = d->nextPC;
+        goto done;
+    }
+    NEXT();
+
+op_invalid:
+    printf("Error: Invalid opcode (0x%X) at PC=%u\n", INVALID, pc);
+    vm->running = false;
+    steps++;
+    pc = d->nextPC;
+    goto done;
+
+#undef NEXT
+#undef CHECK_BUDGET
+#undef DISPATCH
+
+tail:
+    vm->cpu.PC = pc;
+    if (steps >= limit)
+    {
+        return steps;
+    }
+    return steps + runDecodedLoop(vm, &dc, limit - steps, NULL);
+
+done:
+    vm->cpu.PC = pc;
+    return steps;
+}
+
+#else
+
+// labels-as-values를 쓸 수 없는 컴파일러: 디코드 캐시 switch 루프로 대체
+uint64_t runVMThreaded(VM *vm, uint64_t maxSteps)
+{
+    return runVMDecoded(vm, maxSteps);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef THREADED_H
+#define THREADED_H
+
+#include "cpu.h"
+
+/**
+ * direct-threaded 디스패치 실행 루프
+ * maxSteps = 0 이면 제한 없음, 실행한 명령어 수를 반환
+ */
+uint64_t runVMThreaded(VM *vm, uint64_t maxSteps);
+
+// 빌드된 디스패치 방식 ("computed-goto" 또는 "switch")
+const char *threadedDispatchMode(void);
+
+#endif